@@ -84,8 +84,8 @@ extern void tc_do_stat(Op*, Flag);
 /******************************************************************************/
 /* Global Variables */
 
-Bp_Recovery_Info* bp_recovery_info = NULL;
-Bp_Data*          g_bp_data        = NULL;
+__thread Bp_Recovery_Info* bp_recovery_info = NULL;
+__thread Bp_Data*          g_bp_data        = NULL;
 Flag              USE_LATE_BP      = FALSE;
 extern List       op_buf;
 extern uns        operating_mode;
@@ -122,7 +122,7 @@ void init_bp_recovery_info(uns8              proc_id,
 
   bp_recovery_info = new_bp_recovery_info;
 
-  init_hash_table(&per_branch_stat, "Per Branch Hit/Miss and Recovery/Redirect Stall cycles",
+  init_hash_table(&per_branch_stat[proc_id], "Per Branch Hit/Miss and Recovery/Redirect Stall cycles",
                   15000000, sizeof(Per_Branch_Stat));
 }
 
@@ -138,12 +138,12 @@ void bp_sched_recovery(Bp_Recovery_Info* bp_recovery_info, Op* op,
   ASSERT(op->proc_id, bp_recovery_info->proc_id == op->proc_id);
   ASSERT(0, !op->off_path);
   if (op->oracle_info.recover_at_exec) {
-    INC_STAT_EVENT(0, SCHEDULED_EXEC_LAT, cycle_count - op->recovery_info.predict_cycle);
-    STAT_EVENT(0, SCHEDULED_EXEC_RECOVERIES);
+    INC_STAT_EVENT(op->proc_id, SCHEDULED_EXEC_LAT, cycle_count - op->recovery_info.predict_cycle);
+    STAT_EVENT(op->proc_id, SCHEDULED_EXEC_RECOVERIES);
   }
   else if (op->oracle_info.recover_at_decode) {
-    INC_STAT_EVENT(0, SCHEDULED_DECODE_LAT, cycle_count - op->recovery_info.predict_cycle);
-    STAT_EVENT(0, SCHEDULED_DECODE_RECOVERIES);
+    INC_STAT_EVENT(op->proc_id, SCHEDULED_DECODE_LAT, cycle_count - op->recovery_info.predict_cycle);
+    STAT_EVENT(op->proc_id, SCHEDULED_DECODE_RECOVERIES);
   }
 
   if(bp_recovery_info->recovery_cycle == MAX_CTR ||
@@ -192,7 +192,7 @@ void bp_sched_recovery(Bp_Recovery_Info* bp_recovery_info, Op* op,
 void inc_bstat_fetched(Op* op) {
   Flag new_entry;
   int64 key = convert_to_cmp_addr(op->table_info->cf_type, op->inst_info->addr);
-  Per_Branch_Stat* bstat = (Per_Branch_Stat*) hash_table_access_create(&per_branch_stat, key, &new_entry);
+  Per_Branch_Stat* bstat = (Per_Branch_Stat*) hash_table_access_create(&per_branch_stat[op->proc_id], key, &new_entry);
   if (new_entry) {
     memset(bstat, 0, sizeof(*bstat));
     bstat->addr = op->inst_info->addr;
@@ -206,7 +206,7 @@ void inc_bstat_fetched(Op* op) {
 
 void inc_bstat_miss(Op* op) {
   int64 key = convert_to_cmp_addr(op->table_info->cf_type, op->inst_info->addr);
-  Per_Branch_Stat* bstat = (Per_Branch_Stat*) hash_table_access(&per_branch_stat, key);
+  Per_Branch_Stat* bstat = (Per_Branch_Stat*) hash_table_access(&per_branch_stat[op->proc_id], key);
   ASSERT(bp_recovery_info->proc_id, bstat);
 
   const uns8 mispred = (op->table_info->cf_type == CF_CBR) && !op->oracle_info.btb_miss;
@@ -886,9 +886,9 @@ Addr bp_predict_op(Bp_Data* bp_data, Op* op, uns br_num, Addr fetch_addr) {
 
   if (!op->off_path) {
     if (op->oracle_info.recover_at_exec)
-      STAT_EVENT(0, BP_EXEC_RECOVERIES);
+      STAT_EVENT(op->proc_id, BP_EXEC_RECOVERIES);
     else if (op->oracle_info.recover_at_decode)
-      STAT_EVENT(0, BP_DECODE_RECOVERIES);
+      STAT_EVENT(op->proc_id, BP_DECODE_RECOVERIES);
   }
   return op->oracle_info.pred_npc;
 }
@@ -1091,8 +1091,8 @@ void bp_retire_op(Bp_Data* bp_data, Op* op) {
  */
 
 void bp_recover_op(Bp_Data* bp_data, Cf_Type cf_type, Recovery_Info* info) {
-  STAT_EVENT(0, PERFORMED_EXEC_RECOVERIES);
-  INC_STAT_EVENT(0, PERFORMED_RECOVERY_LAT, cycle_count - info->predict_cycle);
+  STAT_EVENT(bp_data->proc_id, PERFORMED_EXEC_RECOVERIES);
+  INC_STAT_EVENT(bp_data->proc_id, PERFORMED_RECOVERY_LAT, cycle_count - info->predict_cycle);
   /* always recover the global history */
   if(cf_type == CF_CBR) {
     bp_data->global_hist = (info->pred_global_hist >> 1) |
@@ -220,6 +220,9 @@ typedef struct Bp_struct {
   void (*recover_func)(Recovery_Info*); /* called to recover the bp when a
                                            misprediction is realized */
   uns8 (*full_func)(uns);
+  void (*write_state_func)(FILE*); /* called to save the trained tables into a
+                                      warm state image (may be NULL) */
+  void (*read_state_func)(FILE*);  /* called to restore them (may be NULL) */
 } Bp;
 
 typedef struct Bp_Btb_struct {
@@ -264,8 +267,8 @@ typedef struct Br_Conf_struct {
 extern Bp                bp_table[];
 extern Bp_Btb            bp_btb_table[];
 extern Bp_Ibtb           bp_ibtb_table[];
-extern Bp_Data*          g_bp_data;
-extern Bp_Recovery_Info* bp_recovery_info;
+extern __thread Bp_Data*          g_bp_data;
+extern __thread Bp_Recovery_Info* bp_recovery_info;
 extern Br_Conf           br_conf_table[];
 
 /**************************************************************************************/
@@ -107,3 +107,27 @@ void bp_gshare_update(Op* op) {
   DEBUG(proc_id, "Updating addr:%s  pht:%u  ent:%u  dir:%d\n", hexstr64s(addr),
         pht_index, gshare_state.pht[pht_index], op->oracle_info.dir);
 }
+
+// Warm state image: the PHT of every core, preceded by its size.
+void bp_gshare_write_state(FILE* file) {
+  for(const auto& gshare_state : gshare_state_all_cores) {
+    const uns64 size = gshare_state.pht.size();
+    if(fwrite(&size, sizeof(size), 1, file) != 1 ||
+       fwrite(gshare_state.pht.data(), 1, size, file) != size)
+      FATAL_ERROR(0, "Could not write the gshare warm state\n");
+  }
+}
+
+void bp_gshare_read_state(FILE* file) {
+  for(auto& gshare_state : gshare_state_all_cores) {
+    uns64 size;
+    if(fread(&size, sizeof(size), 1, file) != 1)
+      FATAL_ERROR(0, "Could not read the gshare warm state\n");
+    if(size != gshare_state.pht.size())
+      FATAL_ERROR(0, "Warm state gshare PHT has %llu entries, expected %llu\n",
+                  (unsigned long long)size,
+                  (unsigned long long)gshare_state.pht.size());
+    if(fread(gshare_state.pht.data(), 1, size, file) != size)
+      FATAL_ERROR(0, "Could not read the gshare warm state\n");
+  }
+}
@@ -131,3 +131,23 @@ void bp_tagescl_recover(Recovery_Info* recovery_info) {
 uns8 bp_tagescl_full(uns proc_id) {
     return tagescl_predictors.at(proc_id)->is_full();
 }
+
+// Warm state image: the predictor of every core.
+void bp_tagescl_write_state(FILE* file) {
+  for(const auto& predictor : tagescl_predictors) {
+    State_IO io(file, true);
+    predictor->state_io(io);
+    if(!io.ok())
+      FATAL_ERROR(0, "Could not write the TAGE-SC-L warm state\n");
+  }
+}
+
+void bp_tagescl_read_state(FILE* file) {
+  for(const auto& predictor : tagescl_predictors) {
+    State_IO io(file, false);
+    predictor->state_io(io);
+    if(!io.ok())
+      FATAL_ERROR(0, "Could not read the TAGE-SC-L warm state (truncated, or "
+                     "saved with a different NODE_TABLE_SIZE)\n");
+  }
+}
@@ -37,6 +37,8 @@ void bp_tagescl_update(Op* op);
 void bp_tagescl_retire(Op* op);
 void bp_tagescl_recover(Recovery_Info*);
 uns8 bp_tagescl_full(uns proc_id);
+void bp_tagescl_write_state(FILE*);
+void bp_tagescl_read_state(FILE*);
 
 #ifdef __cplusplus
 }
@@ -212,6 +212,8 @@ class Loop_Predictor {
     prediction_info->hit_bank = -1;
   }
 
+  void state_io(State_IO& io) { io.vector(&table_); }
+
  private:
   struct LoopPredictorEntry {
     int16_t total_iterations = 0;  // 10 bits
@@ -192,6 +192,38 @@ class Statistical_Corrector {
     }
   }
 
+  void state_io(State_IO& io) {
+    io.value(&global_history_);
+    io.value(&path_);
+    io.value(&first_local_history_table_);
+    io.value(&second_local_history_table_);
+    io.value(&third_local_history_table_);
+    io.value(&imli_counter_);
+    io.value(&imli_table_);
+    io.value(&first_high_confidence_ctr_);
+    io.value(&second_high_confidence_ctr_);
+    io.value(&update_threshold_);
+    io.value(&p_update_thresholds_);
+    io.value(&global_history_gehl_);
+    io.value(&path_gehl_);
+    io.value(&first_local_gehl_);
+    io.value(&second_local_gehl_);
+    io.value(&third_local_gehl_);
+    io.value(&first_imli_gehl_);
+    io.value(&second_imli_gehl_);
+    io.value(&global_history_threshold_table_);
+    io.value(&path_threshold_table_);
+    io.value(&first_local_threshold_table_);
+    io.value(&second_local_threshold_table_);
+    io.value(&third_local_threshold_table_);
+    io.value(&first_imli_threshold_table_);
+    io.value(&second_imli_threshold_table_);
+    io.value(&bias_threshold_table_);
+    io.vector(&bias_table_);
+    io.vector(&bias_sk_table_);
+    io.vector(&bias_bank_table_);
+  }
+
  private:
   using Counter_Type = Saturating_Counter<CONFIG::SC::PRECISION, true>;
   using Per_PC_Threshold_Table_Type =
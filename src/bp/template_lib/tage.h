@@ -79,6 +79,12 @@ class Long_History_Register {
 
   int64_t head_idx() const { return head_; }
 
+  void state_io(State_IO& io) {
+    io.value(&num_speculative_bits_);
+    io.vector(&history_bits_);
+    io.value(&head_);
+  }
+
  private:
   int num_speculative_bits_ = 0;  // keeps track of how many bits can be
                                   // discarded during a rewind without losing
@@ -279,6 +285,16 @@ class Tage_Histories {
 
   void intialize_folded_history(void);
 
+  void state_io(State_IO& io) {
+    history_register_.state_io(io);
+    io.vector(&folded_histories_for_indices_);
+    io.vector(&folded_histories_for_tags_0_);
+    io.vector(&folded_histories_for_tags_1_);
+    io.value(&path_history_);
+    io.value(&head_old_);
+    io.value(&path_history_old_);
+  }
+
   // Hash function for the path history used in creating table indices.
   int64_t compute_path_hash(int64_t path_history, int max_width, int bank,
                             int index_size) const;
@@ -608,6 +624,17 @@ class Tage {
     *prediction_info = {};
   }
 
+  // Reads or writes the tables and histories (tagged_table_ptrs_ and the
+  // random number generator are set up by the constructor).
+  void state_io(State_IO& io) {
+    tage_histories_.state_io(io);
+    io.value(&bimodal_table_);
+    io.value(&low_history_tagged_table_);
+    io.value(&high_history_tagged_table_);
+    io.value(&alt_selector_table_);
+    io.value(&tick_);
+  }
+
  private:
   struct Bimodal_Entry {
     int8_t hysteresis = 1;
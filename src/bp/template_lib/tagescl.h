@@ -51,6 +51,7 @@ class Tage_SC_L_Base {
                                              bool        resolve_dir,
                                              uint64_t    br_target)      = 0;
   virtual bool is_full()                                              = 0;
+  virtual void state_io(State_IO& io)                                 = 0;
 };
 
 /* Interface functions:
@@ -89,6 +90,21 @@ class Tage_SC_L : public Tage_SC_L_Base {
     return prediction_info_buffer_.is_full();
   }
 
+  // Reads or writes the whole predictor state, including the in-flight
+  // branch buffer, so that branch ids carry on where they left off.
+  void state_io(State_IO& io) override {
+    io.value(&random_number_gen_.seed_);
+    tage_.state_io(io);
+    if(CONFIG::USE_SC) {
+      statistical_corrector_.state_io(io);
+    }
+    if(CONFIG::USE_LOOP_PREDICTOR) {
+      loop_predictor_.state_io(io);
+    }
+    io.value(&loop_predictor_beneficial_);
+    prediction_info_buffer_.state_io(io);
+  }
+
   // It uses the speculative state of the predictor to generate a prediction.
   // Should be called before update_speculative_state.
   bool get_prediction(int64_t branch_id, uint64_t br_pc) override;
@@ -23,6 +23,9 @@
 #define __TAGE_SC_L_LIB_H_
 
 #include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
 
 inline int get_min_num_bits_to_represent(int x) {
   assert(x > 0);
@@ -140,6 +143,58 @@ class Random_Number_Generator {
   int64_t* ptghist_ptr_;
 };
 
+/* Reads or writes the trained state of a predictor (for warm state images).
+ * Values are copied as raw bytes, so they must not hold pointers. Vectors are
+ * preceded by their size, which must match on reads. Errors are sticky and
+ * reported by ok(). */
+class State_IO {
+ public:
+  State_IO(FILE* file, bool write) : file_(file), write_(write) {}
+
+  bool ok() const { return ok_; }
+
+  template <typename T>
+  void value(T* ptr) {
+    bytes(ptr, sizeof(T));
+  }
+
+  template <typename T>
+  void vector(std::vector<T>* vec) {
+    if(size(vec->size()))
+      bytes(vec->data(), vec->size() * sizeof(T));
+  }
+
+  void vector(std::vector<bool>* vec) {
+    if(!size(vec->size()))
+      return;
+    for(size_t i = 0; i < vec->size(); ++i) {
+      bool bit = (*vec)[i];
+      value(&bit);
+      (*vec)[i] = bit;
+    }
+  }
+
+ private:
+  void bytes(void* ptr, size_t num_bytes) {
+    if(!ok_)
+      return;
+    size_t done = write_ ? fwrite(ptr, 1, num_bytes, file_) :
+                           fread(ptr, 1, num_bytes, file_);
+    ok_ = done == num_bytes;
+  }
+
+  bool size(uint64_t expected) {
+    uint64_t size = expected;
+    value(&size);
+    ok_ = ok_ && size == expected;
+    return ok_;
+  }
+
+  FILE* file_;
+  bool  write_;
+  bool  ok_ = true;
+};
+
 struct Branch_Type {
   bool is_conditional;
   bool is_indirect;
@@ -191,6 +246,13 @@ class Circular_Buffer {
     return false;
   }
 
+  void state_io(State_IO& io) {
+    io.vector(&buffer_);
+    io.value(&back_);
+    io.value(&front_);
+    io.value(&size_);
+  }
+
  private:
   std::vector<T> buffer_;
   int64_t        buffer_size_;
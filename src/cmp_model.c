@@ -30,6 +30,7 @@
 /* Global variables */
 #include "cmp_model.h"
 #include "bp/bp.param.h"
+#include "cmp_threads.h"
 #include "core.param.h"
 #include "debug/debug.param.h"
 #include "debug/debug_macros.h"
@@ -39,6 +40,7 @@
 #include "dvfs/perf_pred.h"
 #include "general.param.h"
 #include "globals/assert.h"
+#include "idle_skip.h"
 #include "memory/cache_part.h"
 #include "memory/memory.param.h"
 #include "op_pool.h"
@@ -62,6 +64,12 @@
 Cmp_Model cmp_model;
 Flag perf_pred_started = FALSE;
 
+/* the cycles of each core queued by cmp_threaded_cycle, CORE_THREAD_QUANTUM
+   per core, MAX_CTR where the core had none */
+static Counter* queued_cycles;
+static uns      num_queued_cycles;
+static uns      queued_cycle_idx; /* the one that is run */
+
 /**************************************************************************************/
 /* Static prototypes */
 
@@ -69,7 +77,17 @@ static void cmp_recover(void);
 static void cmp_redirect(void);
 static void cmp_measure_chip_util(void);
 static void cmp_istreams(void);
+static void cmp_istream(uns proc_id);
 static void cmp_cores(void);
+static void cmp_core_cycle(uns proc_id);
+static void cmp_select_core(uns proc_id);
+static void cmp_core_back_stages(void);
+static void cmp_core_fetch_stages(void);
+static void cmp_threaded_cycle(void);
+static void cmp_run_queued_cycles(void);
+static Flag cmp_select_queued_cycle(uns proc_id);
+static void cmp_queued_back_stages(uns proc_id);
+static void cmp_queued_sched_ops(uns proc_id);
 static void warmup_uncore(uns proc_id, Addr addr, Flag write);
 
 /**************************************************************************************/
@@ -109,7 +127,7 @@ void cmp_init(uns mode) {
 
     init_decode_stage(proc_id, "DECODE");
 
-    init_uop_queue_stage();
+    init_uop_queue_stage(proc_id);
 
     init_map_stage(proc_id, "MAP");
 
@@ -146,6 +164,19 @@ void cmp_init(uns mode) {
 
   cache_part_init();
 
+  idle_skip_init();
+
+  ASSERTM(0, !CORE_THREADS || CORE_THREAD_QUANTUM >= 1,
+          "core_thread_quantum must be at least 1\n");
+  if(CORE_THREADS && CORE_THREAD_QUANTUM > 1) {
+    ASSERTM(0, !SKIP_IDLE_CYCLES,
+            "Skipping idle cycles looks at memory state the cores share, "
+            "which needs a core_thread_quantum of 1\n");
+    cmp_threads_init();
+    queued_cycles = (Counter*)malloc(sizeof(Counter) * NUM_CORES *
+                                     CORE_THREAD_QUANTUM);
+  }
+
   ASSERTM(0, !USE_LATE_BP || LATE_BP_LATENCY < (DECODE_CYCLES + MAP_CYCLES),
           "Late branch prediction latency should be less than the total "
           "latency of the frontend stages of the pipeline (decode + map)");
@@ -175,13 +206,17 @@ void cmp_reset() {
 /* cmp_cycle: */
 
 void cmp_cycle() {
-  cmp_istreams();
+  if(CORE_THREADS && CORE_THREAD_QUANTUM > 1) {
+    cmp_threaded_cycle();
+  } else {
+    cmp_istreams();
 
-  /* Frequency domain checking is inside this function, since it
-     handles both shared cache and memory */
-  update_memory();
+    /* Frequency domain checking is inside this function, since it
+       handles both shared cache and memory */
+    update_memory();
 
-  cmp_cores();
+    cmp_cores();
+  }
 
   if(DVFS_ON)
     dvfs_cycle();
@@ -195,24 +230,30 @@ void cmp_istreams(void) {
 
     if(freq_is_ready(FREQ_DOMAIN_CORES[proc_id])) {
       cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
-
-      set_bp_recovery_info(&cmp_model.bp_recovery_info[proc_id]);
-      if(cycle_count >= bp_recovery_info->recovery_cycle) {
-        set_bp_data(&cmp_model.bp_data[proc_id]);
-        cmp_set_all_stages(proc_id);
-        cmp_recover();
-      }
-      if(cycle_count >= bp_recovery_info->redirect_cycle) {
-        set_icache_stage(&cmp_model.icache_stage[proc_id]);
-        ASSERT(proc_id, proc_id == bp_recovery_info->redirect_op->proc_id);
-        ASSERT_PROC_ID_IN_ADDR(
-          proc_id, bp_recovery_info->redirect_op->oracle_info.pred_npc);
-        cmp_redirect();
-      }
+      cmp_istream(proc_id);
     }
   }
 }
 
+/**************************************************************************************/
+/* cmp_istream: the recovery or redirect of proc_id that is due this cycle */
+
+static void cmp_istream(uns proc_id) {
+  set_bp_recovery_info(&cmp_model.bp_recovery_info[proc_id]);
+  if(cycle_count >= bp_recovery_info->recovery_cycle) {
+    set_bp_data(&cmp_model.bp_data[proc_id]);
+    cmp_set_all_stages(proc_id);
+    cmp_recover();
+  }
+  if(cycle_count >= bp_recovery_info->redirect_cycle) {
+    set_icache_stage(&cmp_model.icache_stage[proc_id]);
+    ASSERT(proc_id, proc_id == bp_recovery_info->redirect_op->proc_id);
+    ASSERT_PROC_ID_IN_ADDR(
+      proc_id, bp_recovery_info->redirect_op->oracle_info.pred_npc);
+    cmp_redirect();
+  }
+}
+
 void cmp_cores(void) {
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     if(DUMB_CORE_ON && DUMB_CORE == proc_id)
@@ -220,37 +261,160 @@ void cmp_cores(void) {
 
     if(freq_is_ready(FREQ_DOMAIN_CORES[proc_id])) {
       cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
+      cmp_core_cycle(proc_id);
+    }
+  }
+}
+
+/**************************************************************************************/
+/* cmp_core_cycle: one cycle of the pipeline of proc_id. Everything the stages
+ * touch is reached through the per-core pointers selected here, except the
+ * memory system, which is shared by all cores. */
+
+static void cmp_core_cycle(uns proc_id) {
+  cmp_select_core(proc_id);
+
+  if(idle_skip_core_cycle(proc_id))
+    return;
+
+  update_dcache_stage(&exec->sd);
+  cmp_core_back_stages();
+  add_uop_queue_fill_time();
+  cmp_core_fetch_stages();
+  node_sched_ops();
+  cmp_measure_chip_util();
+}
+
+/**************************************************************************************/
+/* cmp_select_core: points the stages at the state of proc_id */
+
+static void cmp_select_core(uns proc_id) {
+  set_bp_data(&cmp_model.bp_data[proc_id]);
+  set_bp_recovery_info(&cmp_model.bp_recovery_info[proc_id]);
+  cmp_set_all_stages(proc_id);
+}
+
+/**************************************************************************************/
+/* cmp_core_back_stages: the stages between the dcache and the icache, which
+ * only touch the state of the current core */
+
+static void cmp_core_back_stages(void) {
+  update_exec_stage(&node->sd);
+  update_node_stage(map->last_sd);
+  Stage_Data* map_stage_uop_cache_src = cmp_map_stage_uop_cache_src();
+  // doesnt work: decode_stage_process_op must be called once per op. For uop cache, one cycle after fetch.
+  // I can add a flag: decode_cycle (cycle decoded).
+  update_map_stage(dec->last_sd, map_stage_uop_cache_src);
+  update_uop_queue_stage(&ic->uopc_sd);
+  update_decode_stage(&ic->sd);
+}
+
+/**************************************************************************************/
+/* cmp_core_fetch_stages: the frontend and the icache of the current core */
+
+static void cmp_core_fetch_stages(void) {
+  update_decoupled_fe();
+  update_fdip();
+  update_eip();
+  update_icache_stage();
+}
+
+/**************************************************************************************/
+/* cmp_threaded_cycle: cmp_cycle with the cycles of the cores run on their
+ * threads (see cmp_threads.cc). The memory system is updated every cycle,
+ * while the cycles of the cores, istreams included, are queued and run once
+ * per quantum. */
+
+static void cmp_threaded_cycle(void) {
+  update_memory();
+
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Counter* queued = &queued_cycles[proc_id * CORE_THREAD_QUANTUM +
+                                     num_queued_cycles];
+    *queued         = MAX_CTR;
+    if(DUMB_CORE_ON && DUMB_CORE == proc_id)
+      continue;
+
+    if(freq_is_ready(FREQ_DOMAIN_CORES[proc_id])) {
+      cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
+      *queued     = cycle_count;
+    }
+  }
+
+  if(++num_queued_cycles == CORE_THREAD_QUANTUM) {
+    Counter last_cycle_count = cycle_count;
+    cmp_run_queued_cycles();
+    cycle_count       = last_cycle_count;
+    num_queued_cycles = 0;
+  }
+}
+
+/**************************************************************************************/
+/* cmp_run_queued_cycles: runs the queued cycles of the cores in the order they
+ * were queued. The parts of a cycle that touch shared state (the istream, the
+ * dcache, fetch, chip utilization) are run on this thread, one core after the
+ * other, as in cmp_cores. Only the other parts run on the threads of the
+ * cores. */
+
+static void cmp_run_queued_cycles(void) {
+  for(queued_cycle_idx = 0; queued_cycle_idx < num_queued_cycles;
+      queued_cycle_idx++) {
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+      if(cmp_select_queued_cycle(proc_id)) {
+        cmp_istream(proc_id);
+        cmp_select_core(proc_id);
+        update_dcache_stage(&exec->sd);
+      }
+    }
 
-      set_bp_data(&cmp_model.bp_data[proc_id]);
-      set_bp_recovery_info(&cmp_model.bp_recovery_info[proc_id]);
-      cmp_set_all_stages(proc_id);
-
-      update_dcache_stage(&exec->sd);
-      update_exec_stage(&node->sd);
-      update_node_stage(map->last_sd);
-      // Map stage can get ops from either the uop queue following the uop cache
-      // or the decoder.
-      Stage_Data* map_stage_uop_cache_src = NULL;
-      if (UOP_CACHE_ENABLE) {
-        map_stage_uop_cache_src = get_uop_queue_stage_length() > 0 ? uop_queue_stage_get_latest_sd() : &ic->uopc_sd;
+    cmp_threads_run(cmp_queued_back_stages);
+
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+      if(cmp_select_queued_cycle(proc_id)) {
+        add_uop_queue_fill_time();
+        cmp_core_fetch_stages();
       }
-      // doesnt work: decode_stage_process_op must be called once per op. For uop cache, one cycle after fetch.
-      // I can add a flag: decode_cycle (cycle decoded).
-      update_map_stage(dec->last_sd, map_stage_uop_cache_src);
-      update_uop_queue_stage(&ic->uopc_sd);
-      update_decode_stage(&ic->sd);
-      update_decoupled_fe();
-      update_fdip();
-      update_eip();
-      update_icache_stage();
-
-      node_sched_ops();
-
-      cmp_measure_chip_util();
+    }
+
+    cmp_threads_run(cmp_queued_sched_ops);
+
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+      if(cmp_select_queued_cycle(proc_id))
+        cmp_measure_chip_util();
     }
   }
 }
 
+/**************************************************************************************/
+/* cmp_select_queued_cycle: selects proc_id and its cycle that is run, if it
+ * has one */
+
+static Flag cmp_select_queued_cycle(uns proc_id) {
+  Counter cycle =
+    queued_cycles[proc_id * CORE_THREAD_QUANTUM + queued_cycle_idx];
+  if(cycle == MAX_CTR)
+    return FALSE;
+  cycle_count = cycle;
+  cmp_select_core(proc_id);
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* cmp_queued_back_stages: */
+
+static void cmp_queued_back_stages(uns proc_id) {
+  if(cmp_select_queued_cycle(proc_id))
+    cmp_core_back_stages();
+}
+
+/**************************************************************************************/
+/* cmp_queued_sched_ops: */
+
+static void cmp_queued_sched_ops(uns proc_id) {
+  if(cmp_select_queued_cycle(proc_id))
+    node_sched_ops();
+}
+
 /**************************************************************************************/
 /* cmp_debug: */
 
@@ -281,6 +445,8 @@ void cmp_debug() {
 /* cmp_done: */
 
 void cmp_done() {
+  if(CORE_THREADS && CORE_THREAD_QUANTUM > 1)
+    cmp_threads_done();
   if(PREF_FRAMEWORK_ON)
     pref_done();
   if(DVFS_ON)
@@ -329,9 +495,7 @@ void cmp_wake(Op* src_op, Op* dep_op, uns8 rdy_bit) {
      !dep_op->in_rdy_list) {
     _DEBUG(dep_op->proc_id, DEBUG_NODE_STAGE,
            "Adding to ready list  op_num:%s\n", unsstr64(dep_op->op_num));
-    dep_op->next_rdy    = node->rdy_head;
-    node->rdy_head      = dep_op;
-    dep_op->in_rdy_list = TRUE;
+    node_rdy_insert(dep_op);
   }
 }
 
@@ -43,6 +43,7 @@
 #include "node_stage.h"
 #include "thread.h"
 #include "uop_cache.h"
+#include "uop_queue_stage.h"
 
 /**************************************************************************************/
 /* cmp model data  */
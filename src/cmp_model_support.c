@@ -33,11 +33,13 @@
 #include "general.param.h"
 #include "globals/assert.h"
 #include "globals/utils.h"
+#include "memory/memory.param.h"
 #include "statistics.h"
 #include "prefetcher/fdip_new.h"
 #include "prefetcher/eip.h"
 #include "prefetcher/D_JOLT.h"
 #include "prefetcher/FNL+MMA.h"
+#include "uop_queue_stage.h"
 
 /**************************************************************************************/
 /* cmp_init_cmp_model  */
@@ -66,6 +68,7 @@ void cmp_init_cmp_model() {
   alloc_mem_djolt(NUM_CORES);
   alloc_mem_fnlmma(NUM_CORES);
   alloc_mem_uop_cache(NUM_CORES);
+  alloc_mem_uop_queue_stage(NUM_CORES);
 }
 
 
@@ -88,6 +91,7 @@ void cmp_set_all_stages(uns8 proc_id) {
   set_fdip(proc_id, &cmp_model.icache_stage[proc_id]);
   set_decoupled_fe(proc_id);
   set_uop_cache(proc_id);
+  set_uop_queue_stage(proc_id);
   set_icache_stage(&cmp_model.icache_stage[proc_id]);
   set_decode_stage(&cmp_model.decode_stage[proc_id]);
   set_map_stage(&cmp_model.map_stage[proc_id]);
@@ -96,6 +100,18 @@ void cmp_set_all_stages(uns8 proc_id) {
   set_dcache_stage(&cmp_model.dcache_stage[proc_id]);
 }
 
+/**************************************************************************************/
+/* cmp_map_stage_uop_cache_src: the stage data the map stage of the current
+ * core takes uop cache ops from (NULL without a uop cache). Map stage can get
+ * ops from either the uop queue following the uop cache or the decoder. */
+
+Stage_Data* cmp_map_stage_uop_cache_src() {
+  if(!UOP_CACHE_ENABLE)
+    return NULL;
+  return get_uop_queue_stage_length() > 0 ? uop_queue_stage_get_latest_sd() :
+                                            &ic->uopc_sd;
+}
+
 /**************************************************************************************/
 /* cmp_init_bogus_sim:
  *  Bogus simulation is used during multicore runs with the trace FE. Once a
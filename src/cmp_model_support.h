@@ -31,6 +31,7 @@
 #define __CMP_MODEL_SUPPORT_H__
 
 #include "globals/global_types.h"
+#include "stage_data.h"
 
 /**************************************************************************************/
 /* Prototypes */
@@ -38,6 +39,7 @@
 void cmp_init_cmp_model(void);
 void cmp_init_thread_data(uns8);
 void cmp_set_all_stages(uns8);
+Stage_Data* cmp_map_stage_uop_cache_src(void);
 void cmp_init_bogus_sim(uns8);
 /**************************************************************************************/
 /* External variables */
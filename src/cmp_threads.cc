@@ -0,0 +1,170 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : cmp_threads.cc
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : Host threads that run the pipelines of the cores
+ *
+ * Core i runs on thread i % CORE_THREADS, and the simulation thread is thread
+ * 0. cmp_cycle queues the cycles of the cores while it ticks the memory
+ * system, and every CORE_THREAD_QUANTUM cycles runs them. It splits each
+ * queued cycle into the parts that only touch the state of the core, which it
+ * hands to the threads with cmp_threads_run(), and the parts that touch the
+ * memory system or anything else the cores share, which it runs itself, one
+ * core after the other in proc_id order. So the order in which the cores
+ * reach shared state does not depend on the threads, and the stats are the
+ * same for any number of them.
+ *
+ * The stages reach the state of the current core through per-thread pointers
+ * (td, map, node, ...). With a quantum of 1 cmp_cycle does not use the threads.
+ *
+ * The workers spin between runs, then yield, like the ramulator channel
+ * workers. They are started by the first run rather than at init, so that no
+ * thread exists yet when sweep forks the simulation.
+ ***************************************************************************************/
+
+#include "cmp_threads.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+extern "C" {
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "general.param.h"
+}
+
+/**************************************************************************************/
+/* Macros */
+
+#define CMP_THREADS_SPINS 4096 /* polls before yielding the cpu */
+
+/**************************************************************************************/
+/* Global Variables */
+
+namespace {
+
+uns               num_threads;
+unsigned          max_spins; /* polls before yielding the cpu */
+Cmp_Core_Func     core_func;
+bool              started = false;
+std::atomic<long> generation{0};
+std::atomic<uns>  remaining{0};
+std::atomic<bool> stop{false};
+bool              parallel = false; /* the cores are running */
+std::mutex        shared_mutex;
+
+/**************************************************************************************/
+/* Static Functions */
+
+void wait(unsigned spins) {
+  if(spins >= max_spins)
+    std::this_thread::yield();
+}
+
+void run_cores(uns thread_id) {
+  for(uns proc_id = thread_id; proc_id < NUM_CORES; proc_id += num_threads)
+    core_func(proc_id);
+}
+
+void work(uns thread_id) {
+  long seen = 0;
+  while(true) {
+    for(unsigned spins = 0;
+        generation.load(std::memory_order_acquire) == seen; spins++)
+      wait(spins);
+    seen++;
+    if(stop.load(std::memory_order_relaxed))
+      return;
+    run_cores(thread_id);
+    remaining.fetch_sub(1, std::memory_order_release);
+  }
+}
+
+}  // namespace
+
+/**************************************************************************************/
+/* cmp_threads_init: */
+
+void cmp_threads_init() {
+  num_threads = MIN2(CORE_THREADS, NUM_CORES);
+  /* a thread that spins on a cpu shared with the others only delays them */
+  max_spins = std::thread::hardware_concurrency() >= num_threads ?
+                CMP_THREADS_SPINS :
+                0;
+}
+
+/**************************************************************************************/
+/* cmp_threads_done: */
+
+void cmp_threads_done() {
+  stop.store(true, std::memory_order_relaxed);
+  generation.fetch_add(1, std::memory_order_release);
+}
+
+/**************************************************************************************/
+/* cmp_threads_run: */
+
+void cmp_threads_run(Cmp_Core_Func func) {
+  if(num_threads == 1) {
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+      func(proc_id);
+    return;
+  }
+
+  if(!started) {
+    /* detached, so that exiting from anywhere does not have to join them */
+    for(uns thread_id = 1; thread_id < num_threads; thread_id++)
+      std::thread(work, thread_id).detach();
+    started = true;
+  }
+
+  core_func = func;
+  parallel  = true;
+  remaining.store(num_threads - 1, std::memory_order_relaxed);
+  generation.fetch_add(1, std::memory_order_release);
+  run_cores(0);
+  for(unsigned spins = 0; remaining.load(std::memory_order_acquire); spins++)
+    wait(spins);
+  parallel = false;
+}
+
+/**************************************************************************************/
+/* cmp_threads_lock: */
+
+void cmp_threads_lock() {
+  if(parallel)
+    shared_mutex.lock();
+}
+
+/**************************************************************************************/
+/* cmp_threads_unlock: */
+
+void cmp_threads_unlock() {
+  if(parallel)
+    shared_mutex.unlock();
+}
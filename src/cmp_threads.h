@@ -0,0 +1,62 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : cmp_threads.h
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : Host threads that run the pipelines of the cores
+ ***************************************************************************************/
+
+#ifndef __CMP_THREADS_H__
+#define __CMP_THREADS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Types */
+
+/* runs a part of the cycle of a core */
+typedef void (*Cmp_Core_Func)(uns proc_id);
+
+/**************************************************************************************/
+/* Prototypes */
+
+void cmp_threads_init(void);
+void cmp_threads_done(void);
+/* runs func for every core, each on the thread of the core, and returns when
+   they are all done */
+void cmp_threads_run(Cmp_Core_Func func);
+/* guard code that the cores call in any order, but that is not safe to call
+   from two threads at once, while the cores run in parallel, and are no-ops
+   otherwise */
+void cmp_threads_lock(void);
+void cmp_threads_unlock(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* #ifndef __CMP_THREADS_H__ */
@@ -61,7 +61,7 @@
 /**************************************************************************************/
 /* Global Variables */
 
-Dcache_Stage* dc = NULL;
+__thread Dcache_Stage* dc = NULL;
 
 /**************************************************************************************/
 /* set_dcache_stage: */
@@ -585,6 +585,15 @@ void update_dcache_stage(Stage_Data* src_sd) {
 }
 
 
+/**************************************************************************************/
+/* dcache_stage_is_idle: update_dcache_stage() has no op to move or access the
+ * cache with (and bumps no stats without one) */
+
+Flag dcache_stage_is_idle(Stage_Data* src_sd) {
+  return !src_sd->op_count && !dc->sd.op_count;
+}
+
+
 /**************************************************************************************/
 /* dcache_fill_line: */
 
@@ -82,7 +82,7 @@ typedef struct Dcache_Data_struct {
 /**************************************************************************************/
 /* External variables */
 
-extern Dcache_Stage* dc;
+extern __thread Dcache_Stage* dc;
 
 /**************************************************************************************/
 /* Prototypes */
@@ -93,6 +93,7 @@ void reset_dcache_stage(void);
 void recover_dcache_stage(void);
 void debug_dcache_stage(void);
 void update_dcache_stage(Stage_Data*);
+Flag dcache_stage_is_idle(Stage_Data*);
 void cmp_update_dcache_stage(Stage_Data*, uns);
 void wp_process_dcache_hit(Dcache_Data* line, Op* op);
 void wp_process_dcache_fill(Dcache_Data* line, Mem_Req* req);
@@ -63,8 +63,7 @@
 /**************************************************************************************/
 /* Global Variables */
 
-Decode_Stage* dec = NULL;
-bool decode_off_path;
+__thread Decode_Stage* dec = NULL;
 
 /**************************************************************************************/
 /* Local prototypes */
@@ -125,7 +124,7 @@ void reset_decode_stage() {
 
 void recover_decode_stage() {
   uns ii, jj;
-  decode_off_path = false;
+  dec->off_path = FALSE;
   ASSERT(0, dec);
   for(ii = 0; ii < STAGE_MAX_DEPTH; ii++) {
     Stage_Data* cur = &dec->sds[ii];
@@ -171,7 +170,7 @@ void update_decode_stage(Stage_Data* src_sd) {
   Op**        temp;
   uns         ii;
 
-  if(!decode_off_path) {
+  if(!dec->off_path) {
     if(stall)
       STAT_EVENT(dec->proc_id, DECODE_STAGE_STALLED);
     else
@@ -205,7 +204,7 @@ void update_decode_stage(Stage_Data* src_sd) {
     for (int i = 0; i < src_sd->max_op_count; i++) {
       Op* src_op = src_sd->ops[i];
       if (src_op && src_op->off_path)
-        decode_off_path = true;
+        dec->off_path = TRUE;
       if (src_op && !src_op->fetched_from_uop_cache) {
         cur->ops[cur->op_count] = src_op;
         src_sd->ops[i] = NULL;
@@ -235,6 +234,38 @@ void update_decode_stage(Stage_Data* src_sd) {
 }
 
 
+/**************************************************************************************/
+/* decode_stage_is_idle: update_decode_stage() would move no op */
+
+Flag decode_stage_is_idle(Stage_Data* src_sd) {
+  for(uns ii = 0; ii < STAGE_MAX_DEPTH - 1; ii++) {
+    if(!dec->sds[ii].op_count && dec->sds[ii + 1].op_count)
+      return FALSE;
+  }
+  return dec->sds[STAGE_MAX_DEPTH - 1].op_count || !src_sd->op_count;
+}
+
+
+/**************************************************************************************/
+/* decode_idle_cycles: what update_decode_stage() does over the given number of
+ * cycles in which decode_stage_is_idle() holds */
+
+void decode_idle_cycles(Stage_Data* src_sd, Counter cycles) {
+  if(!dec->off_path) {
+    if(dec->last_sd->op_count > 0)
+      INC_STAT_EVENT(dec->proc_id, DECODE_STAGE_STALLED, cycles);
+    else
+      INC_STAT_EVENT(dec->proc_id, DECODE_STAGE_NOT_STALLED, cycles);
+    if(!src_sd->op_count)
+      INC_STAT_EVENT(dec->proc_id, DECODE_STAGE_STARVED, cycles);
+    else
+      INC_STAT_EVENT(dec->proc_id, DECODE_STAGE_NOT_STARVED, cycles);
+  }
+  else
+    INC_STAT_EVENT(dec->proc_id, DECODE_STAGE_OFF_PATH, cycles);
+}
+
+
 /**************************************************************************************/
 /* process_decode_op: This function may also be called by ops from the uop cache.     */
 
@@ -41,13 +41,14 @@ typedef struct Decode_Stage_struct {
                         * allocated number of pipe stages) */
   Stage_Data* last_sd; /* pointer to last decode pipeline stage
                         * (for passing ops to map) */
+  Flag off_path;       /* an off-path op was decoded since the last recovery */
 } Decode_Stage;
 
 
 /**************************************************************************************/
 /* External Variables */
 
-extern Decode_Stage* dec;
+extern __thread Decode_Stage* dec;
 
 
 /**************************************************************************************/
@@ -60,6 +61,8 @@ void reset_decode_stage(void);
 void recover_decode_stage(void);
 void debug_decode_stage(void);
 void update_decode_stage(Stage_Data*);
+Flag decode_stage_is_idle(Stage_Data*);
+void decode_idle_cycles(Stage_Data*, Counter cycles);
 // Needed when ops skip the decode stage when fetched from the uop cache.
 void decode_stage_process_op(Op*);
 
@@ -46,17 +46,20 @@ std::vector<std::vector<decoupled_fe_iter>> per_core_ftq_iterators;
 std::vector<uint64_t> per_core_recovery_addr;
 std::vector<uint64_t> per_core_redirect_cycle;
 std::vector<bool> per_core_stalled;
+std::vector<bool> per_core_fetch_halted;
 std::vector<uint64_t> per_core_ftq_ft_num;
 
 //per_core pointers
-std::deque<FT> *df_ftq;
-int *off_path;
-int *sched_off_path;
-int set_proc_id;
-std::vector<decoupled_fe_iter> *ftq_iterator;
+__thread std::deque<FT> *df_ftq;
+__thread int *off_path;
+__thread int *sched_off_path;
+__thread int set_proc_id;
+__thread std::vector<decoupled_fe_iter> *ftq_iterator;
 //need to overwrite op->op_num with decoupeld fe
 
 bool trace_mode;
+// cycles since any core last pushed an op into its FTQ
+static int fwd_progress = 0;
 
 void alloc_mem_decoupled_fe(uns numCores) {
   per_core_ftq.resize(numCores);
@@ -69,6 +72,7 @@ void alloc_mem_decoupled_fe(uns numCores) {
   per_core_recovery_addr.resize(numCores);
   per_core_redirect_cycle.resize(numCores);
   per_core_stalled.resize(numCores);
+  per_core_fetch_halted.resize(numCores);
   per_core_ftq_ft_num.resize(numCores);
 }
 
@@ -158,7 +162,6 @@ void update_decoupled_fe() {
   uns cf_num = 0;
   uint64_t bytes_this_cycle = 0;
   uint64_t cfs_taken_this_cycle = 0;
-  static int fwd_progress = 0;
   fwd_progress++;
   if (fwd_progress >= 100000) {
     std::cout << "No forward progress for 1000000 cycles" << std::endl;
@@ -206,6 +209,11 @@ void update_decoupled_fe() {
         STAT_EVENT(set_proc_id, FTQ_BREAK_PRED_BR_ONPATH);
       break;
     }
+    // Only stop between fetch targets so that everything already fetched can drain
+    if (per_core_fetch_halted[set_proc_id] && per_core_current_ft_to_push[set_proc_id].ops.empty()) {
+      DEBUG(set_proc_id, "Break due to halted fetch\n");
+      break;
+    }
     if (per_core_stalled[set_proc_id]) {
       DEBUG(set_proc_id, "Break due to wait for fetch barrier resolved\n");
       if (*off_path)
@@ -339,6 +347,24 @@ void update_decoupled_fe() {
   }
 }
 
+// update_decoupled_fe() would push no op because the FTQ is full
+bool decoupled_fe_is_idle() {
+  return decoupled_fe_ftq_num_fts() == per_core_ftq_ft_num[set_proc_id];
+}
+
+// What update_decoupled_fe() does over the given number of cycles in which
+// decoupled_fe_is_idle() holds
+void decoupled_fe_idle_cycles(Counter cycles) {
+  fwd_progress += cycles;
+  if (*off_path) {
+    INC_STAT_EVENT(set_proc_id, FTQ_CYCLES_OFFPATH, cycles);
+    INC_STAT_EVENT(set_proc_id, FTQ_BREAK_FULL_FT_OFFPATH, cycles);
+  } else {
+    INC_STAT_EVENT(set_proc_id, FTQ_CYCLES_ONPATH, cycles);
+    INC_STAT_EVENT(set_proc_id, FTQ_BREAK_FULL_FT_ONPATH, cycles);
+  }
+}
+
 bool decoupled_fe_current_ft_can_fetch_op(int proc_id) {
   return per_core_current_ft_in_use[proc_id].ft_can_fetch_op();
 }
@@ -499,6 +525,14 @@ uint64_t decoupled_fe_get_ftq_num(int proc_id) {
   return per_core_ftq_ft_num[proc_id];
 }
 
+void decoupled_fe_halt_fetch(int proc_id, Flag halt) {
+  per_core_fetch_halted[proc_id] = halt;
+  // the frontend may have been advanced while halted (sampling warms the
+  // caches functionally), so fetch does not resume at a recovery address
+  if (!halt)
+    per_core_recovery_addr[proc_id] = 0;
+}
+
 void FT::ft_add_op(Op *op, FT_Ended_By ft_ended_by) {
   if (ops.empty()) {
     ASSERT(set_proc_id, op->bom && !ft_info.static_info.start);
@@ -71,6 +71,8 @@ extern "C" {
   void reset_decoupled_fe();
   void debug_decoupled_fe();
   void update_decoupled_fe();
+  bool decoupled_fe_is_idle();
+  void decoupled_fe_idle_cycles(Counter cycles);
   // Icache/Core API
   void recover_decoupled_fe(int proc_id);
   void decoupled_fe_stall(Op *op);
@@ -100,6 +102,8 @@ extern "C" {
   uint64_t decoupled_fe_ftq_num_fts();
   void decoupled_fe_set_ftq_num(int proc_id, uint64_t ftq_ft_num);
   uint64_t decoupled_fe_get_ftq_num(int proc_id);
+  /* Stop (or resume) fetching new ops at the next fetch target boundary */
+  void decoupled_fe_halt_fetch(int proc_id, Flag halt);
 #ifdef __cplusplus
 }
 #endif
@@ -59,9 +59,8 @@
 /**************************************************************************************/
 /* Global Variables */
 
-Exec_Stage* exec = NULL;
+__thread Exec_Stage* exec = NULL;
 int         op_type_delays[NUM_OP_TYPES];
-int         exec_off_path;
 /**************************************************************************************/
 /* Prototypes */
 
@@ -136,7 +135,7 @@ void reset_exec_stage() {
 
 void recover_exec_stage() {
   uns ii;
-  exec_off_path = 0;
+  exec->off_path = FALSE;
   for(ii = 0; ii < NUM_FUS; ii++) {
     Func_Unit* fu = &exec->fus[ii];
     Op*        op = exec->sd.ops[ii];
@@ -189,7 +188,7 @@ void update_exec_stage(Stage_Data* src_sd) {
   uns ii;
   ASSERT(exec->proc_id, exec->sd.op_count <= exec->sd.max_op_count);
   // {{{ phase 1 - success/failure of latching and wake up of dependent ops
-  if (!exec_off_path) {
+  if (!exec->off_path) {
     if (!exec->sd.op_count)
       STAT_EVENT(exec->proc_id, EXEC_STAGE_STARVED);
     else
@@ -200,7 +199,7 @@ void update_exec_stage(Stage_Data* src_sd) {
 
   for(ii = 0; ii < src_sd->max_op_count; ii++) {
     if (src_sd->ops[ii] && src_sd->ops[ii]->off_path)
-      exec_off_path = 1;
+      exec->off_path = TRUE;
   }
 
   for(ii = 0; ii < src_sd->max_op_count; ii++) {
@@ -447,6 +446,37 @@ void update_exec_stage(Stage_Data* src_sd) {
   memview_fus_busy(exec->proc_id, exec->fus_busy);
 }
 
+/**************************************************************************************/
+/* exec_stage_is_idle: update_exec_stage() would latch no op, and no FU has an
+ * op in its pipeline */
+
+Flag exec_stage_is_idle(Stage_Data* src_sd) {
+  if(src_sd->op_count || exec->sd.op_count)
+    return FALSE;
+  for(uns ii = 0; ii < src_sd->max_op_count; ii++) {
+    if(exec->fus[ii].avail_cycle > cycle_count ||
+       exec->fus[ii].idle_cycle > cycle_count)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* exec_idle_cycles: what update_exec_stage() does over the given number of
+ * cycles in which exec_stage_is_idle() holds */
+
+void exec_idle_cycles(Stage_Data* src_sd, Counter cycles) {
+  if(!exec->off_path)
+    INC_STAT_EVENT(exec->proc_id, EXEC_STAGE_STARVED, cycles);
+  else
+    INC_STAT_EVENT(exec->proc_id, EXEC_STAGE_OFF_PATH, cycles);
+  INC_STAT_EVENT(exec->proc_id, FU_STARVED, src_sd->max_op_count * cycles);
+  INC_STAT_EVENT(exec->proc_id, FUS_EMPTY, src_sd->max_op_count * cycles);
+  for(uns ii = 0; ii < src_sd->max_op_count; ii++)
+    exec->fus[ii].held_by_mem = FALSE;
+  exec->fus_busy = 0;
+}
+
 void exec_stage_inc_power_stats(Op* op) {
   STAT_EVENT(op->proc_id, POWER_ROB_READ);
   STAT_EVENT(op->proc_id, POWER_ROB_WRITE);
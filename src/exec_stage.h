@@ -57,13 +57,14 @@ typedef struct Exec_Stage_struct {
   FILE* fu_util_plot_file;
   uns8  fus_busy; /* for FU util plot and performance prediction, does not
                      include mem stalls */
+  Flag off_path;  /* an off-path op was executed since the last recovery */
 } Exec_Stage;
 
 
 /**************************************************************************************/
 /* External Variables */
 
-extern Exec_Stage* exec;
+extern __thread Exec_Stage* exec;
 
 
 /**************************************************************************************/
@@ -76,6 +77,8 @@ void reset_exec_stage(void);
 void recover_exec_stage(void);
 void debug_exec_stage(void);
 void update_exec_stage(Stage_Data*);
+Flag exec_stage_is_idle(Stage_Data*);
+void exec_idle_cycles(Stage_Data*, Counter cycles);
 void finalize_exec_stage(void);
 
 /**************************************************************************************/
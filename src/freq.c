@@ -31,6 +31,7 @@
 #include "debug/debug_macros.h"
 #include "globals/assert.h"
 #include "globals/global_defs.h"
+#include "globals/utils.h"
 #include "memory/memory.param.h"
 #include "ramulator.param.h"
 #include "statistics.h"
@@ -180,6 +181,41 @@ void freq_advance_time(void) {
   }
 }
 
+void freq_skip_until(Counter time) {
+  /* The cycles of each domain that start before time, and the time the last
+     of them starts */
+  Counter skipped[MAX_FREQ_DOMAINS];
+  Counter last_time = cur_time;
+  for(uns i = 0; i < num_domains; i++) {
+    Counter next_time = freq_cycle_start_time(i, domains[i].cycles + 1);
+    skipped[i]        = next_time < time ?
+                          (time - 1 - next_time) / domains[i].cycle_time + 1 :
+                          0;
+    if(skipped[i] > 0)
+      last_time = MAX2(last_time,
+                       next_time + (skipped[i] - 1) * domains[i].cycle_time);
+  }
+  if(last_time == cur_time)
+    return;
+
+  for(uns i = 0; i < num_domains; i++) {
+    Counter next_time = freq_cycle_start_time(i, domains[i].cycles + 1 +
+                                                   skipped[i]);
+    domains[i].cycles += skipped[i];
+    /* the domains with a cycle starting at last_time are ready, as after
+       freq_advance_time() */
+    domains[i].time_until_next_cycle = next_time - last_time ==
+                                           domains[i].cycle_time ?
+                                         0 :
+                                         next_time - last_time;
+  }
+
+  INC_STAT_EVENT_ALL(EXECUTION_TIME, last_time - cur_time);
+  INC_STAT_EVENT_ALL(POWER_TIME, last_time - cur_time);
+  cur_time = last_time;
+  DEBUG(0, "Skipping time to %lld fs\n", cur_time);
+}
+
 void freq_reset_cycle_counts(void) {
   for(uns i = 0; i < num_domains; i++) {
     domains[i].cycles                = 0;
@@ -203,6 +239,16 @@ Counter freq_future_time(Freq_Domain_Id id, Counter cycles) {
   return freq_time() + (cycles - domains[id].cycles) * domains[id].cycle_time;
 }
 
+Counter freq_cycle_start_time(Freq_Domain_Id id, Counter cycles) {
+  ASSERT(0, id < num_domains);
+  ASSERT(0, domains[id].cycles < cycles);
+  /* a ready domain waits a full cycle for its next one */
+  Counter next_time = cur_time + (domains[id].time_until_next_cycle ?
+                                    domains[id].time_until_next_cycle :
+                                    domains[id].cycle_time);
+  return next_time + (cycles - domains[id].cycles - 1) * domains[id].cycle_time;
+}
+
 void freq_set_cycle_time(Freq_Domain_Id id, uns cycle_time) {
   ASSERT(0, id < num_domains);
   ASSERT(0, cycle_time > 0);
@@ -61,6 +61,11 @@ Flag freq_is_ready(Freq_Domain_Id id);
    ready to be simulated */
 void freq_advance_time(void);
 
+/* Advance time to the last cycle of any domain that starts before the
+   specified time, as if freq_advance_time() had been called for every cycle
+   in between and nothing had been simulated in them */
+void freq_skip_until(Counter time);
+
 /* Reset cycle time of each domain to zero but keep the time value. */
 void freq_reset_cycle_counts(void);
 
@@ -75,6 +80,10 @@ Counter freq_time(void);
    changing its frequency) */
 Counter freq_future_time(Freq_Domain_Id, Counter cycle_count);
 
+/* Returns the time (in femtoseconds) at which the specified domain
+   starts the specified cycle, which must not have started yet */
+Counter freq_cycle_start_time(Freq_Domain_Id id, Counter cycle_count);
+
 /* Sets the cycle time of the specified frequency domain (takes effect
    on the next cycle of that domain) */
 void freq_set_cycle_time(Freq_Domain_Id, uns cycle_time);
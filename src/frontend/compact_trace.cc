@@ -0,0 +1,401 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : frontend/compact_trace.cc
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : Writer and mmap reader of the compact trace format
+ ***************************************************************************************/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "frontend/compact_trace.h"
+
+#define COMPACT_TRACE_ZSTD_LEVEL 3
+
+/**************************************************************************************/
+/* Static functions */
+
+static void compact_trace_error(const char* name, const char* error) {
+  printf("Compact trace %s: %s\n", name, error);
+  exit(1);
+}
+
+static inline void put_varint(std::vector<uint8_t>& buf, uint64_t val) {
+  while(val >= 0x80) {
+    buf.push_back((uint8_t)val | 0x80);
+    val >>= 7;
+  }
+  buf.push_back((uint8_t)val);
+}
+
+static inline void put_delta(std::vector<uint8_t>& buf, uint64_t val,
+                             uint64_t ref) {
+  int64_t delta = (int64_t)(val - ref);
+  put_varint(buf, ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+}
+
+static inline uint64_t get_varint(const uint8_t** pos, const uint8_t* end) {
+  uint64_t val   = 0;
+  uns      shift = 0;
+  while(*pos < end) {
+    uint8_t byte = *(*pos)++;
+    val |= (uint64_t)(byte & 0x7f) << shift;
+    if(!(byte & 0x80))
+      return val;
+    shift += 7;
+  }
+  compact_trace_error("", "truncated record");
+  return 0;
+}
+
+static inline uint64_t get_delta(const uint8_t** pos, const uint8_t* end,
+                                 uint64_t ref) {
+  uint64_t zz = get_varint(pos, end);
+  return ref + ((zz >> 1) ^ -(zz & 1));
+}
+
+/* the address an instruction continues at if nothing unusual happens */
+static inline uint64_t expected_next_addr(const ctype_pin_inst* pi) {
+  return pi->actually_taken ? pi->branch_target :
+                              pi->instruction_addr + pi->size;
+}
+
+/* the previous instance of a static instruction in the chunk; fields left by
+   another chunk read as zero */
+static inline Compact_Trace_Last* chunk_last(Compact_Trace_Last* last,
+                                             uint64_t            chunk) {
+  if(last->chunk != chunk) {
+    memset(last, 0, sizeof(*last));
+    last->chunk = chunk;
+  }
+  return last;
+}
+
+/* the static part of an instruction, used as its key */
+static inline void static_image(const ctype_pin_inst* pi,
+                                ctype_pin_inst*       image) {
+  *image          = *pi;
+  image->inst_uid = 0;
+  memset(image->ld_vaddr, 0, sizeof(image->ld_vaddr));
+  memset(image->st_vaddr, 0, sizeof(image->st_vaddr));
+  image->branch_target         = 0;
+  image->actually_taken        = 0;
+  image->instruction_next_addr = 0;
+}
+
+/**************************************************************************************/
+/* Compact_Trace_Writer */
+
+Compact_Trace_Writer::Compact_Trace_Writer(const char* name) {
+  file = fopen(name, "wb");
+  if(!file)
+    compact_trace_error(name, "cannot open for writing");
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, COMPACT_TRACE_MAGIC, sizeof(header.magic));
+  header.version   = COMPACT_TRACE_VERSION;
+  header.inst_size = sizeof(ctype_pin_inst);
+  memset(&chunk, 0, sizeof(chunk));
+  /* the header is rewritten once the counts are known */
+  fwrite(&header, sizeof(header), 1, file);
+}
+
+Compact_Trace_Writer::~Compact_Trace_Writer() {
+  if(chunk.num_insts)
+    flush_chunk();
+  header.num_static    = statics.size();
+  header.static_offset = ftell(file);
+  if(fwrite(statics.data(), sizeof(ctype_pin_inst), statics.size(), file) !=
+     statics.size())
+    compact_trace_error("", "write failed");
+  header.num_chunks   = chunks.size();
+  header.index_offset = ftell(file);
+  if(fwrite(chunks.data(), sizeof(Compact_Trace_Chunk), chunks.size(), file) !=
+       chunks.size() ||
+     fseek(file, 0, SEEK_SET) || fwrite(&header, sizeof(header), 1, file) != 1)
+    compact_trace_error("", "write failed");
+  fclose(file);
+}
+
+void Compact_Trace_Writer::flush_chunk() {
+  const uint8_t* data = buf.data();
+  chunk.offset        = ftell(file);
+  chunk.raw_size      = buf.size();
+  chunk.size          = buf.size();
+  chunk.codec         = COMPACT_TRACE_RAW;
+#ifdef HAVE_ZSTD
+  zbuf.resize(ZSTD_compressBound(buf.size()));
+  size_t size = ZSTD_compress(zbuf.data(), zbuf.size(), buf.data(), buf.size(),
+                              COMPACT_TRACE_ZSTD_LEVEL);
+  if(!ZSTD_isError(size) && size < buf.size()) {
+    data        = zbuf.data();
+    chunk.size  = size;
+    chunk.codec = COMPACT_TRACE_ZSTD;
+  }
+#endif
+  if(fwrite(data, 1, chunk.size, file) != chunk.size)
+    compact_trace_error("", "write failed");
+  chunks.push_back(chunk);
+
+  chunk.first_inst += chunk.num_insts;
+  chunk.prev_uid  = prev_uid;
+  chunk.num_insts = 0;
+  buf.clear();
+}
+
+void Compact_Trace_Writer::write(const ctype_pin_inst* pi) {
+  ctype_pin_inst image;
+  uint8_t        flags  = 0;
+  uns            num_ld = MAX_LD_NUM;
+  uns            num_st = MAX_ST_NUM;
+  uint64_t       next   = pi->instruction_next_addr;
+  uint32_t       id;
+
+  static_image(pi, &image);
+  std::string key((const char*)&image, sizeof(image));
+  auto        found = static_ids.find(key);
+  if(found == static_ids.end()) {
+    id = statics.size();
+    static_ids.emplace(key, id);
+    statics.push_back(image);
+    last.emplace_back();
+    memset(&last.back(), 0, sizeof(Compact_Trace_Last));
+  } else {
+    id = found->second;
+  }
+  Compact_Trace_Last* prev = chunk_last(&last[id], chunks.size() + 1);
+
+  /* addresses past num_ld/num_st are normally zero and not stored */
+  while(num_ld && !pi->ld_vaddr[num_ld - 1])
+    num_ld--;
+  while(num_st && !pi->st_vaddr[num_st - 1])
+    num_st--;
+  if(num_ld < pi->num_ld)
+    num_ld = MIN2(pi->num_ld, MAX_LD_NUM);
+  if(num_st < pi->num_st)
+    num_st = MIN2(pi->num_st, MAX_ST_NUM);
+
+  if(pi->actually_taken)
+    flags |= COMPACT_TRACE_TAKEN;
+  if(pi->inst_uid != prev_uid + 1)
+    flags |= COMPACT_TRACE_UID;
+  if(pi->branch_target != prev->branch_target)
+    flags |= COMPACT_TRACE_TARGET;
+  if(next != expected_next_addr(pi))
+    flags |= COMPACT_TRACE_NEXT_ADDR;
+  if(num_ld != pi->num_ld || num_st != pi->num_st)
+    flags |= COMPACT_TRACE_MEM_NUM;
+
+  put_varint(buf, id);
+  buf.push_back(flags);
+  if(flags & COMPACT_TRACE_MEM_NUM)
+    buf.push_back(num_ld | num_st << 4);
+  if(flags & COMPACT_TRACE_UID)
+    put_delta(buf, pi->inst_uid, prev_uid + 1);
+  if(flags & COMPACT_TRACE_TARGET)
+    put_delta(buf, pi->branch_target, prev->branch_target);
+  if(flags & COMPACT_TRACE_NEXT_ADDR)
+    put_delta(buf, next, prev->next_addr);
+  for(uns ii = 0; ii < num_ld; ii++)
+    put_delta(buf, pi->ld_vaddr[ii], prev->ld_vaddr[ii]);
+  for(uns ii = 0; ii < num_st; ii++)
+    put_delta(buf, pi->st_vaddr[ii], prev->st_vaddr[ii]);
+
+  memcpy(prev->ld_vaddr, pi->ld_vaddr, sizeof(prev->ld_vaddr));
+  memcpy(prev->st_vaddr, pi->st_vaddr, sizeof(prev->st_vaddr));
+  prev->branch_target = pi->branch_target;
+  prev->next_addr     = next;
+  prev_uid            = pi->inst_uid;
+
+  header.num_dynamic++;
+  if(++chunk.num_insts == COMPACT_TRACE_CHUNK_INSTS)
+    flush_chunk();
+}
+
+/**************************************************************************************/
+/* Compact_Trace_Reader */
+
+bool Compact_Trace_Reader::is_compact_trace(const char* name) {
+  char  magic[8] = {0};
+  FILE* file     = fopen(name, "rb");
+  if(!file)
+    return false;
+  size_t size = fread(magic, 1, sizeof(magic), file);
+  fclose(file);
+  return size == sizeof(magic) &&
+         !memcmp(magic, COMPACT_TRACE_MAGIC, sizeof(magic));
+}
+
+Compact_Trace_Reader::Compact_Trace_Reader(const char* name) {
+  struct stat          st;
+  Compact_Trace_Header header;
+
+  int fd = open(name, O_RDONLY);
+  if(fd < 0 || fstat(fd, &st))
+    compact_trace_error(name, "cannot open");
+  map_size = st.st_size;
+  if(map_size < sizeof(header))
+    compact_trace_error(name, "truncated header");
+  base = (const uint8_t*)mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(base == MAP_FAILED)
+    compact_trace_error(name, "mmap failed");
+  madvise((void*)base, map_size, MADV_SEQUENTIAL);
+
+  memcpy(&header, base, sizeof(header));
+  if(memcmp(header.magic, COMPACT_TRACE_MAGIC, sizeof(header.magic)) ||
+     header.version != COMPACT_TRACE_VERSION)
+    compact_trace_error(name, "unknown format version");
+  if(header.inst_size != sizeof(ctype_pin_inst))
+    compact_trace_error(name, "written with a different ctype_pin_inst");
+  if(header.static_offset < sizeof(header) ||
+     header.static_offset + header.num_static * sizeof(ctype_pin_inst) >
+       map_size)
+    compact_trace_error(name, "truncated static table");
+  if(header.index_offset < sizeof(header) ||
+     header.index_offset + header.num_chunks * sizeof(Compact_Trace_Chunk) >
+       map_size)
+    compact_trace_error(name, "truncated chunk index");
+
+  pos        = NULL;
+  end        = NULL;
+  statics    = (const ctype_pin_inst*)(base + header.static_offset);
+  num_static = header.num_static;
+  chunks     = (const Compact_Trace_Chunk*)(base + header.index_offset);
+  num_chunks = header.num_chunks;
+  last.resize(num_static);
+  memset(last.data(), 0, num_static * sizeof(Compact_Trace_Last));
+}
+
+Compact_Trace_Reader::~Compact_Trace_Reader() {
+  munmap((void*)base, map_size);
+}
+
+void Compact_Trace_Reader::load_chunk(uint64_t chunk_num) {
+  const Compact_Trace_Chunk* chunk = &chunks[chunk_num];
+  if(chunk->offset + chunk->size > map_size)
+    compact_trace_error("", "truncated chunk");
+  const uint8_t* data = base + chunk->offset;
+  if(chunk->codec == COMPACT_TRACE_ZSTD) {
+#ifdef HAVE_ZSTD
+    zbuf.resize(chunk->raw_size);
+    size_t size = ZSTD_decompress(zbuf.data(), zbuf.size(), data, chunk->size);
+    if(ZSTD_isError(size) || size != chunk->raw_size)
+      compact_trace_error("", "corrupted chunk");
+    data = zbuf.data();
+#else
+    compact_trace_error("", "zstd chunk, but scarab is built without zstd");
+#endif
+  } else if(chunk->codec != COMPACT_TRACE_RAW || chunk->size != chunk->raw_size) {
+    compact_trace_error("", "unknown chunk codec");
+  }
+  pos        = data;
+  end        = data + chunk->raw_size;
+  remaining  = chunk->num_insts;
+  prev_uid   = chunk->prev_uid;
+  next_chunk = chunk_num + 1;
+}
+
+int Compact_Trace_Reader::seek(uint64_t inst) {
+  /* the chunk holding inst is the last one that starts at or before it */
+  const Compact_Trace_Chunk* chunk = std::upper_bound(
+    chunks, chunks + num_chunks, inst,
+    [](uint64_t val, const Compact_Trace_Chunk& entry) {
+      return val < entry.first_inst;
+    });
+  if(chunk == chunks || inst >= chunk[-1].first_inst + chunk[-1].num_insts) {
+    remaining  = 0;
+    next_chunk = num_chunks;
+    return 0;
+  }
+  chunk--;
+  /* the previous instances in last[] belong to wherever the reader was, which
+     may be in this same chunk */
+  memset(last.data(), 0, num_static * sizeof(Compact_Trace_Last));
+  load_chunk(chunk - chunks);
+  ctype_pin_inst pi;
+  for(uint64_t ii = chunk->first_inst; ii < inst; ii++)
+    read(&pi);
+  return 1;
+}
+
+uint64_t Compact_Trace_Reader::tell() const {
+  if(!next_chunk)
+    return 0;
+  const Compact_Trace_Chunk* chunk = &chunks[next_chunk - 1];
+  return chunk->first_inst + chunk->num_insts - remaining;
+}
+
+int Compact_Trace_Reader::read(ctype_pin_inst* pi) {
+  while(!remaining) {
+    if(next_chunk == num_chunks)
+      return 0;
+    load_chunk(next_chunk);
+  }
+  remaining--;
+
+  uint64_t id = get_varint(&pos, end);
+  if(id >= num_static || pos >= end)
+    compact_trace_error("", "corrupted record");
+  uint8_t             flags  = *pos++;
+  Compact_Trace_Last* prev   = chunk_last(&last[id], next_chunk);
+  uns                 num_ld = MIN2(statics[id].num_ld, MAX_LD_NUM);
+  uns                 num_st = MIN2(statics[id].num_st, MAX_ST_NUM);
+
+  memcpy(pi, &statics[id], sizeof(ctype_pin_inst));
+  if(flags & COMPACT_TRACE_MEM_NUM) {
+    num_ld = MIN2(*pos & 0xf, MAX_LD_NUM);
+    num_st = MIN2(*pos >> 4, MAX_ST_NUM);
+    pos++;
+  }
+  pi->actually_taken = !!(flags & COMPACT_TRACE_TAKEN);
+  pi->inst_uid       = flags & COMPACT_TRACE_UID ?
+                         get_delta(&pos, end, prev_uid + 1) :
+                         prev_uid + 1;
+  pi->branch_target  = flags & COMPACT_TRACE_TARGET ?
+                         get_delta(&pos, end, prev->branch_target) :
+                         prev->branch_target;
+  pi->instruction_next_addr = flags & COMPACT_TRACE_NEXT_ADDR ?
+                                get_delta(&pos, end, prev->next_addr) :
+                                expected_next_addr(pi);
+  for(uns ii = 0; ii < num_ld; ii++)
+    pi->ld_vaddr[ii] = get_delta(&pos, end, prev->ld_vaddr[ii]);
+  for(uns ii = 0; ii < num_st; ii++)
+    pi->st_vaddr[ii] = get_delta(&pos, end, prev->st_vaddr[ii]);
+
+  memcpy(prev->ld_vaddr, pi->ld_vaddr, sizeof(prev->ld_vaddr));
+  memcpy(prev->st_vaddr, pi->st_vaddr, sizeof(prev->st_vaddr));
+  prev->branch_target = pi->branch_target;
+  prev->next_addr     = pi->instruction_next_addr;
+  prev_uid            = pi->inst_uid;
+  return 1;
+}
@@ -0,0 +1,167 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : frontend/compact_trace.h
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : Compact trace format. Every distinct static instruction (a
+ *                ctype_pin_inst with its dynamic fields cleared) is stored
+ *                once in a table at the end of the file; the instruction
+ *                stream before it only holds, per instance, the static id and
+ *                varint-encoded deltas of what changed since the previous
+ *                instance of that static instruction (memory addresses, taken
+ *                bit, branch target and next address).
+ *
+ *                The dynamic records are grouped into chunks of
+ *                COMPACT_TRACE_CHUNK_INSTS instructions. Each chunk is
+ *                compressed on its own (with zstd when scarab is built with
+ *                it) and its records only refer to earlier records of the same
+ *                chunk, so a reader can start at any chunk. The chunk index
+ *                maps instruction counts to chunks, which lets the reader seek
+ *                to an instruction without decoding the ones before it.
+ *
+ *                File layout: Compact_Trace_Header, chunks, static table
+ *                (num_static packed ctype_pin_inst), chunk index (num_chunks
+ *                Compact_Trace_Chunk).
+ ***************************************************************************************/
+
+#ifndef __COMPACT_TRACE_H__
+#define __COMPACT_TRACE_H__
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ctype_pin_inst.h"
+
+/**************************************************************************************/
+/* Defines */
+
+#define COMPACT_TRACE_MAGIC "SCRBCTR"  // includes the terminating NUL
+#define COMPACT_TRACE_VERSION 2
+#define COMPACT_TRACE_CHUNK_INSTS 65536  // instructions per chunk
+
+/* how a chunk is stored */
+#define COMPACT_TRACE_RAW 0
+#define COMPACT_TRACE_ZSTD 1
+
+/* flags byte of a dynamic record */
+#define COMPACT_TRACE_TAKEN 0x01
+#define COMPACT_TRACE_UID 0x02       // inst_uid is not the previous one + 1
+#define COMPACT_TRACE_TARGET 0x04    // branch_target changed
+#define COMPACT_TRACE_NEXT_ADDR 0x08 // next address is not the fall through
+                                     // or taken target
+#define COMPACT_TRACE_MEM_NUM 0x10   // address counts differ from num_ld and
+                                     // num_st (a count byte follows)
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Compact_Trace_Header_struct {
+  char     magic[8];
+  uint32_t version;
+  uint32_t inst_size;  // sizeof(ctype_pin_inst) of the writer
+  uint64_t num_static;
+  uint64_t num_dynamic;
+  uint64_t static_offset;
+  uint64_t index_offset;
+  uint64_t num_chunks;
+} Compact_Trace_Header;
+
+/* entry of the chunk index */
+typedef struct Compact_Trace_Chunk_struct {
+  uint64_t first_inst;  // number of instructions before the chunk
+  uint64_t offset;      // of the stored chunk in the file
+  uint64_t prev_uid;    // inst_uid of the instruction before the chunk
+  uint32_t size;        // stored size
+  uint32_t raw_size;    // size of the records
+  uint32_t num_insts;
+  uint32_t codec;  // COMPACT_TRACE_RAW or COMPACT_TRACE_ZSTD
+} Compact_Trace_Chunk;
+
+/* what a dynamic record is relative to: the previous instance of the same
+   static instruction in the chunk */
+typedef struct Compact_Trace_Last_struct {
+  uint64_t ld_vaddr[MAX_LD_NUM];
+  uint64_t st_vaddr[MAX_ST_NUM];
+  uint64_t branch_target;
+  uint64_t next_addr;
+  uint64_t chunk;  // chunk number + 1 the fields belong to, 0 if none
+} Compact_Trace_Last;
+
+class Compact_Trace_Writer {
+ public:
+  explicit Compact_Trace_Writer(const char* name);
+  ~Compact_Trace_Writer();  // writes the static table, the index and the
+                            // header
+  void     write(const ctype_pin_inst* pi);
+  uint64_t num_dynamic() const { return header.num_dynamic; }
+
+ private:
+  void flush_chunk();
+
+  FILE*                                     file;
+  Compact_Trace_Header                      header;
+  std::unordered_map<std::string, uint32_t> static_ids;
+  std::vector<ctype_pin_inst>               statics;
+  std::vector<Compact_Trace_Last>           last;
+  uint64_t                                  prev_uid = 0;
+  std::vector<uint8_t>                      buf;  // records of the open chunk
+  std::vector<uint8_t>                      zbuf;
+  std::vector<Compact_Trace_Chunk>          chunks;
+  Compact_Trace_Chunk                       chunk;  // the open chunk
+};
+
+/* reads a compact trace through mmap */
+class Compact_Trace_Reader {
+ public:
+  explicit Compact_Trace_Reader(const char* name);
+  ~Compact_Trace_Reader();
+  int      read(ctype_pin_inst* pi);  // 0 at the end of the trace
+  uint64_t tell() const;              // the next instruction read
+  /* makes instruction inst (counted from 0) the next one read through the
+     chunk index; 0 if the trace is shorter */
+  int seek(uint64_t inst);
+
+  static bool is_compact_trace(const char* name);
+
+ private:
+  void load_chunk(uint64_t chunk);
+
+  const uint8_t*                  base;
+  size_t                          map_size;
+  const uint8_t*                  pos;
+  const uint8_t*                  end;
+  const ctype_pin_inst*           statics;
+  uint64_t                        num_static;
+  const Compact_Trace_Chunk*      chunks;
+  uint64_t                        num_chunks;
+  uint64_t                        next_chunk = 0;
+  uint64_t                        remaining  = 0;  // in the loaded chunk
+  uint64_t                        prev_uid   = 0;
+  std::vector<Compact_Trace_Last> last;
+  std::vector<uint8_t>            zbuf;  // decompressed chunk
+};
+
+#endif /* #ifndef __COMPACT_TRACE_H__ */
@@ -139,6 +139,11 @@ void frontend_retire(uns proc_id, uns64 inst_uid) {
   DEBUG(proc_id, "Retiring inst_uid %lld end\n", inst_uid);
 }
 
+Flag frontend_skip(uns proc_id, uns64 num) {
+  DEBUG(proc_id, "Skipping %lld instructions\n", num);
+  return frontend->skip(proc_id, num);
+}
+
 static void collect_op_stats(Op* op) {
   if(!ic || !ic->off_path) {
     STAT_EVENT(op->proc_id, ST_OP_ONPATH);
@@ -64,6 +64,10 @@ typedef struct Frontend_Intf_struct {
 
   /* Let the frontend know that this instruction is retired) */
   void (*retire)(uns proc_id, uns64 inst_uid);
+
+  /* Skip the next num instructions without generating their ops. Returns
+     FALSE if the frontend cannot skip, and the ops have to be fetched. */
+  Flag (*skip)(uns proc_id, uns64 num);
 } Frontend_Impl;
 
 typedef enum Frontend_Id_enum {
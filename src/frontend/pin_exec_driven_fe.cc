@@ -41,20 +41,66 @@ extern "C" {
 #include "frontend/pin_exec_driven_fe.h"
 #include "pin/pin_lib/message_queue_interface_lib.h"
 #include "pin/pin_lib/pin_scarab_common_lib.h"
+#include "pin/pin_lib/shm_ring_interface_lib.h"
 #include "pin/pin_lib/uop_generator.h"
 
 #include <time.h>
 
-extern int *off_path;
+extern __thread int *off_path;
 
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_PIN_EXEC_DRIVEN, ##args)
 
+/* PIN_EXEC_DRIVEN_FE_SHM: the commands and op buffers of a core go through a
+   shared-memory ring, and the ops are read where PIN wrote them */
+typedef struct Shm_Core_struct {
+  ShmRing*    ring;
+  ShmOpBatch* batch;      // op buffer being fetched, NULL if there is none
+  uns         batch_pos;  // next op in the batch
+  Flag        retire_pending;
+  uns64       retire_uid;  // retires are sent as one, before the next command
+} Shm_Core;
+
 Server*                          server;
 std::vector<ScarabOpBuffer_type> cached_cop_buffers;
+std::vector<Shm_Core>            shm_cores;
 
 void get_next_op_buffer_from_pin(uns proc_id);
 void update_op_buffer_if_empty(uns proc_id);
 void invalidate_op_buffer(uns proc_id);
+void send_to_pin(uns proc_id, const Scarab_To_Pin_Msg& msg);
+void flush_retires(uns proc_id);
+
+
+/**********************************************************
+ * Commands to PIN
+ **********************************************************/
+void send_to_pin(uns proc_id, const Scarab_To_Pin_Msg& msg) {
+  if(!PIN_EXEC_DRIVEN_FE_SHM) {
+    server->send(proc_id, (Message<Scarab_To_Pin_Msg>)msg);  // blocking
+    return;
+  }
+  // A retire covers all older instructions, so only the latest one is sent,
+  // ahead of any other command
+  if(msg.type == FE_RETIRE && msg.inst_uid != (uns64)-1) {
+    shm_cores[proc_id].retire_pending = TRUE;
+    shm_cores[proc_id].retire_uid     = msg.inst_uid;
+    return;
+  }
+  flush_retires(proc_id);
+  shm_cores[proc_id].ring->send_cmd(msg);
+}
+
+void flush_retires(uns proc_id) {
+  Shm_Core* core = &shm_cores[proc_id];
+  if(!core->retire_pending)
+    return;
+  Scarab_To_Pin_Msg msg;
+  msg.type             = FE_RETIRE;
+  msg.inst_addr        = 0;
+  msg.inst_uid         = core->retire_uid;
+  core->retire_pending = FALSE;
+  core->ring->send_cmd(msg);
+}
 
 
 /**********************************************************
@@ -66,19 +112,63 @@ void get_next_op_buffer_from_pin(uns proc_id) {
   msg.inst_addr = 0;
   msg.inst_uid  = 0;
 
-  server->send(proc_id, (Message<Scarab_To_Pin_Msg>)msg);  // blocking
+  send_to_pin(proc_id, msg);
+  if(PIN_EXEC_DRIVEN_FE_SHM) {
+    Shm_Core* core  = &shm_cores[proc_id];
+    core->batch     = core->ring->receive_batch();  // blocking
+    core->batch_pos = 0;
+    if(!core->batch->num_ops) {
+      core->ring->release_batch();
+      core->batch = NULL;
+    }
+    return;
+  }
   cached_cop_buffers[proc_id] = server->receive<ScarabOpBuffer_type>(
     proc_id);  // blocking
 }
 
+static inline Flag op_buffer_empty(uns proc_id) {
+  if(PIN_EXEC_DRIVEN_FE_SHM)
+    return shm_cores[proc_id].batch == NULL;
+  return cached_cop_buffers[proc_id].empty();
+}
+
+static inline compressed_op* op_buffer_front(uns proc_id) {
+  if(PIN_EXEC_DRIVEN_FE_SHM) {
+    Shm_Core* core = &shm_cores[proc_id];
+    return &core->batch->ops[core->batch_pos];
+  }
+  return &cached_cop_buffers[proc_id].front();
+}
+
+static inline void op_buffer_pop(uns proc_id) {
+  if(PIN_EXEC_DRIVEN_FE_SHM) {
+    Shm_Core* core = &shm_cores[proc_id];
+    if(++core->batch_pos == core->batch->num_ops) {
+      core->ring->release_batch();
+      core->batch = NULL;
+    }
+    return;
+  }
+  cached_cop_buffers[proc_id].pop_front();
+}
+
 void update_op_buffer_if_empty(uns proc_id) {
-  if(cached_cop_buffers[proc_id].size() == 0) {
+  if(op_buffer_empty(proc_id)) {
     DEBUG(proc_id, "Calling FETCH_OP to PIN\n");
     get_next_op_buffer_from_pin(proc_id);
   }
 }
 
 inline void invalidate_op_buffer(uns proc_id) {
+  if(PIN_EXEC_DRIVEN_FE_SHM) {
+    Shm_Core* core = &shm_cores[proc_id];
+    if(core->batch) {
+      core->ring->release_batch();
+      core->batch = NULL;
+    }
+    return;
+  }
   cached_cop_buffers[proc_id].clear();
 }
 
@@ -90,6 +180,17 @@ Addr get_fetch_address(uns proc_id, compressed_op* cop) {
  * PIN Exec Driven Interface Functions
  **********************************************************/
 void pin_exec_driven_init(uns numProcs) {
+  // The rings must exist before the clients connect, which is when they look
+  // for them. Rings left by an earlier run are removed.
+  shm_cores.resize(numProcs);
+  for(uns proc_id = 0; proc_id < numProcs; proc_id++) {
+    std::string path = shm_ring_path(PIN_EXEC_DRIVEN_FE_SOCKET, proc_id);
+    memset(&shm_cores[proc_id], 0, sizeof(Shm_Core));
+    if(PIN_EXEC_DRIVEN_FE_SHM)
+      shm_cores[proc_id].ring = ShmRing::create(path);
+    else
+      unlink(path.c_str());
+  }
   server = new Server(PIN_EXEC_DRIVEN_FE_SOCKET, numProcs);
   cached_cop_buffers.resize(numProcs);
   uop_generator_init(numProcs);
@@ -100,6 +201,8 @@ void pin_exec_driven_done(Flag* retired_exit) {
   for(uint32_t i = 0; i < server->getNumClients(); ++i) {
     if(!retired_exit[i]) {
       pin_exec_driven_retire(i, -1);
+    } else if(PIN_EXEC_DRIVEN_FE_SHM) {
+      flush_retires(i);
     }
   }
 
@@ -107,6 +210,7 @@ void pin_exec_driven_done(Flag* retired_exit) {
   // otherwise they may crash when reading the final retire.
   for(uint32_t i = 0; i < server->getNumClients(); ++i) {
     server->wait_for_client_to_close(i);
+    delete shm_cores[i].ring;
   }
   delete server;
 }
@@ -116,16 +220,16 @@ Flag pin_exec_driven_can_fetch_op(uns proc_id) {
   DEBUG(proc_id, "Can Fetch Op begin:\n");
   update_op_buffer_if_empty(proc_id);
 
-  return !cached_cop_buffers[proc_id].empty() &&
-         !is_sentinal_op(&cached_cop_buffers[proc_id].front());
+  return !op_buffer_empty(proc_id) &&
+         !is_sentinal_op(op_buffer_front(proc_id));
 }
 
 Addr pin_exec_driven_next_fetch_addr(uns proc_id) {
   DEBUG(proc_id, "Next Fetch Addr begin:\n");
   update_op_buffer_if_empty(proc_id);
 
-  Addr next_fetch_addr = get_fetch_address(
-    proc_id, &cached_cop_buffers[proc_id].front());
+  Addr next_fetch_addr = get_fetch_address(proc_id,
+                                           op_buffer_front(proc_id));
   ASSERT_PROC_ID_IN_ADDR(proc_id, next_fetch_addr);
   return next_fetch_addr;
 }
@@ -134,17 +238,17 @@ void pin_exec_driven_fetch_op(uns proc_id, Op* op) {
   DEBUG(proc_id, "Fetch Op begin:\n");
   update_op_buffer_if_empty(proc_id);
 
-  Flag eom = uop_generator_extract_op(proc_id, op,
-                                      &cached_cop_buffers[proc_id].front());
+  compressed_op* cop = op_buffer_front(proc_id);
+  Flag           eom = uop_generator_extract_op(proc_id, op, cop);
   if(eom) {
     if(!*off_path) {
-      if(cached_cop_buffers[proc_id].front().scarab_marker_roi_begin == true) {
+      if(cop->scarab_marker_roi_begin == true) {
         ASSERT(proc_id, !roi_dump_began);
         // reset stats
         printf("Reached roi dump begin marker, reset stats\n");
         reset_stats(TRUE);
         roi_dump_began = TRUE;
-      } else if(cached_cop_buffers[proc_id].front().scarab_marker_roi_end == true) {
+      } else if(cop->scarab_marker_roi_end == true) {
         ASSERT(proc_id, roi_dump_began);
         // dump stats
         printf("Reached roi dump end marker, dump stats between\n");
@@ -153,7 +257,7 @@ void pin_exec_driven_fetch_op(uns proc_id, Op* op) {
         roi_dump_ID ++;
       }
     }
-    cached_cop_buffers[proc_id].pop_front();
+    op_buffer_pop(proc_id);
   }
 
   DEBUG(proc_id, "Fetch Op end: %llx (%llu)\n", op->inst_info->addr, op->inst_uid);
@@ -169,7 +273,7 @@ void pin_exec_driven_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr) {
   msg.inst_uid  = inst_uid;
   uop_generator_recover(proc_id);
 
-  server->send(proc_id, (Message<Scarab_To_Pin_Msg>)msg);  // blocking
+  send_to_pin(proc_id, msg);
   invalidate_op_buffer(proc_id);
   DEBUG(proc_id, "Fetch Redirect end: %llx\n", fetch_addr);
 }
@@ -184,7 +288,7 @@ void pin_exec_driven_recover(uns proc_id, uns64 inst_uid) {
   msg.inst_uid  = inst_uid;
   uop_generator_recover(proc_id);
 
-  server->send(proc_id, (Message<Scarab_To_Pin_Msg>)msg);  // blocking
+  send_to_pin(proc_id, msg);
   invalidate_op_buffer(proc_id);
   DEBUG(proc_id, "Fetch Recover end: %llu\n", inst_uid);
 }
@@ -196,6 +300,10 @@ void pin_exec_driven_retire(uns proc_id, uns64 inst_uid) {
   msg.inst_addr = inst_uid == (uns64)-1;
   msg.inst_uid  = inst_uid;
 
-  server->send(proc_id, (Message<Scarab_To_Pin_Msg>)msg);  // blocking
+  send_to_pin(proc_id, msg);
   DEBUG(proc_id, "Fetch Retire end: %llu\n", inst_uid);
 }
+
+Flag pin_exec_driven_skip(uns proc_id, uns64 num) {
+  return FALSE;
+}
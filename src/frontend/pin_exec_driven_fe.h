@@ -62,6 +62,9 @@ void pin_exec_driven_recover(uns proc_id, uns64 inst_uid);
 /* Retire instruction at unique op id */
 void pin_exec_driven_retire(uns proc_id, uns64 inst_uid);
 
+/* Skipping is not supported, PIN has to execute the instructions */
+Flag pin_exec_driven_skip(uns proc_id, uns64 num);
+
 #ifdef __cplusplus
 }
 #endif
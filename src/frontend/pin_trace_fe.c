@@ -100,6 +100,13 @@ void trace_init() {
 
 void trace_setup(uns proc_id) {
   pin_trace_open(proc_id, trace_files[proc_id]);
+  if(FAST_FORWARD && FAST_FORWARD_TRACE_INS) {
+    /* compact traces seek to the instruction through their chunk index */
+    printf("Fast forwarding core %u by %llu instructions\n", proc_id,
+           FAST_FORWARD_TRACE_INS);
+    if(!pin_trace_skip(proc_id, FAST_FORWARD_TRACE_INS))
+      FATAL_ERROR(proc_id, "Trace ends before FAST_FORWARD_TRACE_INS\n");
+  }
   pin_trace_read(proc_id, &next_pi[proc_id]);
 }
 
@@ -163,3 +170,15 @@ void trace_retire(uns proc_id, uns64 inst_uid) {
   // Trace frontend does not need to communicate to PIN which instruction are
   // retired.
 }
+
+Flag trace_skip(uns proc_id, uns64 num) {
+  ASSERT(proc_id, uop_generator_get_eom(proc_id));
+  if(!num)
+    return TRUE;
+  /* next_pi is the first skipped instruction */
+  if(trace_read_done[proc_id] ||
+     (num > 1 && !pin_trace_skip(proc_id, num - 1)) ||
+     !pin_trace_read(proc_id, &next_pi[proc_id]))
+    FATAL_ERROR(proc_id, "Program ended before start of simulation\n");
+  return TRUE;
+}
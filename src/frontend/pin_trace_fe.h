@@ -50,6 +50,7 @@ void trace_fetch_op(uns proc_id, Op* op);
 void trace_redirect(uns proc_id, uns64 inst_uid, Addr fetch_addr);
 void trace_recover(uns proc_id, uns64 inst_uid);
 void trace_retire(uns proc_id, uns64 inst_uid);
+Flag trace_skip(uns proc_id, uns64 num);
 
 /* For restarting of traces */
 void trace_done(void);
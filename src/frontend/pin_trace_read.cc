@@ -23,14 +23,33 @@
  * File         : frontend/pin_trace_read.cc
  * Author       : HPS Research Group
  * Date         :
- * Description  :
+ * Description  : Reads pin traces. The trace is decompressed in-process (bzip2
+ *                or zstd, detected from the magic bytes; uncompressed traces
+ *                are read as they are) by a background thread per core that
+ *                fills two batches of instructions, so that the simulation
+ *                only copies records out of memory. Compact traces
+ *                (frontend/compact_trace.h) are decoded directly from an
+ *                mmap of the file.
  ****************************************************************************************/
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <inttypes.h>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
+#ifdef HAVE_BZLIB
+#include <bzlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "frontend/compact_trace.h"
 #include "frontend/pin_trace_read.h"
 #include "isa/isa.h"
 
@@ -40,35 +59,313 @@ extern "C" {
 }
 
 #define CMP_ADDR_MASK (((uint64_t)-1) << 58)
+#define PIN_TRACE_BATCH_INSTS 4096  // instructions per read-ahead batch
 
-FILE** pin_file;
+/**************************************************************************************/
+/* Trace_Stream: the decompressed bytes of a trace file */
 
-// static Reg_Id convert_pin_reg_to_scarab_reg(uns pin_reg);
-void pin_trace_file_pointer_init(unsigned char num_cores) {
-  pin_file = (FILE**)malloc(num_cores * sizeof(FILE*));
+class Trace_Stream {
+ public:
+  explicit Trace_Stream(const char* name);
+  ~Trace_Stream();
+  size_t read(void* buf, size_t size);  // short only at the end of the trace
+
+ private:
+  enum Format { RAW, BZIP2, ZSTD };
+
+  void open_tool(const char* tool, const char* name);
+  void trace_error(const char* tool, const char* error);
+
+  FILE*  file    = nullptr;
+  Flag   is_pipe = FALSE;
+  Format format  = RAW;
+#ifdef HAVE_BZLIB
+  BZFILE* bz = nullptr;
+#endif
+#ifdef HAVE_ZSTD
+  ZSTD_DStream*     zds = nullptr;
+  std::vector<char> zin_buf;
+  ZSTD_inBuffer     zin     = {nullptr, 0, 0};
+  Flag              zin_eof = FALSE;
+  size_t            zret    = 0;  // 0 once the last frame is complete
+#endif
+};
+
+Trace_Stream::Trace_Stream(const char* name) {
+  unsigned char magic[4] = {0};
+
+  file = fopen(name, "rb");
+  if(!file) {
+    printf("Cannot open trace file: %s\n", name);
+    exit(1);
+  }
+  size_t magic_size = fread(magic, 1, sizeof(magic), file);
+  rewind(file);
+
+  if(magic_size >= 3 && !memcmp(magic, "BZh", 3)) {
+#ifdef HAVE_BZLIB
+    int bzerror;
+    format = BZIP2;
+    bz     = BZ2_bzReadOpen(&bzerror, file, 0, 0, NULL, 0);
+    if(bzerror != BZ_OK) {
+      printf("Cannot decompress trace file: %s\n", name);
+      exit(1);
+    }
+#else
+    open_tool("bzip2", name);
+#endif
+  } else if(magic_size == 4 && magic[0] == 0x28 && magic[1] == 0xb5 &&
+            magic[2] == 0x2f && magic[3] == 0xfd) {
+#ifdef HAVE_ZSTD
+    format = ZSTD;
+    zds    = ZSTD_createDStream();
+    ZSTD_initDStream(zds);
+    zin_buf.resize(ZSTD_DStreamInSize());
+    zin = {zin_buf.data(), 0, 0};
+#else
+    open_tool("zstd", name);
+#endif
+  }
 }
 
-void pin_trace_open(unsigned char proc_id, const char* name) {
+/* without the library, decompress with the command line tool */
+void Trace_Stream::open_tool(const char* tool, const char* name) {
   char cmdline[1024];
-  sprintf(cmdline, "bzip2 -dc %s", name);
-  pin_file[proc_id] = popen(cmdline, "r");
-  printf("pin trace should be opened now for core %u: %s \n", proc_id, name);
-  if(!pin_file[proc_id]) {
+  fclose(file);
+  snprintf(cmdline, sizeof(cmdline), "%s -dc %s", tool, name);
+  file    = popen(cmdline, "r");
+  is_pipe = TRUE;
+  if(!file) {
     printf("Cannot open trace file: %s\n", name);
     exit(1);
   }
 }
 
+void Trace_Stream::trace_error(const char* tool, const char* error) {
+  printf("Corrupted %s trace: %s\n", tool, error);
+  exit(1);
+}
+
+Trace_Stream::~Trace_Stream() {
+#ifdef HAVE_BZLIB
+  if(bz) {
+    int bzerror;
+    BZ2_bzReadClose(&bzerror, bz);
+  }
+#endif
+#ifdef HAVE_ZSTD
+  if(zds)
+    ZSTD_freeDStream(zds);
+#endif
+  if(is_pipe)
+    pclose(file);
+  else
+    fclose(file);
+}
+
+size_t Trace_Stream::read(void* buf, size_t size) {
+  char*  out  = (char*)buf;
+  size_t done = 0;
+  UNUSED(out);
+
+  switch(format) {
+    case RAW:
+      return fread(buf, 1, size, file);
+
+    case BZIP2:
+#ifdef HAVE_BZLIB
+      while(done < size && bz) {
+        int bzerror;
+        int n = BZ2_bzRead(&bzerror, bz, out + done, size - done);
+        if(bzerror != BZ_OK && bzerror != BZ_STREAM_END)
+          trace_error("bzip2", BZ2_bzerror(bz, &bzerror));
+        done += n;
+        if(bzerror == BZ_STREAM_END) {
+          /* parallel bzip2 writes several streams back to back */
+          void* unused;
+          int   num_unused;
+          char  next[BZ_MAX_UNUSED];
+          BZ2_bzReadGetUnused(&bzerror, bz, &unused, &num_unused);
+          memcpy(next, unused, num_unused);
+          BZ2_bzReadClose(&bzerror, bz);
+          bz = nullptr;
+          if(!num_unused) {
+            /* libbz2 may have read up to the end without seeing EOF */
+            int c = fgetc(file);
+            if(c != EOF)
+              ungetc(c, file);
+            else
+              break;
+          }
+          bz = BZ2_bzReadOpen(&bzerror, file, 0, 0, next, num_unused);
+          if(bz && bzerror != BZ_OK)
+            trace_error("bzip2", BZ2_bzerror(bz, &bzerror));
+        }
+      }
+#endif
+      return done;
+
+    case ZSTD:
+#ifdef HAVE_ZSTD
+      while(done < size) {
+        if(zin.pos == zin.size && !zin_eof) {
+          zin.size = fread(zin_buf.data(), 1, zin_buf.size(), file);
+          zin.pos  = 0;
+          zin_eof  = !zin.size;
+        }
+        /* at the end of the file, keep flushing the decoder until it has no
+           more output */
+        ZSTD_outBuffer zout   = {out + done, size - done, 0};
+        size_t         in_pos = zin.pos;
+        size_t         ret    = ZSTD_decompressStream(zds, &zout, &zin);
+        if(ZSTD_isError(ret))
+          trace_error("zstd", ZSTD_getErrorName(ret));
+        /* between frames, an empty call asks for the next header */
+        if(zout.pos || zin.pos != in_pos)
+          zret = ret;
+        done += zout.pos;
+        if(zin_eof && !zout.pos) {
+          if(zret)
+            trace_error("zstd", "truncated frame");
+          break;
+        }
+      }
+#endif
+      return done;
+  }
+  return done;
+}
+
+/**************************************************************************************/
+/* Pin_Trace_Reader: double-buffered read-ahead. The reader thread decompresses
+ * the next batch while the simulation consumes the current one. */
+
+class Pin_Trace_Reader {
+ public:
+  explicit Pin_Trace_Reader(const char* name);
+  ~Pin_Trace_Reader();
+  int read(ctype_pin_inst* pi);
+
+ private:
+  void fill();
+
+  Trace_Stream                stream;
+  std::vector<ctype_pin_inst> batch[2];
+  uns                         count[2]  = {0, 0};
+  Flag                        full[2]   = {FALSE, FALSE};
+  uns                         cur       = 0;
+  uns                         cur_count = 0;  // count[cur], owned by read()
+  uns                         pos       = 0;
+  Flag                        started   = FALSE;
+  Flag                        stop      = FALSE;
+  std::mutex                  lock;
+  std::condition_variable     cv;
+  std::thread                 thread;
+};
+
+Pin_Trace_Reader::Pin_Trace_Reader(const char* name) : stream(name) {
+  batch[0].resize(PIN_TRACE_BATCH_INSTS);
+  batch[1].resize(PIN_TRACE_BATCH_INSTS);
+  thread = std::thread(&Pin_Trace_Reader::fill, this);
+}
+
+Pin_Trace_Reader::~Pin_Trace_Reader() {
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    stop = TRUE;
+  }
+  cv.notify_all();
+  thread.join();
+}
+
+/* runs in the reader thread; a short batch marks the end of the trace (a
+   partial record at the end is dropped) */
+void Pin_Trace_Reader::fill() {
+  for(uns b = 0;; b ^= 1) {
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      cv.wait(guard, [&] { return !full[b] || stop; });
+      if(stop)
+        return;
+    }
+    size_t bytes = stream.read(batch[b].data(),
+                               PIN_TRACE_BATCH_INSTS * sizeof(ctype_pin_inst));
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      count[b] = bytes / sizeof(ctype_pin_inst);
+      full[b]  = TRUE;
+    }
+    cv.notify_all();
+    if(count[b] < PIN_TRACE_BATCH_INSTS)
+      return;
+  }
+}
+
+int Pin_Trace_Reader::read(ctype_pin_inst* pi) {
+  if(pos == cur_count) {
+    if(started) {
+      if(cur_count < PIN_TRACE_BATCH_INSTS)
+        return 0;
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        full[cur] = FALSE;
+      }
+      cv.notify_all();
+      cur ^= 1;
+    }
+    started = TRUE;
+    pos     = 0;
+    std::unique_lock<std::mutex> guard(lock);
+    cv.wait(guard, [&] { return full[cur]; });
+    cur_count = count[cur];
+    if(!cur_count)
+      return 0;
+  }
+  *pi = batch[cur][pos++];
+  return 1;
+}
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Pin_Trace_Reader**     pin_reader;
+static Compact_Trace_Reader** compact_reader;
+
+// static Reg_Id convert_pin_reg_to_scarab_reg(uns pin_reg);
+void pin_trace_file_pointer_init(unsigned char num_cores) {
+  pin_reader = (Pin_Trace_Reader**)calloc(num_cores, sizeof(Pin_Trace_Reader*));
+  compact_reader = (Compact_Trace_Reader**)calloc(
+    num_cores, sizeof(Compact_Trace_Reader*));
+}
+
+void pin_trace_open(unsigned char proc_id, const char* name) {
+  if(Compact_Trace_Reader::is_compact_trace(name))
+    compact_reader[proc_id] = new Compact_Trace_Reader(name);
+  else
+    pin_reader[proc_id] = new Pin_Trace_Reader(name);
+  printf("pin trace should be opened now for core %u: %s \n", proc_id, name);
+}
+
 void pin_trace_close(unsigned char proc_id) {
-  pclose(pin_file[proc_id]);
+  delete pin_reader[proc_id];
+  delete compact_reader[proc_id];
+  pin_reader[proc_id]     = nullptr;
+  compact_reader[proc_id] = nullptr;
 }
 
 int pin_trace_read(unsigned char proc_id, ctype_pin_inst* pi) {
-  int read_size;
+  if(compact_reader[proc_id])
+    return compact_reader[proc_id]->read(pi);
+  return pin_reader[proc_id]->read(pi);
+}
 
-  read_size = fread(pi, sizeof(ctype_pin_inst), 1, pin_file[proc_id]);
-  if(read_size != 1) {
-    return 0;
+int pin_trace_skip(unsigned char proc_id, uint64_t num) {
+  if(compact_reader[proc_id])
+    return compact_reader[proc_id]->seek(compact_reader[proc_id]->tell() + num);
+  ctype_pin_inst pi;
+  for(uint64_t ii = 0; ii < num; ii++) {
+    if(!pin_reader[proc_id]->read(&pi))
+      return 0;
   }
   return 1;
 }
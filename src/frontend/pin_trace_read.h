@@ -39,6 +39,9 @@ void pin_trace_file_pointer_init(unsigned char);
 int  pin_trace_read(unsigned char, ctype_pin_inst*);
 void pin_trace_open(unsigned char, const char*);
 void pin_trace_close(unsigned char);
+/* skips the next num instructions, seeking in compact traces; returns 0 if
+   the trace ends first */
+int pin_trace_skip(unsigned char, uint64_t num);
 
 #ifdef __cplusplus
 }
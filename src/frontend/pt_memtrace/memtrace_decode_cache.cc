@@ -0,0 +1,175 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : frontend/pt_memtrace/memtrace_decode_cache.cc
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : File layout: Header, then num_entries packed DecodeCacheEntry
+ ***************************************************************************************/
+
+#include "frontend/pt_memtrace/memtrace_decode_cache.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern "C" {
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+}
+
+// 64-bit FNV-1a of a file's contents, 0 if it cannot be read
+static uint64_t file_fingerprint(const std::string& _name) {
+  std::ifstream file(_name, std::ios::binary);
+  if(_name.empty() || !file.is_open())
+    return 0;
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for(auto it = std::istreambuf_iterator<char>(file);
+      it != std::istreambuf_iterator<char>(); ++it) {
+    hash ^= static_cast<uint8_t>(*it);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+DecodeCache::DecodeCache(const std::string& _path,
+                         const std::string& _modules_log) :
+    path_(_path), fingerprint_(0), dirty_(false) {
+  if(!path_.empty()) {
+    fingerprint_ = file_fingerprint(_modules_log);
+    load();
+  }
+}
+
+void DecodeCache::load() {
+  int fd = open(path_.c_str(), O_RDONLY);
+  if(fd == -1)
+    return;  // first run, the file is written by save()
+  struct stat sb;
+  if(fstat(fd, &sb) == -1 || (size_t)sb.st_size < sizeof(Header)) {
+    WARNINGU(0, "Ignoring decode cache '%s': truncated\n", path_.c_str());
+    close(fd);
+    return;
+  }
+  size_t         size = sb.st_size;
+  const uint8_t* data = static_cast<const uint8_t*>(
+    mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0));
+  close(fd);
+  if(data == MAP_FAILED) {
+    WARNINGU(0, "Ignoring decode cache '%s': %s\n", path_.c_str(),
+             strerror(errno));
+    return;
+  }
+
+  // A cache written by a different build (another ctype_pin_inst layout) is
+  // rebuilt from scratch
+  const Header* header = reinterpret_cast<const Header*>(data);
+  if(memcmp(header->magic, DECODE_CACHE_MAGIC, sizeof(header->magic)) ||
+     header->version != DECODE_CACHE_VERSION ||
+     header->entry_size != sizeof(DecodeCacheEntry) ||
+     size < sizeof(Header) + header->num_entries * sizeof(DecodeCacheEntry)) {
+    WARNINGU(0, "Ignoring decode cache '%s': written by a different version\n",
+             path_.c_str());
+  } else if(header->fingerprint != fingerprint_) {
+    // The PCs of another trace's binaries may hold other instructions
+    WARNINGU(0, "Ignoring decode cache '%s': written for other modules\n",
+             path_.c_str());
+  } else {
+    const DecodeCacheEntry* entries = reinterpret_cast<const DecodeCacheEntry*>(
+      data + sizeof(Header));
+    entries_.reserve(header->num_entries);
+    for(uint64_t i = 0; i < header->num_entries; i++)
+      entries_.emplace(entries[i].pc, entries[i]);
+  }
+  munmap(const_cast<uint8_t*>(data), size);
+}
+
+DecodeCacheEntry* DecodeCache::find(uint64_t _pc) {
+  auto it = entries_.find(_pc);
+  return it == entries_.end() ? nullptr : &it->second;
+}
+
+DecodeCacheEntry* DecodeCache::insert(uint64_t _pc) {
+  DecodeCacheEntry& entry = entries_[_pc];
+  memset(&entry, 0, sizeof(entry));
+  entry.pc = _pc;
+  dirty_   = true;
+  return &entry;
+}
+
+void DecodeCache::staticInfoIs(DecodeCacheEntry*     _entry,
+                               const ctype_pin_inst* _info, bool _direct_cf) {
+  ctype_pin_inst* info = &_entry->static_info;
+  *info                = *_info;
+  info->inst_uid              = 0;
+  info->instruction_next_addr = 0;
+  info->actually_taken        = 0;
+  info->last_inst_from_trace  = 0;
+  info->fetched_instruction   = 0;
+  memset(info->ld_vaddr, 0, sizeof(info->ld_vaddr));
+  memset(info->st_vaddr, 0, sizeof(info->st_vaddr));
+  if(!_direct_cf)
+    info->branch_target = 0;
+  _entry->has_static = true;
+  dirty_             = true;
+}
+
+void DecodeCache::save() {
+  if(path_.empty() || !dirty_)
+    return;
+
+  // Simulations of the same trace may finish at the same time; each writes a
+  // private file and renames it over the cache, so readers never see a
+  // partial file
+  std::string tmp  = path_ + ".tmp." + std::to_string(getpid());
+  FILE*       file = fopen(tmp.c_str(), "wb");
+  if(!file) {
+    WARNINGU(0, "Could not write decode cache '%s': %s\n", tmp.c_str(),
+             strerror(errno));
+    return;
+  }
+  Header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, DECODE_CACHE_MAGIC, sizeof(header.magic));
+  header.version     = DECODE_CACHE_VERSION;
+  header.entry_size  = sizeof(DecodeCacheEntry);
+  header.fingerprint = fingerprint_;
+  header.num_entries = entries_.size();
+  bool ok            = fwrite(&header, sizeof(header), 1, file) == 1;
+  for(const auto& entry : entries_)
+    ok = ok && fwrite(&entry.second, sizeof(entry.second), 1, file) == 1;
+  ok = (fclose(file) == 0) && ok;
+  if(!ok || rename(tmp.c_str(), path_.c_str()) == -1) {
+    WARNINGU(0, "Could not write decode cache '%s': %s\n", path_.c_str(),
+             strerror(errno));
+    unlink(tmp.c_str());
+    return;
+  }
+  dirty_ = false;
+}
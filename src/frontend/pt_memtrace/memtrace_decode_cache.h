@@ -0,0 +1,99 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : frontend/pt_memtrace/memtrace_decode_cache.h
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : Decoded static instructions of a trace, by PC. Holds what
+ *                TraceReader::fillCache() derives from the instruction bytes
+ *                (the MAP_* features) and the static ctype_pin_inst fields the
+ *                memtrace frontend builds with the x86 decoder, so that both
+ *                are computed once per PC. The cache can be kept in a file: it
+ *                is loaded when the reader starts and written back with any
+ *                new PCs at the end of the simulation, which lets later runs
+ *                of the same trace skip decoding and loading the binaries.
+ *                Since entries are keyed by PC alone, the file records a
+ *                fingerprint of the trace's modules.log (the paths, checksums
+ *                and timestamps of the traced binaries) and is only reused by
+ *                a reader of the same modules.
+ ***************************************************************************************/
+
+#ifndef MEMTRACE_DECODE_CACHE_H
+#define MEMTRACE_DECODE_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "ctype_pin_inst.h"
+
+#define DECODE_CACHE_MAGIC "SCRBDEC"  // includes the terminating NUL
+#define DECODE_CACHE_VERSION 2
+#define DECODE_CACHE_MAX_BYTES 15
+
+struct DecodeCacheEntry {
+  uint64_t       pc;
+  uint8_t        size;
+  uint8_t        bytes[DECODE_CACHE_MAX_BYTES];
+  int            mem_ops;       // MAP_MEMOPS
+  bool           unknown_type;  // MAP_UNKNOWN, no bytes were available
+  bool           cond_branch;   // MAP_COND
+  bool           rep;           // MAP_REP
+  bool           has_static;    // static_info is filled in
+  ctype_pin_inst static_info;   // dynamic fields cleared
+};
+
+class DecodeCache {
+ public:
+  // An empty path keeps the cache in memory only. '_modules_log' identifies
+  // the binaries the PCs belong to; a file saved for other modules is ignored.
+  DecodeCache(const std::string& _path, const std::string& _modules_log);
+
+  DecodeCacheEntry* find(uint64_t _pc);
+  // (Re)initializes the entry of _pc
+  DecodeCacheEntry* insert(uint64_t _pc);
+  // Records the static part of an instruction decoded at the entry's PC.
+  // Direct branch targets are static and kept.
+  void   staticInfoIs(DecodeCacheEntry* _entry, const ctype_pin_inst* _info,
+                      bool _direct_cf);
+  size_t size() const { return entries_.size(); }
+  // Writes the cache to its file if it changed
+  void save();
+
+ private:
+  struct Header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t entry_size;   // sizeof(DecodeCacheEntry) of the writer
+    uint64_t fingerprint;  // of the modules.log contents
+    uint64_t num_entries;
+  };
+
+  void load();
+
+  std::string                                    path_;
+  uint64_t                                       fingerprint_;
+  std::unordered_map<uint64_t, DecodeCacheEntry> entries_;
+  bool                                           dirty_;
+};
+
+#endif
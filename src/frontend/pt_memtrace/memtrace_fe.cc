@@ -49,19 +49,24 @@ extern "C" {
 #define DR_DO_NOT_DEFINE_int64
 
 #include "frontend/pt_memtrace/memtrace_trace_reader_memtrace.h"
+#include "frontend/pt_memtrace/trace_decode_thread.h"
+#include <mutex>
 #include <unordered_map>
 /**************************************************************************************/
 /* Global Variables */
 
 static char*    trace_files[MAX_NUM_PROCS];
 TraceReader*    trace_readers[MAX_NUM_PROCS];
-//TODO: Make per proc?
-uint64_t        ins_id    = 0;
-uint64_t        ins_id_fetched = 0;
-uint64_t        prior_tid = 0;
-uint64_t        prior_pid = 0;
+static TraceDecodeThread* decode_threads[MAX_NUM_PROCS];
+// per core, so that the cores can be decoded on their own threads
+uint64_t        ins_id[MAX_NUM_PROCS]         = {0};
+uint64_t        ins_id_fetched[MAX_NUM_PROCS] = {0};
+uint64_t        prior_tid[MAX_NUM_PROCS]      = {0};
+uint64_t        prior_pid[MAX_NUM_PROCS]      = {0};
 uint64_t        rdptr = 0;
 uint64_t        wrptr = 0;
+// scatter_info_storage is shared by the cores
+static std::mutex gather_scatter_lock;
 
 extern scatter_info_map                          scatter_info_storage;
 
@@ -74,10 +79,12 @@ const int CLINE = ~0x3F;
 /**************************************************************************************/
 /* Private Functions */
 int memtrace_trace_read_internal(int proc_id, ctype_pin_inst* next_onpath_pi);
+int memtrace_trace_decode(int proc_id, ctype_pin_inst* next_onpath_pi);
 void buf_map_insert();
 void buf_map_remove();
 
-void fill_in_dynamic_info(ctype_pin_inst* info, const InstInfo* insi) {
+void fill_in_dynamic_info(int proc_id, ctype_pin_inst* info,
+                          const InstInfo* insi) {
   uint8_t ld = 0;
   uint8_t st = 0;
 
@@ -86,7 +93,7 @@ void fill_in_dynamic_info(ctype_pin_inst* info, const InstInfo* insi) {
   info->instruction_next_addr = insi->target;
   info->actually_taken        = insi->taken;
   info->branch_target         = insi->target;
-  info->inst_uid              = ins_id;
+  info->inst_uid              = ins_id[proc_id];
   info->last_inst_from_trace  = insi->last_inst_from_trace;
   info->fetched_instruction   = insi->fetched_instruction;
 
@@ -123,7 +130,7 @@ void fill_in_dynamic_info(ctype_pin_inst* info, const InstInfo* insi) {
   }
 }
 
-int ffwd(const xed_decoded_inst_t* ins) {
+int ffwd(int proc_id, const xed_decoded_inst_t* ins) {
   if(!FAST_FORWARD) {
     return 0;
   }
@@ -132,7 +139,8 @@ int ffwd(const xed_decoded_inst_t* ins) {
      XED_INS_OperandReg(ins, 1) == XED_REG_RCX) {
     return 0;
   }
-  if((USE_FETCHED_COUNT ? ins_id_fetched : ins_id) == FAST_FORWARD_TRACE_INS) {
+  if((USE_FETCHED_COUNT ? ins_id_fetched[proc_id] : ins_id[proc_id]) ==
+     FAST_FORWARD_TRACE_INS) {
     return 0;
   }
   return 1;
@@ -190,43 +198,14 @@ int memtrace_trace_read(int proc_id, ctype_pin_inst* next_onpath_pi) {
   }
 }
 
+// Reads the next instruction, from the decode thread if there is one, and
+// applies its ROI markers, which act on the simulation
 int memtrace_trace_read_internal(int proc_id, ctype_pin_inst* next_onpath_pi) {
-  InstInfo* insi;
-
-  do {
-    insi = const_cast<InstInfo*>(trace_readers[proc_id]->nextInstruction());
-
-    if(prior_pid == 0) {
-      ASSERT(proc_id, prior_tid == 0);
-      ASSERT(proc_id, insi->valid);
-      prior_pid = insi->pid;
-      prior_tid = insi->tid;
-      ASSERT(proc_id, prior_tid);
-      ASSERT(proc_id, prior_pid);
-    }
-    if(insi->valid) {
-      ins_id++;
-      if(insi->fetched_instruction) {
-        ins_id_fetched++;
-      }
-    } else {
-      return 0;  // end of trace
-    }
-  } while(insi->pid != prior_pid || insi->tid != prior_tid);
-
-  memset(next_onpath_pi, 0, sizeof(ctype_pin_inst));
-  fill_in_dynamic_info(next_onpath_pi, insi);
-  fill_in_basic_info(next_onpath_pi, insi->ins);
-  if(XED_INS_IsVgather(insi->ins) || XED_INS_IsVscatter(insi->ins)) {
-    xed_category_enum_t category           = XED_INS_Category(insi->ins);
-    scatter_info_storage[insi->pc] = add_to_gather_scatter_info_storage(
-      insi->pc, XED_INS_IsVgather(insi->ins), XED_INS_IsVscatter(insi->ins), category);
-  }
-  uint32_t max_op_width = add_dependency_info(next_onpath_pi, insi->ins);
-  fill_in_simd_info(next_onpath_pi, insi->ins, max_op_width);
-  apply_x87_bug_workaround(next_onpath_pi, insi->ins);
-  fill_in_cf_info(next_onpath_pi, insi->ins);
-  print_err_if_invalid(next_onpath_pi, insi->ins);
+  int success = decode_threads[proc_id] ?
+                  decode_threads[proc_id]->read(next_onpath_pi) :
+                  memtrace_trace_decode(proc_id, next_onpath_pi);
+  if(!success)
+    return 0;
 
   if (next_onpath_pi->scarab_marker_roi_begin == true) {
     assert(!roi_dump_began);
@@ -242,6 +221,68 @@ int memtrace_trace_read_internal(int proc_id, ctype_pin_inst* next_onpath_pi) {
     roi_dump_began = FALSE;
     roi_dump_ID ++;
   }
+  return 1;
+}
+
+// Decodes the next instruction of the core's trace; runs on the decode thread
+// if TRACE_DECODE_THREAD is set
+int memtrace_trace_decode(int proc_id, ctype_pin_inst* next_onpath_pi) {
+  InstInfo* insi;
+
+  do {
+    insi = const_cast<InstInfo*>(trace_readers[proc_id]->nextInstruction());
+
+    if(prior_pid[proc_id] == 0) {
+      ASSERT(proc_id, prior_tid[proc_id] == 0);
+      ASSERT(proc_id, insi->valid);
+      prior_pid[proc_id] = insi->pid;
+      prior_tid[proc_id] = insi->tid;
+      ASSERT(proc_id, prior_tid[proc_id]);
+      ASSERT(proc_id, prior_pid[proc_id]);
+    }
+    if(insi->valid) {
+      ins_id[proc_id]++;
+      if(insi->fetched_instruction) {
+        ins_id_fetched[proc_id]++;
+      }
+    } else {
+      return 0;  // end of trace
+    }
+  } while(insi->pid != prior_pid[proc_id] || insi->tid != prior_tid[proc_id]);
+
+  DecodeCacheEntry* decoded = insi->decode_entry;
+  if(decoded && decoded->has_static) {
+    // The static fields were decoded the first time this PC was seen
+    *next_onpath_pi = decoded->static_info;
+    fill_in_dynamic_info(proc_id, next_onpath_pi, insi);
+    if(XED_INS_IsDirectBranchOrCall(insi->ins))
+      next_onpath_pi->branch_target = decoded->static_info.branch_target;
+  } else {
+    bool is_gather_scatter = XED_INS_IsVgather(insi->ins) ||
+                             XED_INS_IsVscatter(insi->ins);
+    std::unique_lock<std::mutex> guard(gather_scatter_lock, std::defer_lock);
+    memset(next_onpath_pi, 0, sizeof(ctype_pin_inst));
+    fill_in_dynamic_info(proc_id, next_onpath_pi, insi);
+    fill_in_basic_info(next_onpath_pi, insi->ins);
+    if(is_gather_scatter) {
+      guard.lock();
+      xed_category_enum_t category           = XED_INS_Category(insi->ins);
+      scatter_info_storage[insi->pc] = add_to_gather_scatter_info_storage(
+        insi->pc, XED_INS_IsVgather(insi->ins), XED_INS_IsVscatter(insi->ins), category);
+    }
+    uint32_t max_op_width = add_dependency_info(next_onpath_pi, insi->ins);
+    if(guard.owns_lock())
+      guard.unlock();
+    fill_in_simd_info(next_onpath_pi, insi->ins, max_op_width);
+    apply_x87_bug_workaround(next_onpath_pi, insi->ins);
+    fill_in_cf_info(next_onpath_pi, insi->ins);
+    // gather/scatter instructions also fill scatter_info_storage, so they are
+    // always decoded
+    if(decoded && !is_gather_scatter)
+      trace_readers[proc_id]->decodeCache()->staticInfoIs(
+        decoded, next_onpath_pi, XED_INS_IsDirectBranchOrCall(insi->ins));
+  }
+  print_err_if_invalid(next_onpath_pi, insi->ins);
 
   // End of ROI
   if(roi(insi->ins))
@@ -288,6 +329,12 @@ void memtrace_init(void) {
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     memtrace_setup(proc_id);
   }
+  if(TRACE_DECODE_THREAD) {
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+      decode_threads[proc_id] = new TraceDecodeThread(
+        proc_id, memtrace_trace_decode, TRACE_DECODE_RING_SIZE);
+    }
+  }
 }
 
 void memtrace_setup(uns proc_id) {
@@ -295,12 +342,27 @@ void memtrace_setup(uns proc_id) {
   std::string trace(path);
   std::string binaries(MEMTRACE_MODULES_LOG);
 
-  trace_readers[proc_id] = new TraceReaderMemtrace(trace, binaries, 1);
+  std::string decode_cache;
+  if(MEMTRACE_DECODE_CACHE)
+    decode_cache = std::string(MEMTRACE_DECODE_CACHE) + "." +
+                   std::to_string(proc_id);
 
-  if(FAST_FORWARD) {
+  trace_readers[proc_id] = new TraceReaderMemtrace(trace, binaries, 1,
+                                                   decode_cache);
+
+  if(FAST_FORWARD && FAST_FORWARD_SEEK) {
+    ASSERT(proc_id, !MEMTRACE_ROI_BEGIN && !MEMTRACE_ROI_END);
+    ASSERTM(proc_id, FAST_FORWARD_TRACE_INS && !USE_FETCHED_COUNT,
+            "FAST_FORWARD_SEEK needs FAST_FORWARD_TRACE_INS and counts all "
+            "instructions\n");
+    // the reader already starts past the fast forwarded instructions
+    ins_id[proc_id] = FAST_FORWARD_TRACE_INS;
+    std::cout << "Fast forwarded to " << ins_id[proc_id] << " by seeking"
+              << std::endl;
+  } else if(FAST_FORWARD) {
     ASSERT(proc_id, !MEMTRACE_ROI_BEGIN && !MEMTRACE_ROI_END);
     uint64_t inst_count_to_use = USE_FETCHED_COUNT ?
-                                  ins_id_fetched : ins_id;
+                                  ins_id_fetched[proc_id] : ins_id[proc_id];
     std::cout << "Enter fast forward " << inst_count_to_use << std::endl;
     // FFWD the first instruction and as many as later ffwding parameters specify.
     // insi is invalid once end of trace is reached.
@@ -308,17 +370,18 @@ void memtrace_setup(uns proc_id) {
     const InstInfo *insi;
     do {
       insi = trace_readers[proc_id]->nextInstruction();
-      ins_id++;
+      ins_id[proc_id]++;
       if(insi->fetched_instruction) {
-        ins_id_fetched++;
+        ins_id_fetched[proc_id]++;
       }
 
-      inst_count_to_use = USE_FETCHED_COUNT ? ins_id_fetched : ins_id;
+      inst_count_to_use = USE_FETCHED_COUNT ? ins_id_fetched[proc_id] :
+                                              ins_id[proc_id];
 
       if((inst_count_to_use % 10000000) == 0)
         std::cout << "Fast forwarded " << inst_count_to_use << " instructions."
         << (insi->valid ? " Valid" : " Invalid") << " instr." << std::endl;
-    } while(ffwd(insi->ins));
+    } while(ffwd(proc_id, insi->ins));
     std::cout << "Exit fast forward " << inst_count_to_use << std::endl;
   }
 
@@ -332,3 +395,15 @@ void memtrace_setup(uns proc_id) {
     }
   }
 }
+
+/**************************************************************************************/
+/* memtrace_done() */
+
+void memtrace_done(void) {
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    // the decode thread uses the decode cache
+    delete decode_threads[proc_id];
+    decode_threads[proc_id] = NULL;
+    trace_readers[proc_id]->decodeCache()->save();
+  }
+}
@@ -48,6 +48,7 @@ extern "C" {
 void memtrace_init(void);
 int  memtrace_trace_read(int proc_id, ctype_pin_inst* pt_next_pi);
 void memtrace_setup(uns proc_id);
+void memtrace_done(void);
 bool buf_map_find(uns64 line_addr);
 
 #ifdef __cplusplus
@@ -28,6 +28,7 @@
 
 #include "frontend/pt_memtrace/memtrace_trace_reader.h"
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <fcntl.h>
 #include <fstream>
@@ -66,16 +67,23 @@ TraceReader::TraceReader() :
 TraceReader::TraceReader(const std::string& _trace, const std::string& _binary,
                          uint64_t _offset, uint32_t _buf_size) :
     trace_ready_(false),
-    binary_ready_(true), warn_not_found_(1), skipped_(0), buf_size_(_buf_size) {
+    binary_ready_(true), decode_cache_(make_unique<DecodeCache>("", "")),
+    warn_not_found_(1), skipped_(0), buf_size_(_buf_size) {
   binaryFileIs(_binary, _offset);
 }
 
 // Trace + multiple binaries
 TraceReader::TraceReader(const std::string& _trace,
                          const std::string& _binary_group_path,
-                         uint32_t           _buf_size) :
+                         uint32_t           _buf_size,
+                         const std::string& _decode_cache) :
     trace_ready_(false),
-    binary_ready_(true), warn_not_found_(1), skipped_(0), buf_size_(_buf_size) {
+    binary_ready_(true),
+    decode_cache_(make_unique<DecodeCache>(
+      _decode_cache, _binary_group_path.empty() ?
+                       "" :
+                       _binary_group_path + "/modules.log")),
+    warn_not_found_(1), skipped_(0), buf_size_(_buf_size) {
 }
 
 TraceReader::~TraceReader() {
@@ -116,6 +124,7 @@ void TraceReader::init(const std::string& _trace) {
   invalid_info_.taken        = false;
   invalid_info_.unknown_type = false;
   invalid_info_.valid        = false;
+  invalid_info_.decode_entry = nullptr;
 
   if(_trace.size())
     traceFileIs(_trace);
@@ -220,13 +229,18 @@ void TraceReader::fillCache(uint64_t _vAddr, uint8_t _reported_size,
                             uint8_t* inst_bytes) {
   uint64_t size;
   uint8_t* loc;
+  if(fillCacheFromDecodeCache(_vAddr, _reported_size, inst_bytes)) {
+    return;
+  }
   if(inst_bytes != NULL || locationForVAddr(_vAddr, &loc, &size)) {
-    xed_map_.emplace(_vAddr, make_tuple(0, false, false, false,
-                                        make_unique<xed_decoded_inst_t>()));
+    xed_map_.emplace(_vAddr,
+                     make_tuple(0, false, false, false,
+                                make_unique<xed_decoded_inst_t>(), nullptr));
     xed_decoded_inst_t* ins = get<MAP_XED>(xed_map_.at(_vAddr)).get();
     xed_decoded_inst_zero_set_mode(ins, &xed_state_);
     if(inst_bytes != NULL) {
       loc  = inst_bytes;
+      size = _reported_size;
     }
     xed_error_enum_t res;
     res = xed_decode(ins, loc, _reported_size);
@@ -269,6 +283,7 @@ void TraceReader::fillCache(uint64_t _vAddr, uint8_t _reported_size,
     // variable number of memory records for input formats like memtrace
     bool is_rep = xed_decoded_inst_get_attribute(ins, XED_ATTRIBUTE_REP) > 0;
     get<MAP_REP>(xed_tuple) = is_rep;
+    addToDecodeCache(_vAddr, _reported_size, loc, size);
   } else {
     if(warn_not_found_ > 0) {
       warn_not_found_ -= 1;
@@ -283,9 +298,69 @@ void TraceReader::fillCache(uint64_t _vAddr, uint8_t _reported_size,
     // Replace the unknown instruction with a NOP
     // NOTE: Unknown memory records are skipped, so 'rep' needs no special
     // handling here
-    xed_map_.emplace(
-      _vAddr, make_tuple(0, true, false, false, makeNop(_reported_size)));
+    xed_map_.emplace(_vAddr, make_tuple(0, true, false, false,
+                                        makeNop(_reported_size), nullptr));
+    addToDecodeCache(_vAddr, _reported_size, nullptr, 0);
+  }
+}
+
+// Fills in the 'xed_map_' entry of an address from the decode cache, which
+// needs neither the binaries nor the x86 decoder. Returns false if the cache
+// has no entry for it, or the trace carries instruction bytes that differ from
+// the cached ones.
+bool TraceReader::fillCacheFromDecodeCache(uint64_t _vAddr,
+                                           uint8_t  _reported_size,
+                                           uint8_t* inst_bytes) {
+  if(!decode_cache_) {
+    return false;
   }
+  DecodeCacheEntry* entry = decode_cache_->find(_vAddr);
+  if(entry == nullptr || entry->size != _reported_size ||
+     (inst_bytes != NULL &&
+      (entry->unknown_type ||
+       memcmp(inst_bytes, entry->bytes,
+              std::min<uint32_t>(_reported_size, DECODE_CACHE_MAX_BYTES))))) {
+    return false;
+  }
+
+  unique_ptr<xed_decoded_inst_t> ins;
+  if(!entry->unknown_type) {
+    ins = make_unique<xed_decoded_inst_t>();
+    xed_decoded_inst_zero_set_mode(ins.get(), &xed_state_);
+    if(xed_decode(ins.get(), entry->bytes, entry->size) != XED_ERROR_NONE) {
+      ins = makeNop(_reported_size);
+    }
+  } else {
+    ins = makeNop(_reported_size);
+  }
+  xed_map_.emplace(_vAddr,
+                   make_tuple(entry->mem_ops, entry->unknown_type,
+                              entry->cond_branch, entry->rep, std::move(ins),
+                              entry));
+  return true;
+}
+
+void TraceReader::addToDecodeCache(uint64_t _vAddr, uint8_t _reported_size,
+                                   const uint8_t* _bytes,
+                                   uint64_t       _num_bytes) {
+  if(!decode_cache_) {
+    return;
+  }
+  auto&             xed_tuple = xed_map_.at(_vAddr);
+  DecodeCacheEntry* entry     = decode_cache_->insert(_vAddr);
+
+  entry->size = _reported_size;
+  if(_bytes != NULL) {
+    memcpy(entry->bytes, _bytes,
+           std::min<uint64_t>({_num_bytes, _reported_size,
+                               DECODE_CACHE_MAX_BYTES}));
+  }
+  entry->mem_ops      = get<MAP_MEMOPS>(xed_tuple);
+  entry->unknown_type = get<MAP_UNKNOWN>(xed_tuple);
+  entry->cond_branch  = get<MAP_COND>(xed_tuple);
+  entry->rep          = get<MAP_REP>(xed_tuple);
+
+  get<MAP_DECODE>(xed_tuple) = entry;
 }
 
 unique_ptr<xed_decoded_inst_t> TraceReader::makeNop(uint8_t _length) {
@@ -321,7 +396,7 @@ unique_ptr<xed_decoded_inst_t> TraceReader::makeNop(uint8_t _length) {
 
 // WARNING: This function generates a memory leak!
 xed_decoded_inst_t* TraceReader::createJmp(uint64_t displacement) {
-  static int createdJmps = 0;
+  static std::atomic<int> createdJmps(0);
   xed_encoder_instruction_t inst;
   xed_state_t state;
   state.mmode = XED_MACHINE_MODE_LONG_64;
@@ -340,9 +415,9 @@ xed_decoded_inst_t* TraceReader::createJmp(uint64_t displacement) {
     return nullptr;
   }
   xed_decoded_inst_t* decoded_inst = new xed_decoded_inst_t;
-  createdJmps++;
-  if ((createdJmps % 1000) == 0)
-    warn("generated %i Jmp instructions, possible memory leak", createdJmps);
+  int numJmps = ++createdJmps;
+  if ((numJmps % 1000) == 0)
+    warn("generated %i Jmp instructions, possible memory leak", numJmps);
   xed_decoded_inst_zero(decoded_inst);
   xed_decoded_inst_set_mode(decoded_inst, XED_MACHINE_MODE_LONG_64, XED_ADDRESS_WIDTH_64b);
   error = xed_decode(decoded_inst, encodedBytes, numBytesUsed);
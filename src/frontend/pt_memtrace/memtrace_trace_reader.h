@@ -40,6 +40,7 @@
 
 #define DR_DO_NOT_DEFINE_int64
 #include "./pin/pin_lib/x86_decoder.h"
+#include "frontend/pt_memtrace/memtrace_decode_cache.h"
 
 extern "C" {
 #include "xed-interface.h"
@@ -60,6 +61,7 @@ static constexpr int MAP_UNKNOWN = 1;
 static constexpr int MAP_COND    = 2;
 static constexpr int MAP_REP     = 3;
 static constexpr int MAP_XED     = 4;
+static constexpr int MAP_DECODE  = 5;  // decode cache entry, may be NULL
 
 class TraceReader {
  public:
@@ -78,8 +80,9 @@ class TraceReader {
               uint64_t _offset, uint32_t _buf_size = 0);
   // A trace and multi-binary object which reads 'binary-info.txt' from the
   // input path. This file contains one '<binary> <offset>' pair per line.
+  // Decoded instructions are kept in '_decode_cache' if it is not empty.
   TraceReader(const std::string& _trace, const std::string& _binary_group_path,
-              uint32_t _buf_size = 0);
+              uint32_t _buf_size = 0, const std::string& _decode_cache = "");
   ~TraceReader();
   // A constructor that fails will cause operator! to return true
   bool              operator!();
@@ -89,6 +92,7 @@ class TraceReader {
   const returnValue findPC(bufferEntry& ref, uint64_t _pc);
   const returnValue peekInstructionAtIndex(uint32_t idx, bufferEntry& ref);
   bufferEntry       bufferStart();
+  DecodeCache*      decodeCache() { return decode_cache_.get(); }
 
  private:
   virtual const InstInfo* getNextInstruction()                        = 0;
@@ -112,18 +116,24 @@ class TraceReader {
   std::unordered_map<std::string, std::pair<uint8_t*, uint64_t>> binaries_;
   std::vector<std::tuple<uint64_t, uint64_t, uint8_t*>>          sections_;
   std::unordered_map<uint64_t, std::tuple<int, bool, bool, bool,
-                                          std::unique_ptr<xed_decoded_inst_t>>>
-                       xed_map_;
-  int                  warn_not_found_;
-  uint64_t             skipped_;
-  uint32_t             buf_size_;
-  std::deque<InstInfo> ins_buffer;
+                                          std::unique_ptr<xed_decoded_inst_t>,
+                                          DecodeCacheEntry*>>
+                               xed_map_;
+  std::unique_ptr<DecodeCache> decode_cache_;
+  int                          warn_not_found_;
+  uint64_t                     skipped_;
+  uint32_t                     buf_size_;
+  std::deque<InstInfo>         ins_buffer;
 
   void init(const std::string& _trace);
   bool initBinary(const std::string& _name, uint64_t _offset);
   void clearBinaries();
   void fillCache(uint64_t _vAddr, uint8_t _reported_size,
                  uint8_t* inst_bytes = NULL);
+  bool fillCacheFromDecodeCache(uint64_t _vAddr, uint8_t _reported_size,
+                                uint8_t* inst_bytes);
+  void addToDecodeCache(uint64_t _vAddr, uint8_t _reported_size,
+                        const uint8_t* _bytes, uint64_t _num_bytes);
   void traceFileIs(const std::string& _trace);
   xed_decoded_inst_t* createJmp(uint64_t displacement);
 };
@@ -38,23 +38,32 @@ TraceReaderMemtrace::TraceReaderMemtrace(const std::string& _trace,
                                          const std::string& _binary,
                                          uint64_t _offset, uint32_t _bufsize) :
     TraceReader(_trace, _binary, _offset, _bufsize),
+    dcontext_(nullptr),
     mt_state_(MTState::INST),
     mt_use_next_ref_(true),
     mt_mem_ops_(0), mt_seq_(0), mt_prior_isize_(0), mt_using_info_a_(true),
-    mt_warn_target_(0) {
+    mt_warn_target_(0), mt_first_instr_(true) {
   init(_trace);
 }
 
 // Trace + multiple binaries
 TraceReaderMemtrace::TraceReaderMemtrace(const std::string& _trace,
                                          const std::string& _binary_group_path,
-                                         uint32_t           _bufsize) :
-    TraceReader(_trace, _binary_group_path, _bufsize),
+                                         uint32_t           _bufsize,
+                                         const std::string& _decode_cache) :
+    TraceReader(_trace, _binary_group_path, _bufsize, _decode_cache),
+    dcontext_(nullptr),
     mt_state_(MTState::INST),
     mt_use_next_ref_(true),
     mt_mem_ops_(0), mt_seq_(0), mt_prior_isize_(0), mt_using_info_a_(true),
-    mt_warn_target_(0) {
-  binaryGroupPathIs(_binary_group_path);
+    mt_warn_target_(0), mt_first_instr_(true) {
+  if(decode_cache_->size() > 0) {
+    // Most instructions will be in the decode cache, so the binaries are only
+    // loaded if one is missing
+    binary_group_path_ = _binary_group_path;
+  } else {
+    binaryGroupPathIs(_binary_group_path);
+  }
   init(_trace);
 }
 
@@ -101,7 +110,9 @@ void TraceReaderMemtrace::binaryGroupPathIs(const std::string& _path) {
       panic("Module file path is missing");
       return;
     }
-    dcontext_         = dr_standalone_init();
+    if(dcontext_ == nullptr) {
+      dcontext_ = dr_standalone_init();
+    }
     std::string error = directory_.initialize_module_file(_path +
                                                           "/modules.log");
     if(!error.empty()) {
@@ -137,10 +148,17 @@ bool TraceReaderMemtrace::initTrace() {
   // begin 0 is invalid
   // end is inclusive
   // end 0 is end of trace
+  // The scheduler skips to the beginning of the region with the chunk index
+  // of the trace, without reading the instructions before it
   if(MEMTRACE_ROI_BEGIN) {
     ASSERT(0, MEMTRACE_ROI_BEGIN < MEMTRACE_ROI_END || MEMTRACE_ROI_END == 0);
     dynamorio::drmemtrace::scheduler_t::range_t roi(static_cast<uint64_t>(MEMTRACE_ROI_BEGIN), static_cast<uint64_t>(MEMTRACE_ROI_END));
     sched_inputs.emplace_back(trace_, std::vector<dynamorio::drmemtrace::scheduler_t::range_t>{roi});
+  } else if(FAST_FORWARD && FAST_FORWARD_SEEK) {
+    // memtrace_setup() continues counting at FAST_FORWARD_TRACE_INS
+    dynamorio::drmemtrace::scheduler_t::range_t roi(
+      static_cast<uint64_t>(FAST_FORWARD_TRACE_INS) + 1, 0);
+    sched_inputs.emplace_back(trace_, std::vector<dynamorio::drmemtrace::scheduler_t::range_t>{roi});
   } else {
     sched_inputs.emplace_back(trace_);
   }
@@ -160,7 +178,6 @@ bool TraceReaderMemtrace::initTrace() {
 
 bool TraceReaderMemtrace::getNextInstruction__(InstInfo* _info,
                                                InstInfo* _prior) {
-  static bool first_instr = true;
   uint32_t prior_isize = mt_prior_isize_;
   bool     complete    = false;
 
@@ -188,13 +205,13 @@ bool TraceReaderMemtrace::getNextInstruction__(InstInfo* _info,
     switch(mt_state_) {
       case(MTState::INST):
         if(type_is_instr(mt_ref_.instr.type)) {
-          if(first_instr) {
+          if(mt_first_instr_) {
             // if this is the first instruction ever,
             // the file type marker of the trace should have been processed internally by DynamoRIO.
             // it is time to see if encodings are available.
             auto type = stream->get_filetype();
             trace_has_encodings_ = type & dynamorio::drmemtrace::OFFLINE_FILE_TYPE_ENCODINGS;
-            first_instr = false;
+            mt_first_instr_ = false;
           }
           processInst(_info);
           if(mt_mem_ops_ > 0) {
@@ -322,6 +339,7 @@ PATCH_REP:
     }
     else if (_prior->pc && non_seq && (!is_rep || (_prior->pc != _info->pc && (_prior->pc + prior_isize) != _info->pc))) {
       _prior->ins = createJmp(_info->pc - _prior->pc);
+      _prior->decode_entry = nullptr;
       _prior->target = _info->pc;
       _prior->taken = true;
       _prior->mem_used[0] = false;
@@ -356,10 +374,11 @@ void TraceReaderMemtrace::processInst(InstInfo* _info) {
   xed_decoded_inst_t* xed_ins;
   auto&               xed_tuple = (*xed_map_iter).second;
 
-  tie(mt_mem_ops_, unknown_type, cond_branch, std::ignore,
-      std::ignore) = xed_tuple;
-  mt_prior_isize_  = mt_ref_.instr.size;
-  xed_ins          = std::get<MAP_XED>(xed_tuple).get();
+  tie(mt_mem_ops_, unknown_type, cond_branch, std::ignore, std::ignore,
+      std::ignore)    = xed_tuple;
+  mt_prior_isize_     = mt_ref_.instr.size;
+  xed_ins             = std::get<MAP_XED>(xed_tuple).get();
+  _info->decode_entry = std::get<MAP_DECODE>(xed_tuple);
 
   xed_category_enum_t category = xed_decoded_inst_get_category(xed_ins);
   _info->pc = mt_ref_.instr.addr;
@@ -410,6 +429,15 @@ bool TraceReaderMemtrace::locationForVAddr(uint64_t _vaddr, uint8_t** _loc,
   app_pc module_start;
   size_t module_size;
 
+  if(!module_mapper_ && !binary_group_path_.empty()) {
+    std::string path = binary_group_path_;
+    binary_group_path_.clear();
+    binaryGroupPathIs(path);
+  }
+  if(!module_mapper_) {
+    return false;
+  }
+
   *_loc = module_mapper_->find_mapped_trace_bounds(
     reinterpret_cast<app_pc>(_vaddr), &module_start, &module_size);
   *_size = reinterpret_cast<uint64_t>(module_size) -
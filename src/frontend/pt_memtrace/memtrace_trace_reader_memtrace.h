@@ -41,7 +41,8 @@ class TraceReaderMemtrace : public TraceReader {
   TraceReaderMemtrace(const std::string& _trace, const std::string& _binary,
                       uint64_t _offset, uint32_t _bufsize);
   TraceReaderMemtrace(const std::string& _trace,
-                      const std::string& _binary_group_path, uint32_t _bufsize);
+                      const std::string& _binary_group_path, uint32_t _bufsize,
+                      const std::string& _decode_cache = "");
   ~TraceReaderMemtrace();
 
  private:
@@ -57,6 +58,7 @@ class TraceReaderMemtrace : public TraceReader {
 
   std::unique_ptr<dynamorio::drmemtrace::module_mapper_t> module_mapper_;
   dynamorio::drmemtrace::raw2trace_directory_t            directory_;
+  std::string                      binary_group_path_;  // not loaded yet
   void*                            dcontext_;
   unsigned int                     knob_verbose_;
   bool                             trace_has_encodings_;
@@ -82,6 +84,8 @@ class TraceReaderMemtrace : public TraceReader {
   InstInfo                    mt_info_b_;
   bool                        mt_using_info_a_;
   uint64_t                    mt_warn_target_;
+  bool                        mt_first_instr_;  // per reader, they can run on
+                                                // their own decode threads
 };
 
 #endif
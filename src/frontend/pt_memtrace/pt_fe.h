@@ -48,6 +48,7 @@ extern "C" {
 void pt_init(void);
 int  pt_trace_read(int proc_id, ctype_pin_inst* pt_next_pi);
 void pt_setup(uns proc_id);
+void pt_done(void);
 
 #ifdef __cplusplus
 }
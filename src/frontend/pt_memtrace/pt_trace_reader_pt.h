@@ -63,9 +63,11 @@ private:
   uint64_t num_nops_in_trace = 0, num_inserted_nops = 0;
   uint64_t num_direct_brs_in_trace = 0, num_inserted_direct_brs = 0;
   std::vector <std::string> parsed;
+  // per reader, they can run on their own decode threads
+  uns64 num_nops_at_start = 0;
+  bool should_be_valid = false;
 public:
   bool read_next_line(PTInst &inst) {
-      static uns64 num_nops_at_start = 0;
       if(num_nops_at_start <= NUM_NOPS) { // = is because the last one will be overwritten as a JMP to the real instruction stream
           inst.pc = NOPS_BB_START + num_nops_at_start++;
           inst.size = 1;
@@ -153,8 +155,8 @@ public:
       int mem_ops_;
       xed_decoded_inst_t *xed_ins;
       auto &xed_tuple = (*xed_map_iter).second;
-      tie(mem_ops_, unknown_type, cond_branch, std::ignore, std::ignore) =
-          xed_tuple;
+      tie(mem_ops_, unknown_type, cond_branch, std::ignore, std::ignore,
+          std::ignore) = xed_tuple;
       xed_ins = std::get<MAP_XED>(xed_tuple).get();
       InstInfo& _info = (use_info_a ? inst_info_a : inst_info_b);
       InstInfo& _prior = (use_info_a ? inst_info_b : inst_info_a);
@@ -266,7 +268,6 @@ public:
     // todo: have process inst ret if I should use this info or not
     // want to be able to skip syscalls for now
     InstInfo& _prior = (use_info_a ? inst_info_b : inst_info_a);
-    static bool should_be_valid = false;
     if(should_be_valid)
         assert(_prior.valid);
     should_be_valid = true;
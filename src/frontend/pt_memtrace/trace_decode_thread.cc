@@ -0,0 +1,91 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : frontend/pt_memtrace/trace_decode_thread.cc
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : The decoder thread of one core and the ring it fills. The
+ *                indices only grow; a slot is the index masked by the ring
+ *                size, which is rounded up to a power of two.
+ ***************************************************************************************/
+
+#include "frontend/pt_memtrace/trace_decode_thread.h"
+
+#define TRACE_DECODE_SPINS 1024  // polls before yielding the cpu
+
+TraceDecodeThread::TraceDecodeThread(int _proc_id, DecodeFunc _decode,
+                                     uint32_t _ring_size) :
+    proc_id_(_proc_id),
+    decode_(_decode), done_(false), stop_(false), head_(0), tail_(0) {
+  uint64_t size = 1;
+  while(size < _ring_size)
+    size <<= 1;
+  ring_.resize(size);
+  mask_   = size - 1;
+  thread_ = std::thread(&TraceDecodeThread::run, this);
+}
+
+TraceDecodeThread::~TraceDecodeThread() {
+  stop_.store(true);
+  thread_.join();
+}
+
+void TraceDecodeThread::run() {
+  uint64_t tail = 0;
+  while(true) {
+    for(uint32_t spins = 0; tail - head_.load(std::memory_order_acquire) ==
+                            ring_.size();
+        spins++) {
+      if(stop_.load(std::memory_order_relaxed))
+        return;
+      if(spins >= TRACE_DECODE_SPINS)
+        std::this_thread::yield();
+    }
+    Record& record = ring_[tail & mask_];
+    // The decode functions only write the instruction (and so its address)
+    // if there is one, which read() uses to tell the two kinds of end apart
+    record.pi.instruction_addr = 0;
+    int success                = decode_(proc_id_, &record.pi);
+    record.success             = success;
+    tail_.store(++tail, std::memory_order_release);
+    if(!success)
+      return;
+  }
+}
+
+int TraceDecodeThread::read(ctype_pin_inst* _pi) {
+  if(done_)
+    return 0;
+  uint64_t head = head_.load(std::memory_order_relaxed);
+  for(uint32_t spins = 0; tail_.load(std::memory_order_acquire) == head;
+      spins++) {
+    if(spins >= TRACE_DECODE_SPINS)
+      std::this_thread::yield();
+  }
+  const Record& record  = ring_[head & mask_];
+  int           success = record.success;
+  if(success || record.pi.instruction_addr)
+    *_pi = record.pi;
+  done_ = !success;
+  head_.store(head + 1, std::memory_order_release);
+  return success;
+}
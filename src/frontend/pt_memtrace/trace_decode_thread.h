@@ -0,0 +1,77 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : frontend/pt_memtrace/trace_decode_thread.h
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : Runs the trace decoding of one core on a thread of its own.
+ *                The thread calls the frontend's decode function ahead of the
+ *                simulation and leaves the decoded instructions in a bounded
+ *                single-producer/single-consumer ring, which the simulation
+ *                thread pops without taking a lock. The decode function must
+ *                not touch simulation state (stats, other cores).
+ ***************************************************************************************/
+
+#ifndef TRACE_DECODE_THREAD_H
+#define TRACE_DECODE_THREAD_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "ctype_pin_inst.h"
+
+class TraceDecodeThread {
+ public:
+  // Returns 0 at the end of the trace
+  using DecodeFunc = int (*)(int proc_id, ctype_pin_inst* pi);
+
+  // _ring_size is rounded up to a power of two
+  TraceDecodeThread(int _proc_id, DecodeFunc _decode, uint32_t _ring_size);
+  ~TraceDecodeThread();
+
+  // Same contract as the decode function: *_pi is left alone when the trace
+  // ends without an instruction
+  int read(ctype_pin_inst* _pi);
+
+ private:
+  struct Record {
+    ctype_pin_inst pi;
+    int            success;
+  };
+
+  void run();
+
+  int                 proc_id_;
+  DecodeFunc          decode_;
+  std::vector<Record> ring_;
+  uint64_t            mask_;
+  bool                done_;  // the consumer saw the end of the trace
+  std::atomic<bool>   stop_;
+  // Written by one side each, so they sit on separate cache lines
+  alignas(64) std::atomic<uint64_t> head_;  // next record to pop
+  alignas(64) std::atomic<uint64_t> tail_;  // next record to fill
+  std::thread thread_;
+};
+
+#endif
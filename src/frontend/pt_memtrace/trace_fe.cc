@@ -15,6 +15,7 @@
 #include <limits>
 
 #include "frontend/pt_memtrace/pt_fe.h"
+#include "frontend/compact_trace.h"
 #include "frontend/frontend_intf.h"
 
 /**************************************************************************************/
@@ -38,9 +39,10 @@ static ctype_pin_inst next_offpath_pi[MAX_NUM_PROCS];
 static bool            off_path_mode[MAX_NUM_PROCS] = {false};
 static uint64_t        off_path_addr[MAX_NUM_PROCS] = {0};
 static std::unordered_map<uint64_t, ctype_pin_inst> pc_to_inst;
+static Compact_Trace_Writer* compact_trace_writer[MAX_NUM_PROCS];
 
-extern uint64_t ins_id;
-extern uint64_t ins_id_fetched;
+extern uint64_t ins_id[MAX_NUM_PROCS];
+extern uint64_t ins_id_fetched[MAX_NUM_PROCS];
 
 void off_path_generate_inst(uns proc_id, uint64_t *off_path_addr, ctype_pin_inst *inst) {
   auto op_iter = pc_to_inst.find(*off_path_addr);
@@ -152,6 +154,19 @@ void assert_ctype_pin_inst_same(uns proc_id, ctype_pin_inst inst_a, ctype_pin_in
   }
 }
 
+/* reads the next on-path instruction, converting it to a compact trace if
+   COMPACT_TRACE_OUTPUT is set */
+static int ext_trace_read(uns proc_id) {
+  int success = false;
+  if (FRONTEND == FE_PT)
+    success = pt_trace_read(proc_id, &next_onpath_pi[proc_id]);
+  else if (FRONTEND == FE_MEMTRACE)
+    success = memtrace_trace_read(proc_id, &next_onpath_pi[proc_id]);
+  if (success && compact_trace_writer[proc_id])
+    compact_trace_writer[proc_id]->write(&next_onpath_pi[proc_id]);
+  return success;
+}
+
 void ext_trace_fetch_op(uns proc_id, Op* op) {
   if(uop_generator_get_bom(proc_id)) {
     if (!off_path_mode[proc_id]) {
@@ -167,11 +182,7 @@ void ext_trace_fetch_op(uns proc_id, Op* op) {
   if(uop_generator_get_eom(proc_id)) {
     if (!off_path_mode[proc_id]) {
 
-      int success = false;
-      if (FRONTEND == FE_PT)
-        success = pt_trace_read(proc_id, &next_onpath_pi[proc_id]);
-      else if (FRONTEND == FE_MEMTRACE)
-        success = memtrace_trace_read(proc_id, &next_onpath_pi[proc_id]);
+      int success = ext_trace_read(proc_id);
       if(!success) {
         trace_read_done[proc_id] = TRUE;
         reached_exit[proc_id]    = TRUE;
@@ -250,6 +261,11 @@ void ext_trace_retire(uns proc_id, uns64 inst_uid) {
   // retired.
 }
 
+Flag ext_trace_skip(uns proc_id, uns64 num) {
+  // The instructions are only known after decoding, so they are fetched
+  return FALSE;
+}
+
 Addr ext_trace_next_fetch_addr(uns proc_id) {
   return next_onpath_pi[proc_id].instruction_addr;
 }
@@ -258,22 +274,33 @@ void ext_trace_init() {
   memset(next_offpath_pi, 0, sizeof(next_offpath_pi));
   memset(next_onpath_pi, 0, sizeof(next_onpath_pi));
 
-  if (FRONTEND == FE_PT) {
-    pt_init();
+  if (COMPACT_TRACE_OUTPUT) {
     for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-      pt_trace_read(proc_id, &next_onpath_pi[proc_id]);
+      std::string name = std::string(COMPACT_TRACE_OUTPUT) + "." + std::to_string(proc_id);
+      compact_trace_writer[proc_id] = new Compact_Trace_Writer(name.c_str());
     }
   }
-  else if (FRONTEND == FE_MEMTRACE) {
+
+  if (FRONTEND == FE_PT)
+    pt_init();
+  else if (FRONTEND == FE_MEMTRACE)
     memtrace_init();
-    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-      memtrace_trace_read(proc_id, &next_onpath_pi[proc_id]);
-    }
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    ext_trace_read(proc_id);
   }
 }
 
 void ext_trace_done() {
-
+  if (FRONTEND == FE_PT)
+    pt_done();
+  else if (FRONTEND == FE_MEMTRACE)
+    memtrace_done();
+
+  /* the writers complete the compact traces when they are destroyed */
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    delete compact_trace_writer[proc_id];
+    compact_trace_writer[proc_id] = NULL;
+  }
 }
 
 // is also used to print footprint
@@ -756,8 +783,8 @@ void ext_trace_extract_basic_block_vectors() {
                       bb_identity_map);
 
         // caution that ins_id and ins_id_fetched is only for memtrace
-        ASSERT(proc_id, counts_dynamic.total_size == ins_id);
-        ASSERT(proc_id, counts_dynamic.fetched_size == ins_id_fetched);
+        ASSERT(proc_id, counts_dynamic.total_size == ins_id[proc_id]);
+        ASSERT(proc_id, counts_dynamic.fetched_size == ins_id_fetched[proc_id]);
 
         std::string bbv_output(TRACE_BBV_OUTPUT);
         std::string footprint_output(TRACE_FOOTPRINT_OUTPUT);
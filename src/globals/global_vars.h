@@ -44,7 +44,7 @@ extern Counter* unique_count_per_core;
 extern Counter* op_count;
 extern Counter* inst_count;
 extern Counter* inst_count_fetched;
-extern Counter  cycle_count;
+extern __thread Counter cycle_count;
 extern Counter  sim_time;
 extern Counter* uop_count;
 extern Counter* pret_inst_count;
@@ -71,7 +71,7 @@ extern int   mystatus_fd;
 extern Flag frontend_gated;
 extern uns  num_fetched_lowconf_brs;
 
-extern Hash_Table per_branch_stat;
+extern Hash_Table* per_branch_stat;
 extern Uop_Queue_Fill_Time uop_queue_fill_time;
 
 extern Flag roi_dump_began;
@@ -74,12 +74,10 @@
 
 /**************************************************************************************/
 
-Icache_Stage* ic = NULL;
+__thread Icache_Stage* ic = NULL;
 
 extern Cmp_Model              cmp_model;
 extern Memory*                mem;
-extern Rob_Stall_Reason       rob_stall_reason;
-extern Rob_Block_Issue_Reason rob_block_issue_reason;
 
 /**************************************************************************************/
 /* Local prototypes */
@@ -780,6 +778,36 @@ void update_icache_stage() {
 }
 
 
+/**************************************************************************************/
+/* icache_stage_is_idle: update_icache_stage() would not fetch because the ops
+ * fetched earlier have not moved on */
+
+Flag icache_stage_is_idle() {
+  return ic->sd.op_count || (UOP_CACHE_ENABLE && ic->uopc_sd.op_count);
+}
+
+
+/**************************************************************************************/
+/* icache_idle_cycles: what update_icache_stage() does over the given number of
+ * cycles in which icache_stage_is_idle() holds */
+
+void icache_idle_cycles(Counter cycles) {
+  uns width = UOP_CACHE_ENABLE ? UOPC_ISSUE_WIDTH : IC_ISSUE_WIDTH;
+
+  INC_STAT_EVENT(ic->proc_id, ICACHE_CYCLE, cycles);
+  INC_STAT_EVENT(ic->proc_id, ICACHE_CYCLE_ONPATH + ic->off_path, cycles);
+  if(ic->off_path)
+    INC_STAT_EVENT(exec->proc_id, ICACHE_STAGE_OFF_PATH, cycles);
+  INC_STAT_EVENT(ic->proc_id, INST_LOST_TOTAL, width * cycles);
+  INC_STAT_EVENT(ic->proc_id, FETCH_0_OPS, cycles);
+  INC_STAT_EVENT(ic->proc_id,
+                 INST_LOST_FULL_WINDOW + inst_lost_get_full_window_reason(),
+                 width * cycles);
+  if(!ic->off_path)
+    INC_STAT_EVENT(map->proc_id, ICACHE_STAGE_STALLED, cycles);
+}
+
+
 /**************************************************************************************/
 /* update_bf_uoc_stats: */
 
@@ -845,7 +873,8 @@ static inline void icache_process_ops(Stage_Data* cur_data) {
     /* add to sequential op list */
     add_to_seq_op_list(td, op);
 
-    ASSERT(ic->proc_id, td->seq_op_list.count <= op_pool_active_ops);
+    ASSERT(ic->proc_id,
+           td->seq_op_list.count <= op_pool_active_ops[ic->proc_id]);
 
     /* map the op based on true dependencies & set information in
      * op->oracle_info */
@@ -1289,12 +1318,12 @@ void wp_process_icache_fill(Icache_Data* line, Mem_Req* req) {
 /* inst_lost_get_full_window_reason(): */
 
 int32_t inst_lost_get_full_window_reason() {
-  if(rob_stall_reason != ROB_STALL_NONE) {
-    return rob_stall_reason;
+  if(node->rob_stall_reason != ROB_STALL_NONE) {
+    return node->rob_stall_reason;
   }
 
-  if(rob_block_issue_reason != ROB_BLOCK_ISSUE_NONE) {
-    return rob_block_issue_reason;
+  if(node->rob_block_issue_reason != ROB_BLOCK_ISSUE_NONE) {
+    return node->rob_block_issue_reason;
   }
 
   return 0;
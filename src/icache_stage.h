@@ -132,7 +132,7 @@ typedef struct Icache_Data_struct {
 /**************************************************************************************/
 /* External Variables */
 
-extern Icache_Stage* ic;
+extern __thread Icache_Stage* ic;
 
 /**************************************************************************************/
 /* Prototypes */
@@ -147,6 +147,8 @@ void recover_icache_stage(void);
 void redirect_icache_stage(void);
 void debug_icache_stage(void);
 void update_icache_stage(void);
+Flag icache_stage_is_idle(void);
+void icache_idle_cycles(Counter cycles);
 Flag icache_fill_line(Mem_Req*);
 void wp_process_icache_evicted(Icache_Data* line, Mem_Req* req, Addr* repl_line_addr);
 void wp_process_icache_hit(Icache_Data* line, Addr fetch_addr);
@@ -0,0 +1,211 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : idle_skip.c
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : Skipping the stage updates of cores stalled on memory.
+ *
+ * A core whose ROB head waits on a miss soon backs up all the way to fetch.
+ * From then on no op moves until the memory system answers, and each stage
+ * only counts the stall. Every stage reports that state through its
+ * *_is_idle() check and does that counting for any number of cycles in its
+ * *_idle_cycles() function, so idle_skip_core_cycle() can stand in for the
+ * stage updates of such a core.
+ *
+ * When every core is idle, the memory system reports how many cycles are left
+ * until its next event (memory_idle_cycles()). idle_skip_jump() then moves
+ * time straight there and has the cores and the memory system account for
+ * the cycles in between at once.
+ ***************************************************************************************/
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "bp/bp.h"
+#include "cmp_model.h"
+#include "freq.h"
+#include "idle_skip.h"
+#include "memory/memory.h"
+#include "prefetcher/fdip_new.h"
+#include "uop_queue_stage.h"
+
+#include "core.param.h"
+#include "debug/debug.param.h"
+#include "dvfs/dvfs.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+#include "prefetcher/l2l1pref.param.h"
+#include "prefetcher/pref.param.h"
+#include "statistics.h"
+
+/**************************************************************************************/
+/* Global variables */
+
+static Flag* idle_skip_core_idle; /* the last cycle of the core was skipped */
+static Flag  idle_skip_allowed;
+static Flag  idle_skip_jump_allowed;
+
+/**************************************************************************************/
+/* Static prototypes */
+
+static Flag    idle_skip_core_is_idle(uns proc_id);
+static void    idle_skip_core_idle_cycles(uns proc_id, Counter cycles);
+static Counter idle_skip_jump_end_time(Counter* core_cycles);
+
+/**************************************************************************************/
+/* idle_skip_reconfigure: */
+
+void idle_skip_reconfigure() {
+  /* Features that act on every cycle of a stalled core in ways the stages do
+     not account for in their *_idle_cycles() functions */
+  idle_skip_allowed = SKIP_IDLE_CYCLES && !DVFS_ON && !PERF_PRED_ENABLE &&
+                      !PIPEVIEW && !MEMVIEW && !EIP_ENABLE && !DJOLT_ENABLE &&
+                      !FNLMMA_ENABLE && !FDIP_ADJUSTABLE_FTQ &&
+                      !FDIP_BP_CONFIDENCE && !FDIP_BLOOM_FILTER &&
+                      !STREAM_PREFETCH_ON && !L2WAY_PREF && !L2MARKV_PREF_ON;
+  /* cache partitioning acts on the cycles a jump would leave out */
+  idle_skip_jump_allowed = idle_skip_allowed && !L1_PART_ON;
+}
+
+/**************************************************************************************/
+/* idle_skip_init: */
+
+void idle_skip_init() {
+  if(!SKIP_IDLE_CYCLES)
+    return;
+  idle_skip_reconfigure();
+  idle_skip_core_idle = (Flag*)calloc(NUM_CORES, sizeof(Flag));
+}
+
+/**************************************************************************************/
+/* idle_skip_core_is_idle: no stage of proc_id can move an op this cycle, so
+ * only an event from the memory system can end the stall */
+
+static Flag idle_skip_core_is_idle(uns proc_id) {
+  return bp_recovery_info->recovery_cycle == MAX_CTR &&
+         bp_recovery_info->redirect_cycle == MAX_CTR &&
+         node_stage_is_idle(map->last_sd) && exec_stage_is_idle(&node->sd) &&
+         dcache_stage_is_idle(&exec->sd) &&
+         map_stage_is_idle(dec->last_sd, cmp_map_stage_uop_cache_src()) &&
+         uop_queue_stage_is_idle(&ic->uopc_sd) &&
+         decode_stage_is_idle(&ic->sd) && decoupled_fe_is_idle() &&
+         fdip_ftq_drained(proc_id) && icache_stage_is_idle();
+}
+
+/**************************************************************************************/
+/* idle_skip_core_idle_cycles: what the stage updates of proc_id do over the
+ * given number of idle cycles, in the order cmp_core_cycle() runs them */
+
+static void idle_skip_core_idle_cycles(uns proc_id, Counter cycles) {
+  INC_STAT_EVENT(proc_id, IDLE_SKIP_CYCLES, cycles);
+  exec_idle_cycles(&node->sd, cycles);
+  node_idle_cycles(map->last_sd, cycles);
+  map_idle_cycles(dec->last_sd, cmp_map_stage_uop_cache_src(), cycles);
+  uop_queue_idle_cycles(&ic->uopc_sd, cycles);
+  decode_idle_cycles(&ic->sd, cycles);
+  decoupled_fe_idle_cycles(cycles);
+  fdip_idle_cycles(proc_id, cycles);
+  icache_idle_cycles(cycles);
+}
+
+/**************************************************************************************/
+/* idle_skip_core_cycle: */
+
+Flag idle_skip_core_cycle(uns proc_id) {
+  if(!idle_skip_allowed)
+    return FALSE;
+  idle_skip_core_idle[proc_id] = idle_skip_core_is_idle(proc_id);
+  if(idle_skip_core_idle[proc_id])
+    idle_skip_core_idle_cycles(proc_id, 1);
+  return idle_skip_core_idle[proc_id];
+}
+
+/**************************************************************************************/
+/* idle_skip_jump_end_time: the time of the first cycle after which a jump
+ * could miss something, or 0 if a jump is not possible now. core_cycles gets
+ * the cycle count of each core. */
+
+static Counter idle_skip_jump_end_time(Counter* core_cycles) {
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    if(!idle_skip_core_idle[proc_id])
+      return 0;
+  }
+
+  /* the DRAM's next event */
+  Counter mem_cycles = memory_idle_cycles();
+  if(mem_cycles == 0)
+    return 0;
+  Counter end_time = freq_cycle_start_time(
+    FREQ_DOMAIN_MEMORY, freq_cycle_count(FREQ_DOMAIN_MEMORY) + mem_cycles + 1);
+
+  /* the main loop checks forward progress on these core 0 cycles */
+  core_cycles[0] = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+  if(core_cycles[0] % FORWARD_PROGRESS_INTERVAL == 0)
+    return 0;
+  end_time = MIN2(end_time, freq_cycle_start_time(
+                              FREQ_DOMAIN_CORES[0],
+                              (core_cycles[0] / FORWARD_PROGRESS_INTERVAL + 1) *
+                                FORWARD_PROGRESS_INTERVAL));
+
+  /* every core must still be idle on its next cycle */
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    core_cycles[proc_id] = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
+    cycle_count          = core_cycles[proc_id] + 1;
+    set_bp_recovery_info(&cmp_model.bp_recovery_info[proc_id]);
+    cmp_set_all_stages(proc_id);
+    if(!idle_skip_core_is_idle(proc_id))
+      return 0;
+  }
+  return end_time;
+}
+
+/**************************************************************************************/
+/* idle_skip_jump: */
+
+void idle_skip_jump() {
+  if(!idle_skip_allowed || !idle_skip_jump_allowed)
+    return;
+
+  Counter core_cycles[MAX_NUM_PROCS];
+  Counter end_time = idle_skip_jump_end_time(core_cycles);
+  if(end_time) {
+    Counter l1_cycles  = freq_cycle_count(FREQ_DOMAIN_L1);
+    Counter mem_cycles = freq_cycle_count(FREQ_DOMAIN_MEMORY);
+    freq_skip_until(end_time);
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+      Counter cycles = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]) -
+                       core_cycles[proc_id];
+      if(cycles) {
+        cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
+        cmp_set_all_stages(proc_id);
+        idle_skip_core_idle_cycles(proc_id, cycles);
+      }
+    }
+    skip_idle_memory(freq_cycle_count(FREQ_DOMAIN_L1) - l1_cycles,
+                     freq_cycle_count(FREQ_DOMAIN_MEMORY) - mem_cycles);
+  }
+  cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+}
@@ -0,0 +1,56 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : idle_skip.h
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : Skipping the stage updates of cores stalled on memory
+ ***************************************************************************************/
+
+#ifndef __IDLE_SKIP_H__
+#define __IDLE_SKIP_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Allocate the per-core state (called once from cmp_init) */
+void idle_skip_init(void);
+
+/* Rechecks which parameters allow skipping (called after a sweep child
+   overrides some) */
+void idle_skip_reconfigure(void);
+
+/* Called after the stages of proc_id are set. Returns TRUE if no stage of
+   the core can move an op this cycle; the stages have then counted the idle
+   cycle and the caller must not update them. */
+Flag idle_skip_core_cycle(uns proc_id);
+
+/* Called before time advances. If every core is idle and the memory system
+   waits on the DRAM, skips the cycles of all frequency domains up to the next
+   one that can change anything. */
+void idle_skip_jump(void);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __IDLE_SKIP_H__ */
@@ -27,6 +27,11 @@
  ***************************************************************************************/
 
 #include <stdlib.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #include "debug/debug_macros.h"
 #include "globals/assert.h"
 #include "globals/global_defs.h"
@@ -39,6 +44,7 @@
 #include "debug/debug.param.h"
 #include "general.param.h"
 #include "libs/cache_lib.h"
+#include "libs/cache_repl_spec.h"
 #include "memory/memory.param.h"
 
 // DeleteMe
@@ -58,6 +64,11 @@ static inline uns  cache_index(Cache* cache, Addr addr, Addr* tag,
 static inline void update_repl_policy(Cache*, Cache_Entry*, uns, uns, Flag);
 static inline Cache_Entry* find_repl_entry(Cache*, uns8, uns, uns*);
 
+/* for the structure-of-arrays tag store */
+static void         init_tag_store(Cache*);
+static inline void  tag_store_update(Cache*, uns, Cache_Entry*);
+static inline uns64 tag_store_match(Cache*, uns, Addr);
+
 /* for ideal replacement */
 static inline void*        access_unsure_lines(Cache*, uns, Addr, Flag);
 static inline Cache_Entry* insert_sure_line(Cache*, uns, Addr);
@@ -87,6 +98,73 @@ uns ext_cache_index(Cache* cache, Addr addr, Addr* tag, Addr* line_addr) {
   return cache_index(cache, addr, tag, line_addr);
 }
 
+/**************************************************************************************/
+/* init_tag_store: the ideal policies move lines between the entries and
+ * their side structures, so they keep using the entries for lookups */
+
+static void init_tag_store(Cache* cache) {
+  cache->tag_store       = NULL;
+  cache->tag_store_valid = NULL;
+  if(cache->assoc > 64 || cache->repl_policy == REPL_IDEAL ||
+     cache->repl_policy == REPL_SHADOW_IDEAL ||
+     cache->repl_policy == REPL_IDEAL_STORAGE)
+    return;
+
+  cache->tag_store = (Addr*)calloc(cache->num_sets * cache->assoc,
+                                   sizeof(Addr));
+  cache->tag_store_valid = (uns64*)calloc(cache->num_sets, sizeof(uns64));
+}
+
+/**************************************************************************************/
+/* tag_store_update: called whenever the tag or valid bit of a line in the
+ * entries changes */
+
+static inline void tag_store_update(Cache* cache, uns set, Cache_Entry* line) {
+  if(!cache->tag_store)
+    return;
+  uns way = line - cache->entries[set];
+  ASSERT(0, way < cache->assoc);
+  cache->tag_store[set * cache->assoc + way] = line->tag;
+  if(line->valid)
+    cache->tag_store_valid[set] |= 1ULL << way;
+  else
+    cache->tag_store_valid[set] &= ~(1ULL << way);
+}
+
+/**************************************************************************************/
+/* tag_store_match: bit mask of the valid ways of the set holding tag. All ways
+ * are compared at once with AVX2 (4 tags) or SSE2 (2 tags) when the build
+ * enables them. */
+
+static inline uns64 tag_store_match(Cache* cache, uns set, Addr tag) {
+  const Addr* tags  = &cache->tag_store[set * cache->assoc];
+  uns64       match = 0;
+  uns         ii    = 0;
+
+#if defined(__AVX2__)
+  const __m256i key = _mm256_set1_epi64x((long long)tag);
+  for(; ii + 4 <= cache->assoc; ii += 4) {
+    __m256i eq = _mm256_cmpeq_epi64(
+      _mm256_loadu_si256((const __m256i*)&tags[ii]), key);
+    match |= (uns64)_mm256_movemask_pd(_mm256_castsi256_pd(eq)) << ii;
+  }
+#elif defined(__SSE2__)
+  const __m128i key = _mm_set1_epi64x((long long)tag);
+  for(; ii + 2 <= cache->assoc; ii += 2) {
+    /* SSE2 has no 64-bit compare: both 32-bit halves must be equal */
+    __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)&tags[ii]),
+                                 key);
+    eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+    match |= (uns64)_mm_movemask_pd(_mm_castsi128_pd(eq)) << ii;
+  }
+#endif
+  for(; ii < cache->assoc; ii++)
+    match |= (uns64)(tags[ii] == tag) << ii;
+
+  return match & cache->tag_store_valid[set];
+}
+
+
 
 /**************************************************************************************/
 /* init_cache: */
@@ -207,9 +285,35 @@ void init_cache(Cache* cache, const char* name, uns cache_size, uns assoc,
     }
   }
 
+  init_tag_store(cache);
+  cache->repl_spec       = cache_repl_spec_lookup(cache);
   cache->tag_incl_offset = FALSE;
 }
 
+/**************************************************************************************/
+/* cache_access_hit: */
+
+static inline void* cache_access_hit(Cache* cache, uns set, uns way,
+                                     Flag update_repl) {
+  Cache_Entry* line = &cache->entries[set][way];
+
+  /* update replacement state if necessary */
+  ASSERT(0, line->data);
+  DEBUG(0, "Found line in cache '%s' at (set %u, way %u, base 0x%s)\n",
+        cache->name, set, way, hexstr64s(line->base));
+
+  if(update_repl) {
+    if(line->pref) {
+      line->pref = FALSE;
+    }
+    cache->num_demand_access++;
+    update_repl_policy(cache, line, set, way, FALSE);
+    DEBUG(0, "(%s, %d) [0x%x, 0x%x]: in access\n\n", cache->name, cache->repl_policy, cache->num_sets, cache->assoc);
+  }
+
+  return line->data;
+}
+
 /**************************************************************************************/
 /* cache_access: Does a cache lookup based on the address.  Returns a pointer
  * to the cache line data if it is found.  */
@@ -220,6 +324,9 @@ void* cache_access(Cache* cache, Addr addr, Addr* line_addr, Flag update_repl) {
   uns  ii;
   void* line_data = NULL;
 
+  if(cache->repl_spec)
+    return cache->repl_spec->access(cache, set, tag, update_repl);
+
   if (cache->repl_policy >= REPL_VOID)
     return cache_access_strategy(cache, addr, line_addr, update_repl);
 
@@ -227,25 +334,16 @@ void* cache_access(Cache* cache, Addr addr, Addr* line_addr, Flag update_repl) {
     return access_ideal_storage(cache, set, tag, addr);
   }
 
-  for(ii = 0; ii < cache->assoc; ii++) {
-    Cache_Entry* line = &cache->entries[set][ii];
-
-    if(line->valid && line->tag == tag) {
-      /* update replacement state if necessary */
-      ASSERT(0, line->data);
-      DEBUG(0, "Found line in cache '%s' at (set %u, way %u, base 0x%s)\n",
-            cache->name, set, ii, hexstr64s(line->base));
-
-      if(update_repl) {
-        if(line->pref) {
-          line->pref = FALSE;
-        }
-        cache->num_demand_access++;
-        update_repl_policy(cache, line, set, ii, FALSE);
-        DEBUG(0, "(%s, %d) [0x%x, 0x%x]: in access\n\n", cache->name, cache->repl_policy, cache->num_sets, cache->assoc);
-      }
-
-      line_data = line->data;
+  if(cache->tag_store) {
+    for(uns64 match = tag_store_match(cache, set, tag); match;
+        match &= match - 1)
+      line_data = cache_access_hit(cache, set, __builtin_ctzll(match),
+                                   update_repl);
+  } else {
+    for(ii = 0; ii < cache->assoc; ii++) {
+      Cache_Entry* line = &cache->entries[set][ii];
+      if(line->valid && line->tag == tag)
+        line_data = cache_access_hit(cache, set, ii, update_repl);
     }
   }
 
@@ -340,13 +438,17 @@ void* cache_insert_replpos(Cache* cache, uns8 proc_id, Addr addr,
   new_line->base             = *line_addr;
   new_line->last_access_time = sim_time;  // FIXME: this fixes valgrind warnings
                                           // in update_prf_
+  tag_store_update(cache, set, new_line);
   new_line->pref = isPrefetch;
 
   new_line->pw_start_addr = addr; // only means anything for uop cache
 
   switch(insert_repl_policy) {
     case INSERT_REPL_DEFAULT:
-      update_repl_policy(cache, new_line, set, repl_index, TRUE);
+      if(cache->repl_spec)
+        cache->repl_spec->insert(cache, proc_id, set, repl_index);
+      else
+        update_repl_policy(cache, new_line, set, repl_index, TRUE);
       DEBUG(0, "(%s, %d) [0x%x, 0x%x]: in insert\n\n", cache->name, cache->repl_policy, cache->num_sets, cache->assoc);
       break;
     case INSERT_REPL_LRU:
@@ -444,12 +546,23 @@ void cache_invalidate(Cache* cache, Addr addr, Addr* line_addr) {
   uns  set = cache_index(cache, addr, &tag, line_addr);
   uns  ii;
 
-  for(ii = 0; ii < cache->assoc; ii++) {
-    Cache_Entry* line = &cache->entries[set][ii];
-    if(line->tag == tag && line->valid) {
-      line->tag   = 0;
-      line->valid = FALSE;
-      line->base  = 0;
+  if(cache->tag_store) {
+    for(uns64 match = tag_store_match(cache, set, tag); match;
+        match &= match - 1) {
+      Cache_Entry* line = &cache->entries[set][__builtin_ctzll(match)];
+      line->tag         = 0;
+      line->valid       = FALSE;
+      line->base        = 0;
+      tag_store_update(cache, set, line);
+    }
+  } else {
+    for(ii = 0; ii < cache->assoc; ii++) {
+      Cache_Entry* line = &cache->entries[set][ii];
+      if(line->tag == tag && line->valid) {
+        line->tag   = 0;
+        line->valid = FALSE;
+        line->base  = 0;
+      }
     }
   }
 
@@ -495,6 +608,9 @@ void* get_next_repl_line(Cache* cache, uns8 proc_id, Addr addr,
 Cache_Entry* find_repl_entry(Cache* cache, uns8 proc_id, uns set, uns* way) {
   int ii;
 
+  if(cache->repl_spec)
+    return cache->repl_spec->evict(cache, proc_id, set, way, TRUE);
+
   if (cache->repl_policy >= REPL_VOID)
     return cache_evict_strategy(cache, proc_id, set, way);
 
@@ -1100,6 +1216,7 @@ void* cache_insert_lru(Cache* cache, uns8 proc_id, Addr addr, Addr* line_addr,
   new_line->valid   = TRUE;
   new_line->tag     = tag;
   new_line->base    = *line_addr;
+  tag_store_update(cache, set, new_line);
   update_repl_policy(cache, new_line, set, repl_index, TRUE);
   if(cache->repl_policy == REPL_TRUE_LRU)
     new_line->last_access_time = 137;
@@ -1147,6 +1264,75 @@ void* cache_insert_lru(Cache* cache, uns8 proc_id, Addr addr, Addr* line_addr,
   return new_line->data;
 }
 
+/**************************************************************************************/
+/* cache_state_io: reads or writes the tag store, replacement state and line
+ * data of a cache. The line data is copied as raw bytes, so it must not hold
+ * pointers. Policies that keep extra per-set structures are not supported. */
+
+static void cache_state_field(void* ptr, size_t size, FILE* file, Flag write,
+                              const Cache* cache) {
+  size_t done = write ? fwrite(ptr, size, 1, file) : fread(ptr, size, 1, file);
+  if(size && done != 1)
+    FATAL_ERROR(0, "Could not %s warm state of cache '%s'\n",
+                write ? "write" : "read", cache->name);
+}
+
+static void cache_state_io(Cache* cache, FILE* file, Flag write) {
+  if(cache->repl_policy >= REPL_VOID || cache->repl_policy == REPL_IDEAL ||
+     cache->repl_policy == REPL_SHADOW_IDEAL ||
+     cache->repl_policy == REPL_IDEAL_STORAGE ||
+     cache->repl_policy == REPL_PARTITION)
+    FATAL_ERROR(0, "Cache '%s': replacement policy %d has no warm state "
+                   "support\n", cache->name, cache->repl_policy);
+
+  uns geometry[5] = {cache->num_sets, cache->assoc, cache->line_size,
+                     cache->data_size, cache->repl_policy};
+  uns file_geometry[5];
+  memcpy(file_geometry, geometry, sizeof(geometry));
+  cache_state_field(file_geometry, sizeof(file_geometry), file, write, cache);
+  if(memcmp(file_geometry, geometry, sizeof(geometry)))
+    FATAL_ERROR(0, "Cache '%s' does not match the geometry of the warm state "
+                   "(sets:%u assoc:%u line:%u data:%u repl:%u)\n",
+                cache->name, file_geometry[0], file_geometry[1],
+                file_geometry[2], file_geometry[3], file_geometry[4]);
+
+  cache_state_field(cache->repl_ctrs, sizeof(uns) * cache->num_sets, file,
+                    write, cache);
+  for(uns ii = 0; ii < cache->num_sets; ii++) {
+    for(uns jj = 0; jj < cache->assoc; jj++) {
+      Cache_Entry* line = &cache->entries[ii][jj];
+      cache_state_field(&line->proc_id, sizeof(line->proc_id), file, write,
+                        cache);
+      cache_state_field(&line->valid, sizeof(line->valid), file, write, cache);
+      cache_state_field(&line->tag, sizeof(line->tag), file, write, cache);
+      cache_state_field(&line->base, sizeof(line->base), file, write, cache);
+      cache_state_field(&line->last_access_time, sizeof(line->last_access_time),
+                        file, write, cache);
+      cache_state_field(&line->insertion_time, sizeof(line->insertion_time),
+                        file, write, cache);
+      cache_state_field(&line->pref, sizeof(line->pref), file, write, cache);
+      cache_state_field(&line->dirty, sizeof(line->dirty), file, write, cache);
+      cache_state_field(&line->pw_start_addr, sizeof(line->pw_start_addr),
+                        file, write, cache);
+      cache_state_field(&line->reference_val, sizeof(line->reference_val),
+                        file, write, cache);
+      cache_state_field(&line->outcome, sizeof(line->outcome), file, write,
+                        cache);
+      if(cache->data_size)
+        cache_state_field(line->data, cache->data_size, file, write, cache);
+      tag_store_update(cache, ii, line);
+    }
+  }
+}
+
+void cache_write_state(Cache* cache, FILE* file) {
+  cache_state_io(cache, file, TRUE);
+}
+
+void cache_read_state(Cache* cache, FILE* file) {
+  cache_state_io(cache, file, FALSE);
+}
+
 /**************************************************************************************/
 /* reset cache: A function that initializes all lines to invalid state*/
 
@@ -1157,6 +1343,8 @@ void reset_cache(Cache* cache) {
     for(jj = 0; jj < cache->assoc; jj++) {
       cache->entries[ii][jj].valid = FALSE;
     }
+    if(cache->tag_store)
+      cache->tag_store_valid[ii] = 0;
   }
 }
 
@@ -1338,13 +1526,20 @@ void *cache_insert_strategy(Cache* cache, uns8 proc_id, Addr addr, Addr* line_ad
   DEBUG(0, "%s, %d: Insert Strategy\n", cache->name, cache->repl_policy);
 
   // update_evict -> action_repl -> update_insert
-  new_line = repl_policy_func_table[policy].update_evict(cache, proc_id, set, &repl_index, NULL, FALSE); // External func also directly call it
+  if(cache->repl_spec)
+    new_line = cache->repl_spec->evict(cache, proc_id, set, &repl_index, FALSE);
+  else
+    new_line = repl_policy_func_table[policy].update_evict(cache, proc_id, set, &repl_index, NULL, FALSE); // External func also directly call it
   if (new_line->valid)
     *repl_line_addr = new_line->base;
   else
     *repl_line_addr = 0;
   repl_policy_func_table[policy].action_repl(cache, new_line, proc_id, tag, line_addr, repl_line_addr);
-  repl_policy_func_table[policy].update_insert(cache, proc_id, set, repl_index, NULL);
+  tag_store_update(cache, set, new_line);
+  if(cache->repl_spec)
+    cache->repl_spec->insert(cache, proc_id, set, repl_index);
+  else
+    repl_policy_func_table[policy].update_insert(cache, proc_id, set, repl_index, NULL);
 
   return new_line->data;
 }
@@ -1360,6 +1555,9 @@ void *cache_access_strategy(Cache* cache, Addr addr, Addr* line_addr, Flag updat
   uns  ii;
   int policy;
 
+  if(cache->repl_spec)
+    return cache->repl_spec->access(cache, set, tag, update_repl);
+
   // Get the selected strategy (policy)
   policy = cache_get_policy_index(cache->repl_policy);
   if (policy == -1)
@@ -1367,6 +1565,16 @@ void *cache_access_strategy(Cache* cache, Addr addr, Addr* line_addr, Flag updat
 
   DEBUG(0, "%s, %d: Access Strategy\n", cache->name, cache->repl_policy);
 
+  if(cache->tag_store) {
+    uns64 match = tag_store_match(cache, set, tag);
+    if(!match)
+      return NULL;
+    ii = __builtin_ctzll(match);
+    if(update_repl)
+      repl_policy_func_table[policy].update_hit(cache, set, ii, NULL);
+    return cache->entries[set][ii].data;
+  }
+
   for(ii = 0; ii < cache->assoc; ii++) {
     Cache_Entry* line = &cache->entries[set][ii];
 
@@ -1390,6 +1598,9 @@ Cache_Entry* cache_evict_strategy(Cache* cache, uns8 proc_id, uns set, uns* way)
   Cache_Entry* new_line;
   int policy;
 
+  if(cache->repl_spec)
+    return cache->repl_spec->evict(cache, proc_id, set, way, TRUE);
+
   policy = cache_get_policy_index(cache->repl_policy);
   if (policy == -1)
     return NULL;
@@ -1448,6 +1659,9 @@ void general_action_init(Cache* cache, const char* name, uns cache_size, uns ass
         cache->entries[ii][jj].data = INIT_CACHE_DATA_VALUE;
     }
   }
+
+  init_tag_store(cache);
+  cache->repl_spec = cache_repl_spec_lookup(cache);
 }
 
 void general_action_repl(Cache* cache, Cache_Entry* new_line, uns8 proc_id, Addr tag,
@@ -1594,7 +1808,7 @@ Cache_Entry* nru_update_evict(Cache* cache, uns8 proc_id, uns set, uns* way, voi
 
 /**************************************************************************************/
 /* RRIP: SRRIP, BRRIP, DRRIP */
-const static uns8 RRIP_M = 2;
+const static uns8 RRIP_M = CACHE_REPL_RRIP_M;
 const static uns8 RRIP_DISTANT_VAL = (1 << RRIP_M) - 1;
 
 /**************************************************************************************/
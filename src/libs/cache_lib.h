@@ -29,6 +29,7 @@
 #ifndef __CACHE_LIB_H__
 #define __CACHE_LIB_H__
 
+#include <stdio.h>
 #include "globals/global_defs.h"
 #include "libs/list_lib.h"
 
@@ -125,6 +126,15 @@ typedef struct Cache_struct {
   Cache_Entry** entries;   /* A dynamically allocated array of all
                               of the cache entries. The array is
                               two-dimensional, sets are row major. */
+  Addr*  tag_store;       /* Structure-of-arrays copy of the entry tags
+                             (num_sets * assoc, sets are row major) used
+                             for lookups. NULL if the policy keeps lines
+                             outside of the entries (ideal policies). */
+  uns64* tag_store_valid; /* per set bit mask of the valid ways */
+  const struct Cache_Repl_Spec_struct* repl_spec; /* lookup and replacement
+                                                    code specialized for the
+                                                    policy and associativity
+                                                    (NULL: generic code) */
   List* unsure_lists;      /* A linked list for each set in the cache that
                               is used when simulating ideal replacement policies */
   Flag perfect;            /* is the cache perfect (for henry mem system) */
@@ -200,6 +210,8 @@ void* shadow_cache_insert(Cache* cache, uns set, Addr tag, Addr base);
 void* access_shadow_lines(Cache* cache, uns set, Addr tag);
 void* access_ideal_storage(Cache* cache, uns set, Addr tag, Addr addr);
 void  reset_cache(Cache*);
+void  cache_write_state(Cache*, FILE*);
+void  cache_read_state(Cache*, FILE*);
 int   cache_find_pos_in_lru_stack(Cache* cache, uns8 proc_id, Addr addr,
                                   Addr* line_addr);
 void  set_partition_allocate(Cache* cache, uns8 proc_id, uns num_ways);
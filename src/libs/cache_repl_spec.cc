@@ -0,0 +1,273 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/cache_repl_spec.cc
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : cache_lib lookups and replacement updates as templates over
+ *                the replacement policy and the associativity. Each
+ *                instantiation compares the tag store with a fixed-length loop
+ *                and has the policy code inlined, replacing the switch in
+ *                update_repl_policy()/find_repl_entry() and the calls through
+ *                repl_policy_func_table. The state they work on is the regular
+ *                Cache, so results are identical to the generic code.
+ ***************************************************************************************/
+
+extern "C" {
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+
+#include "libs/cache_lib.h"
+#include "libs/cache_repl_spec.h"
+}
+
+/**************************************************************************************/
+/* Macros */
+
+#define RRIP_DISTANT_VAL ((1 << CACHE_REPL_RRIP_M) - 1)
+
+/**************************************************************************************/
+/* spec_match: valid ways of the set that hold tag */
+
+template <uns ASSOC>
+static inline uns64 spec_match(const Cache* cache, uns set, Addr tag) {
+  const Addr* tags  = &cache->tag_store[set * ASSOC];
+  uns64       match = 0;
+  for(uns ii = 0; ii < ASSOC; ii++)
+    match |= (uns64)(tags[ii] == tag) << ii;
+  return match & cache->tag_store_valid[set];
+}
+
+/**************************************************************************************/
+/* spec_rrip_evict: srrip_update_evict() */
+
+template <uns ASSOC>
+static inline Cache_Entry* spec_rrip_evict(Cache* cache, uns set, uns* way) {
+  Cache_Entry* entries = cache->entries[set];
+  while(TRUE) {
+    for(uns ii = 0; ii < ASSOC; ii++) {
+      if(!entries[ii].valid || entries[ii].reference_val == RRIP_DISTANT_VAL) {
+        *way = ii;
+        return &entries[ii];
+      }
+    }
+    for(uns ii = 0; ii < ASSOC; ii++)
+      entries[ii].reference_val++;
+  }
+}
+
+/**************************************************************************************/
+/* Repl_Spec: one specialization per supported policy */
+
+template <Repl_Policy POLICY, uns ASSOC>
+struct Repl_Spec;
+
+/* legacy true LRU (cache_access, find_repl_entry and update_repl_policy) */
+template <uns ASSOC>
+struct Repl_Spec<REPL_TRUE_LRU, ASSOC> {
+  /* cache_access() updates every matching way and returns the last one */
+  static void* access(Cache* cache, uns set, Addr tag, Flag update_repl) {
+    void* data = NULL;
+    for(uns64 match = spec_match<ASSOC>(cache, set, tag); match;
+        match &= match - 1) {
+      Cache_Entry* line = &cache->entries[set][__builtin_ctzll(match)];
+      ASSERT(0, line->data);
+      if(update_repl) {
+        line->pref = FALSE;
+        cache->num_demand_access++;
+        line->last_access_time = sim_time;
+      }
+      data = line->data;
+    }
+    return data;
+  }
+
+  static Cache_Entry* evict(Cache* cache, uns8 proc_id, uns set, uns* way,
+                            Flag if_external) {
+    Cache_Entry* entries  = cache->entries[set];
+    uns          lru_ind  = 0;
+    Counter      lru_time = MAX_CTR;
+    for(uns ii = 0; ii < ASSOC; ii++) {
+      if(!entries[ii].valid) {
+        lru_ind = ii;
+        break;
+      }
+      if(entries[ii].last_access_time < lru_time) {
+        lru_ind  = ii;
+        lru_time = entries[ii].last_access_time;
+      }
+    }
+    *way = lru_ind;
+    return &entries[lru_ind];
+  }
+
+  static void insert(Cache* cache, uns8 proc_id, uns set, uns way) {
+    cache->entries[set][way].last_access_time = sim_time;
+  }
+};
+
+/* strategy policies: cache_access_strategy() stops at the first match */
+template <Repl_Policy POLICY, uns ASSOC>
+struct Repl_Spec_Strategy {
+  static void* access(Cache* cache, uns set, Addr tag, Flag update_repl) {
+    uns64 match = spec_match<ASSOC>(cache, set, tag);
+    if(!match)
+      return NULL;
+    uns way = __builtin_ctzll(match);
+    if(update_repl)
+      Repl_Spec<POLICY, ASSOC>::hit(cache, set, way);
+    return cache->entries[set][way].data;
+  }
+};
+
+template <uns ASSOC>
+struct Repl_Spec<REPL_LRU_REF, ASSOC>
+    : Repl_Spec_Strategy<REPL_LRU_REF, ASSOC> {
+  static void hit(Cache* cache, uns set, uns way) {
+    Cache_Entry* entries  = cache->entries[set];
+    uns8         ref_orig = entries[way].reference_val;
+    entries[way].reference_val = 0;
+    for(uns ii = 0; ii < ASSOC; ii++) {
+      if(ii != way && entries[ii].valid && entries[ii].reference_val < ref_orig)
+        entries[ii].reference_val++;
+    }
+  }
+
+  static Cache_Entry* evict(Cache* cache, uns8 proc_id, uns set, uns* way,
+                            Flag if_external) {
+    Cache_Entry* entries    = cache->entries[set];
+    uns8         oldest_ref = 0;
+    for(uns ii = 0; ii < ASSOC; ii++) {
+      if(!entries[ii].valid) {
+        *way = ii;
+        break;
+      }
+      if(entries[ii].reference_val > oldest_ref) {
+        *way       = ii;
+        oldest_ref = entries[ii].reference_val;
+      }
+    }
+    return &entries[*way];
+  }
+
+  static void insert(Cache* cache, uns8 proc_id, uns set, uns way) {
+    Cache_Entry* entries       = cache->entries[set];
+    entries[way].reference_val = 0;
+    for(uns ii = 0; ii < ASSOC; ii++) {
+      if(ii != way && entries[ii].valid)
+        entries[ii].reference_val++;
+    }
+  }
+};
+
+template <uns ASSOC>
+struct Repl_Spec<REPL_SRRIP, ASSOC> : Repl_Spec_Strategy<REPL_SRRIP, ASSOC> {
+  static void hit(Cache* cache, uns set, uns way) {
+    cache->entries[set][way].reference_val = 0;
+  }
+
+  static Cache_Entry* evict(Cache* cache, uns8 proc_id, uns set, uns* way,
+                            Flag if_external) {
+    return spec_rrip_evict<ASSOC>(cache, set, way);
+  }
+
+  static void insert(Cache* cache, uns8 proc_id, uns set, uns way) {
+    cache->entries[set][way].reference_val = RRIP_DISTANT_VAL - 1;
+  }
+};
+
+/* the set dueling of DRRIP insertion stays in drrip_update_insert() */
+template <uns ASSOC>
+struct Repl_Spec<REPL_DRRIP, ASSOC> : Repl_Spec_Strategy<REPL_DRRIP, ASSOC> {
+  static void hit(Cache* cache, uns set, uns way) {
+    cache->entries[set][way].reference_val = 0;
+  }
+
+  static Cache_Entry* evict(Cache* cache, uns8 proc_id, uns set, uns* way,
+                            Flag if_external) {
+    cache->miss_count[set]++;
+    return spec_rrip_evict<ASSOC>(cache, set, way);
+  }
+
+  static void insert(Cache* cache, uns8 proc_id, uns set, uns way) {
+    drrip_update_insert(cache, proc_id, set, way, NULL);
+  }
+};
+
+/* SHiP keeps its signature table in cache_lib.c; only the lookup is
+   specialized */
+template <uns ASSOC>
+struct Repl_Spec<REPL_SHIP, ASSOC> : Repl_Spec_Strategy<REPL_SHIP, ASSOC> {
+  static void hit(Cache* cache, uns set, uns way) {
+    ship_update_hit(cache, set, way, NULL);
+  }
+
+  static Cache_Entry* evict(Cache* cache, uns8 proc_id, uns set, uns* way,
+                            Flag if_external) {
+    return ship_update_evict(cache, proc_id, set, way, NULL, if_external);
+  }
+
+  static void insert(Cache* cache, uns8 proc_id, uns set, uns way) {
+    ship_update_insert(cache, proc_id, set, way, NULL);
+  }
+};
+
+/**************************************************************************************/
+/* Instantiations */
+
+template <Repl_Policy POLICY, uns ASSOC>
+static constexpr Cache_Repl_Spec spec_funcs() {
+  return {Repl_Spec<POLICY, ASSOC>::access, Repl_Spec<POLICY, ASSOC>::evict,
+          Repl_Spec<POLICY, ASSOC>::insert};
+}
+
+#define SPEC_ASSOCS(policy)                                          \
+  {policy, 4, spec_funcs<policy, 4>()}, {policy, 8, spec_funcs<policy, 8>()}, \
+    {policy, 12, spec_funcs<policy, 12>()},                          \
+    {policy, 16, spec_funcs<policy, 16>()}
+
+static const struct {
+  Repl_Policy     policy;
+  uns             assoc;
+  Cache_Repl_Spec funcs;
+} spec_table[] = {
+  SPEC_ASSOCS(REPL_TRUE_LRU), SPEC_ASSOCS(REPL_LRU_REF),
+  SPEC_ASSOCS(REPL_SRRIP),    SPEC_ASSOCS(REPL_DRRIP),
+  SPEC_ASSOCS(REPL_SHIP),
+};
+
+/**************************************************************************************/
+/* cache_repl_spec_lookup: */
+
+const Cache_Repl_Spec* cache_repl_spec_lookup(Cache* cache) {
+  /* the generic code prints the set after every update when debugging */
+  if(CACHE_DEBUG_ENABLE || !cache->tag_store)
+    return NULL;
+
+  for(const auto& spec : spec_table) {
+    if(spec.policy == cache->repl_policy && spec.assoc == cache->assoc)
+      return &spec.funcs;
+  }
+  return NULL;
+}
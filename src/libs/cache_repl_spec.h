@@ -0,0 +1,78 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : libs/cache_repl_spec.h
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : C interface to the cache_lib lookup and replacement code that
+ *                is specialized at compile time for a replacement policy and
+ *                associativity (libs/cache_repl_spec.cc)
+ ***************************************************************************************/
+
+#ifndef __CACHE_REPL_SPEC_H__
+#define __CACHE_REPL_SPEC_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "libs/cache_lib.h"
+
+/**************************************************************************************/
+/* Defines */
+
+#define CACHE_REPL_RRIP_M 2 /* bits of re-reference prediction per line */
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Cache_Repl_Spec_struct {
+  /* lookup including the replacement update of a hit */
+  void* (*access)(Cache*, uns set, Addr tag, Flag update_repl);
+  /* victim selection, same contract as the policy's update_evict */
+  Cache_Entry* (*evict)(Cache*, uns8 proc_id, uns set, uns* way,
+                        Flag if_external);
+  /* replacement update of a line that was just inserted */
+  void (*insert)(Cache*, uns8 proc_id, uns set, uns way);
+} Cache_Repl_Spec;
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Returns the specialized functions for the cache's policy and
+   associativity, or NULL if there are none and the generic code is used */
+const Cache_Repl_Spec* cache_repl_spec_lookup(Cache* cache);
+
+/* policy functions of libs/cache_lib.c that the specializations reuse */
+void drrip_update_insert(Cache* cache, uns8 proc_id, uns set, uns way,
+                         void* arg);
+void ship_update_hit(Cache* cache, uns set, uns way, void* arg);
+void ship_update_insert(Cache* cache, uns8 proc_id, uns set, uns way,
+                        void* arg);
+Cache_Entry* ship_update_evict(Cache* cache, uns8 proc_id, uns set, uns* way,
+                               void* arg, Flag if_external);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* #ifndef __CACHE_REPL_SPEC_H__ */
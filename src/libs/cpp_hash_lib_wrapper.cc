@@ -7,14 +7,16 @@ struct key {
   uint64_t addr;
   uint64_t lsb_bytes;
   uint64_t msb_bytes;
-  uint8_t op_idx;
+  uint8_t core;
+  uint64_t variant;
 
-  key () : addr(0), lsb_bytes(0), msb_bytes(0), op_idx(0) {};
-  key ( uint64_t _addr, uint64_t _lsb_bytes, uint64_t _msb_bytes, uint8_t _op_idx) :
-  addr(_addr), lsb_bytes(_lsb_bytes), msb_bytes(_msb_bytes), op_idx(_op_idx) {};
+  key () : addr(0), lsb_bytes(0), msb_bytes(0), core(0), variant(0) {};
+  key ( uint64_t _addr, uint64_t _lsb_bytes, uint64_t _msb_bytes, uint8_t _core, uint64_t _variant = 0) :
+  addr(_addr), lsb_bytes(_lsb_bytes), msb_bytes(_msb_bytes), core(_core), variant(_variant) {};
 
   bool operator==(const key &p) const {
-    return addr == p.addr && lsb_bytes == p.lsb_bytes && msb_bytes == p.msb_bytes && op_idx == p.op_idx;
+    return addr == p.addr && lsb_bytes == p.lsb_bytes && msb_bytes == p.msb_bytes && core == p.core &&
+           variant == p.variant;
   }
 };
 
@@ -27,25 +29,24 @@ struct hash_fn
         std::size_t h1 = std::hash<uint64_t>()(key.addr);
         std::size_t h2 = std::hash<uint64_t>()(key.lsb_bytes);
         std::size_t h3 = std::hash<uint64_t>()(key.msb_bytes);
-        std::size_t h4 = std::hash<uint8_t>()(key.op_idx);
-        return h1 ^ h2 ^ h3 ^ h4;
+        std::size_t h4 = std::hash<uint8_t>()(key.core);
+        std::size_t h5 = std::hash<uint64_t>()(key.variant);
+        return h1 ^ h2 ^ h3 ^ h4 ^ h5;
     }
 };
 
-std::unordered_map<key, Inst_Info*, hash_fn> hash_map;
+std::unordered_map<key, Uop_Template, hash_fn> template_map;
 
-  Inst_Info *cpp_hash_table_access_create(int core, uint64_t addr, uint64_t lsb_bytes, uint64_t msb_bytes, uint8_t op_idx, unsigned char *new_entry) {
-    *new_entry = false;
-    key _key(addr, lsb_bytes, msb_bytes, op_idx);
-    auto lookup = hash_map.find(_key);
-    if (lookup != hash_map.end()) {
-      return lookup->second;
-    }
-    else {
-      Inst_Info * info = new Inst_Info(); //&vec.back();
-      hash_map.insert(std::pair<key, Inst_Info*>(_key, info));
-      *new_entry = true;
-      return info;
+  Uop_Template *cpp_hash_table_access_uop_template(int core, uint64_t addr, uint64_t lsb_bytes, uint64_t msb_bytes, uint64_t variant, unsigned char *new_entry) {
+    // the uops hold addresses converted for the core, so cores running the
+    // same binary cannot share them
+    key _key(addr, lsb_bytes, msb_bytes, core, variant);
+    // unordered_map never moves its elements, so the template can be handed out
+    auto result = template_map.emplace(_key, Uop_Template());
+    *new_entry = result.second;
+    if (result.second) {
+      result.first->second.num_uop = 0;
+      result.first->second.info = NULL;
     }
+    return &result.first->second;
   }
-
@@ -10,7 +10,15 @@ extern "C" {
 
   //class cpp_hash_lib_wrapper {
 
-  Inst_Info * cpp_hash_table_access_create(int core, uint64_t addr, uint64_t lsb_bytes, uint64_t msb_bytes, uint8_t op_idx, unsigned char *new_entry);
+  // The uops of one static instruction, built once by the uop generator.
+  // variant tells apart instances of the same instruction that decode to
+  // different uops (gather/scatter).
+  typedef struct Uop_Template_struct {
+    uns num_uop;
+    Inst_Info *info;  // num_uop entries, in uop order
+  } Uop_Template;
+
+  Uop_Template * cpp_hash_table_access_uop_template(int core, uint64_t addr, uint64_t lsb_bytes, uint64_t msb_bytes, uint64_t variant, unsigned char *new_entry);
 
 #ifdef __cplusplus
 }
@@ -27,6 +27,7 @@
  ***************************************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
 #include "debug/debug_macros.h"
 #include "globals/assert.h"
 #include "globals/global_defs.h"
@@ -34,7 +35,6 @@
 #include "globals/global_vars.h"
 
 #include "libs/hash_lib.h"
-#include "libs/malloc_lib.h"
 
 #include "debug/debug.param.h"
 
@@ -43,28 +43,34 @@
 
 #define DEBUG(args...) _DEBUG(DEBUG_HASH_LIB, ##args)
 
-int64 HASH_INDEX(const Hash_Table* table, int64 key);
-int64 HASH_INDEX(const Hash_Table*  table, int64 key) {
-  int64_t mask = (~0UL) % table->buckets;
-  int64_t hash = 0;
-  int log2 = 64 - __builtin_clzl(table->buckets);
-  for (int i = 0; i < 64; i += log2) {
-    hash ^= (key & mask);
-    key = key >> log2;
-  }
-  return hash;
-}
+#define HASH_TABLE_MAX_INIT_BUCKETS (1 << 16)
+#define HASH_TABLE_CHUNK_BYTES (1 << 16)
+#define HASH_TABLE_MULT 0x9e3779b97f4a7c15ULL
+
+
+/**************************************************************************************/
+/* Static prototypes */
+
+static inline uns   hash_index(Hash_Table const*, int64);
+static void         hash_table_resize(Hash_Table*, uns);
+static inline void* hash_table_find(Hash_Table const*, int64, void const*);
+static inline void* hash_table_create(Hash_Table*, int64, void const*, Flag*);
+static inline Flag  hash_table_delete(Hash_Table*, int64, void const*);
+static inline void* hash_table_alloc_elem(Hash_Table*);
+static inline void  hash_table_free_elem(Hash_Table*, void*);
+
 
 /**************************************************************************************/
-// Global variables
+/* hash_index: home slot of a key */
 
-#define NUM_HASH_TABLE_PRIMES 12
-static uns const hash_table_primes[NUM_HASH_TABLE_PRIMES] = {
-  1, 5, 11, 23, 47, 101, 211, 401, 811, 1601, 3209, 6373};
+static inline uns hash_index(Hash_Table const* table, int64 key) {
+  return (uns)(((uns64)key * HASH_TABLE_MULT) >> table->hash_shift);
+}
 
 
 /**************************************************************************************/
-/* init_hash_table: */
+/* init_hash_table: the number of buckets is only the initial size, the table
+   grows as needed */
 
 void init_hash_table(Hash_Table* table, const char* name, uns buckets,
                      uns data_size) {
@@ -74,137 +80,209 @@ void init_hash_table(Hash_Table* table, const char* name, uns buckets,
 void init_complex_hash_table(Hash_Table* table, const char* name, uns buckets,
                              uns data_size,
                              Flag (*eq_func)(void const*, void const*)) {
-  table->name      = strdup(name);
-  table->buckets   = buckets;
-  table->data_size = data_size;
-  table->count     = 0;
-  table->entries   = (Hash_Table_Entry**)calloc(buckets,
-                                              sizeof(Hash_Table_Entry*));
-  table->eq_func   = eq_func;
+  table->name       = strdup(name);
+  table->data_size  = data_size;
+  table->count      = 0;
+  table->entries    = NULL;
+  table->eq_func    = eq_func;
+  table->elem_size  = (MAX2(data_size, sizeof(void*)) + sizeof(void*) - 1) &
+                     ~(sizeof(void*) - 1);
+  table->chunk_ptr  = NULL;
+  table->chunk_left = 0;
+  table->free_elems = NULL;
+  hash_table_resize(table, MIN2(buckets, HASH_TABLE_MAX_INIT_BUCKETS));
 }
 
 
 /**************************************************************************************/
-/* hash_table_access: access the hash table.  Return the data pointer
-   if it hits, NULL otherwise */
+/* hash_table_resize: reinsert every entry into a table of at least the given
+   number of slots (rounded up to a power of two, and to keep the table at
+   most 3/4 full) */
+
+static void hash_table_resize(Hash_Table* table, uns min_buckets) {
+  Hash_Table_Entry* old_entries = table->entries;
+  uns               old_buckets = old_entries ? table->buckets : 0;
+  uns               buckets     = 8;
+  uns               ii;
+
+  while(buckets < min_buckets || buckets * 3 < (uns)table->count * 4 + 4)
+    buckets <<= 1;
+
+  table->buckets    = buckets;
+  table->hash_shift = 64 - LOG2(buckets);
+  table->entries    = (Hash_Table_Entry*)calloc(buckets,
+                                             sizeof(Hash_Table_Entry));
+  ASSERT(0, table->entries);
+
+  for(ii = 0; ii < old_buckets; ii++) {
+    Hash_Table_Entry* entry = &old_entries[ii];
+    uns               index;
+    if(!entry->data)
+      continue;
+    for(index = hash_index(table, entry->key); table->entries[index].data;
+        index = (index + 1) & (buckets - 1))
+      ;
+    table->entries[index] = *entry;
+  }
+  free(old_entries);
 
+  DEBUG(0, "Resized hash table '%s' to %u buckets (%d entries)\n",
+        table->name, buckets, table->count);
+}
 
-void* hash_table_access(Hash_Table const* table, int64 key) {
-  // {{{ access hash table using simple key compare
-  uns               index  = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
 
-  for(temp = bucket; temp != NULL; temp = temp->next)
-    if(temp->key == key)
-      return temp->data;
+/**************************************************************************************/
+/* hash_table_alloc_elem: */
+
+static inline void* hash_table_alloc_elem(Hash_Table* table) {
+  void* elem = table->free_elems;
 
-  return NULL;
-  // }}}
+  if(elem) {
+    table->free_elems = *(void**)elem;
+    return elem;
+  }
+
+  if(!table->chunk_left) {
+    uns num_elems     = MAX2(HASH_TABLE_CHUNK_BYTES / table->elem_size, 1);
+    table->chunk_ptr  = (char*)malloc(num_elems * table->elem_size);
+    table->chunk_left = num_elems;
+    ASSERT(0, table->chunk_ptr);
+  }
+  elem = table->chunk_ptr;
+  table->chunk_ptr += table->elem_size;
+  table->chunk_left--;
+  return elem;
 }
 
-void* complex_hash_table_access(Hash_Table const* table, int64 key,
-                                void const* data) {
-  // {{{ access hash table using a complex comparison
-  uns               index  = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
 
-  ASSERT(0, table->eq_func);
-  ASSERT(0, data);
+/**************************************************************************************/
+/* hash_table_free_elem: */
+
+static inline void hash_table_free_elem(Hash_Table* table, void* elem) {
+  *(void**)elem     = table->free_elems;
+  table->free_elems = elem;
+}
 
-  for(temp = bucket; temp != NULL; temp = temp->next)
-    if(temp->key == key && table->eq_func(temp->data, data))
-      return temp->data;
 
+/**************************************************************************************/
+/* hash_table_find: with data == NULL only the keys are compared */
+
+static inline void* hash_table_find(Hash_Table const* table, int64 key,
+                                    void const* data) {
+  uns mask = table->buckets - 1;
+  uns index;
+
+  for(index = hash_index(table, key); table->entries[index].data;
+      index = (index + 1) & mask) {
+    Hash_Table_Entry* entry = &table->entries[index];
+    if(entry->key == key && (!data || table->eq_func(entry->data, data)))
+      return entry->data;
+  }
   return NULL;
-  // }}}
 }
 
 
 /**************************************************************************************/
-/* hash_table_access_create: access the hash table.  Return the data
-   pointer if it hits an existing entry.  Otherwise, allocate a new
-   entry and return its data pointer. */
+/* hash_table_create: */
 
-void* hash_table_access_create(Hash_Table* table, int64 key, Flag* new_entry) {
-  // {{{ access hash table using simple key compare
-  uns               index    = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket   = table->entries[index];
-  Hash_Table_Entry* new_hash = NULL;
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
+static inline void* hash_table_create(Hash_Table* table, int64 key,
+                                      void const* data, Flag* new_entry) {
+  void* found = hash_table_find(table, key, data);
+  uns   mask;
+  uns   index;
 
   *new_entry = FALSE;
-  ASSERT(0, index < table->buckets);
-  for(temp = bucket; temp != NULL; temp = temp->next) {
-    if(temp->key == key)
-      return temp->data;
-    else
-      prev = temp;
-  }
+  if(found)
+    return found;
+
+  if((uns)(table->count + 1) * 4 > table->buckets * 3)
+    hash_table_resize(table, table->buckets << 1);
+
+  mask = table->buckets - 1;
+  for(index = hash_index(table, key); table->entries[index].data;
+      index = (index + 1) & mask)
+    ;
+  table->entries[index].key   = key;
+  table->entries[index].data  = hash_table_alloc_elem(table);
+  table->entries[index].owned = TRUE;
   table->count++;
   *new_entry = TRUE;
-  new_hash   = (Hash_Table_Entry*)smalloc(sizeof(Hash_Table_Entry));
-  ASSERT(0, new_hash);
-  new_hash->key  = key;
-  new_hash->next = NULL;
-  new_hash->data = (void*)smalloc(table->data_size);
-  ASSERT(0, new_hash->data);
-
-  if(prev)
-    prev->next = new_hash;
-  else
-    table->entries[index] = new_hash;
-
-  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n",
-          (unsigned long int)sizeof(Hash_Table_Entry) + table->data_size,
+
+  _DEBUGA(0, 0, "allocated %u bytes for %s (%d entries)\n", table->elem_size,
           table->name, table->count);
 
-  return new_hash->data;
-  // }}}
+  return table->entries[index].data;
 }
 
-void* complex_hash_table_access_create(Hash_Table* table, int64 key,
-                                       void const* data, Flag* new_entry) {
-  // {{{ access hash table using a complex comparison
-  uns               index    = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket   = table->entries[index];
-  Hash_Table_Entry* new_hash = NULL;
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
 
+/**************************************************************************************/
+/* hash_table_delete: backward shift deletion. Entries after the hole that
+   could live in it (their home slot is not between the hole and themselves)
+   are moved back, until an empty slot ends the probe sequence. */
+
+static inline Flag hash_table_delete(Hash_Table* table, int64 key,
+                                     void const* data) {
+  uns mask = table->buckets - 1;
+  uns hole, index;
+
+  for(hole = hash_index(table, key); table->entries[hole].data;
+      hole = (hole + 1) & mask) {
+    Hash_Table_Entry* entry = &table->entries[hole];
+    if(entry->key == key && (!data || table->eq_func(entry->data, data)))
+      break;
+  }
+  if(!table->entries[hole].data)
+    return FALSE;
+
+  if(table->entries[hole].owned)
+    hash_table_free_elem(table, table->entries[hole].data);
+
+  for(index = (hole + 1) & mask; table->entries[index].data;
+      index = (index + 1) & mask) {
+    uns home = hash_index(table, table->entries[index].key);
+    if(((index - home) & mask) >= ((index - hole) & mask)) {
+      table->entries[hole] = table->entries[index];
+      hole                 = index;
+    }
+  }
+  table->entries[hole].data = NULL;
+
+  table->count--;
+  ASSERT(0, table->count >= 0);
+  return TRUE;
+}
+
+
+/**************************************************************************************/
+/* hash_table_access: access the hash table.  Return the data pointer
+   if it hits, NULL otherwise */
+
+void* hash_table_access(Hash_Table const* table, int64 key) {
+  return hash_table_find(table, key, NULL);
+}
+
+void* complex_hash_table_access(Hash_Table const* table, int64 key,
+                                void const* data) {
   ASSERT(0, table->eq_func);
   ASSERT(0, data);
+  return hash_table_find(table, key, data);
+}
 
-  *new_entry = FALSE;
-  ASSERT(0, index < table->buckets);
-  for(temp = bucket; temp != NULL; temp = temp->next) {
-    if(temp->key == key && table->eq_func(temp->data, data))
-      return temp->data;
-    else
-      prev = temp;
-  }
-  table->count++;
-  *new_entry = TRUE;
-  new_hash   = (Hash_Table_Entry*)smalloc(sizeof(Hash_Table_Entry));
-  ASSERT(0, new_hash);
-  new_hash->key  = key;
-  new_hash->next = NULL;
-  new_hash->data = (void*)smalloc(table->data_size);
-  ASSERT(0, new_hash->data);
-
-  if(prev)
-    prev->next = new_hash;
-  else
-    table->entries[index] = new_hash;
-
-  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n",
-          (unsigned long int)sizeof(Hash_Table_Entry) + table->data_size,
-          table->name, table->count);
 
-  return new_hash->data;
-  // }}}
+/**************************************************************************************/
+/* hash_table_access_create: access the hash table.  Return the data
+   pointer if it hits an existing entry.  Otherwise, allocate a new
+   entry and return its data pointer. */
+
+void* hash_table_access_create(Hash_Table* table, int64 key, Flag* new_entry) {
+  return hash_table_create(table, key, NULL, new_entry);
+}
+
+void* complex_hash_table_access_create(Hash_Table* table, int64 key,
+                                       void const* data, Flag* new_entry) {
+  ASSERT(0, table->eq_func);
+  ASSERT(0, data);
+  return hash_table_create(table, key, data, new_entry);
 }
 
 
@@ -213,61 +291,14 @@ void* complex_hash_table_access_create(Hash_Table* table, int64 key,
    TRUE if it was found, FALSE otherwise */
 
 Flag hash_table_access_delete(Hash_Table* table, int64 key) {
-  // {{{ access hash table using simple key compare
-  uns               index  = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
-
-  for(temp = bucket; temp != NULL; temp = temp->next) {
-    if(temp->key == key) {
-      Hash_Table_Entry* next_ptr = temp->next;
-      sfree(table->data_size, temp->data);
-      sfree(sizeof(Hash_Table_Entry), temp);
-      if(prev)
-        prev->next = next_ptr;
-      else
-        table->entries[index] = next_ptr;
-      table->count--;
-      ASSERT(0, table->count >= 0);
-      return TRUE;
-    } else
-      prev = temp;
-  }
-
-  return FALSE;
-  // }}}
+  return hash_table_delete(table, key, NULL);
 }
 
 Flag complex_hash_table_access_delete(Hash_Table* table, int64 key,
                                       void const* data) {
-  // {{{ access hash table using a complex comparison
-  uns               index  = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
-
   ASSERT(0, table->eq_func);
   ASSERT(0, data);
-
-  for(temp = bucket; temp != NULL; temp = temp->next) {
-    if(temp->key == key && table->eq_func(temp->data, data)) {
-      Hash_Table_Entry* next_ptr = temp->next;
-      sfree(table->data_size, temp->data);
-      sfree(sizeof(Hash_Table_Entry), temp);
-      if(prev)
-        prev->next = next_ptr;
-      else
-        table->entries[index] = next_ptr;
-      table->count--;
-      ASSERT(0, table->count >= 0);
-      return TRUE;
-    } else
-      prev = temp;
-  }
-
-  return FALSE;
-  // }}}
+  return hash_table_delete(table, key, data);
 }
 
 
@@ -275,21 +306,17 @@ Flag complex_hash_table_access_delete(Hash_Table* table, int64 key,
 /* hash_table_clear: */
 
 void hash_table_clear(Hash_Table* table) {
-  Hash_Table_Entry* temp0;
-  Hash_Table_Entry* temp1;
-  uns               count = 0;
-  int               ii;
+  uns count = 0;
+  uns ii;
 
   for(ii = 0; ii < table->buckets; ii++) {
-    temp0 = table->entries[ii];
-    while(temp0) {
-      temp1 = temp0->next;
-      sfree(table->data_size, temp0->data);
-      sfree(sizeof(Hash_Table_Entry), temp0);
-      temp0 = temp1;
-      count++;
-    }
-    table->entries[ii] = NULL;
+    Hash_Table_Entry* entry = &table->entries[ii];
+    if(!entry->data)
+      continue;
+    if(entry->owned)
+      hash_table_free_elem(table, entry->data);
+    entry->data = NULL;
+    count++;
   }
   ASSERT(0, count == table->count);
   table->count = 0;
@@ -302,10 +329,9 @@ void hash_table_clear(Hash_Table* table) {
  */
 
 void** hash_table_flatten(Hash_Table* table, void** reuse_array) {
-  Hash_Table_Entry* temp;
-  void**            new_array;
-  uns               count = 0;
-  int               ii;
+  void** new_array;
+  uns    count = 0;
+  uns    ii;
 
   if(table->count == 0)
     return NULL;
@@ -318,14 +344,9 @@ void** hash_table_flatten(Hash_Table* table, void** reuse_array) {
   }
 
   /* write into the new array */
-  count = 0;
-  for(ii = 0; ii < table->buckets; ii++) {
-    temp = table->entries[ii];
-    while(temp) {
-      new_array[count++] = temp->data;
-      temp               = temp->next;
-    }
-  }
+  for(ii = 0; ii < table->buckets; ii++)
+    if(table->entries[ii].data)
+      new_array[count++] = table->entries[ii].data;
 
   ASSERTM(0, count == table->count, "%d %d\n", count, table->count);
   ASSERTM(0, count > 0, "%d %d\n", count, table->count);
@@ -336,13 +357,12 @@ void** hash_table_flatten(Hash_Table* table, void** reuse_array) {
 
 /**************************************************************************************/
 // hash_table_scan: scans all of the nodes in the hash table and runs
-// the scan_fanc on them
+// the scan_fanc on them. scan_func must not insert or delete entries.
 
 void hash_table_scan(Hash_Table* table, void (*scan_func)(void*, void*),
                      void*       arg) {
-  int               count = 0;
-  Hash_Table_Entry* temp;
-  int               ii;
+  int count = 0;
+  uns ii;
 
   ASSERT(0, scan_func);
 
@@ -350,11 +370,9 @@ void hash_table_scan(Hash_Table* table, void (*scan_func)(void*, void*),
     return;
 
   for(ii = 0; ii < table->buckets; ii++) {
-    temp = table->entries[ii];
-    while(temp) {
+    if(table->entries[ii].data) {
       count++;
-      scan_func(temp->data, arg);
-      temp = temp->next;
+      scan_func(table->entries[ii].data, arg);
     }
   }
   ASSERT(0, count == table->count);
@@ -362,99 +380,42 @@ void hash_table_scan(Hash_Table* table, void (*scan_func)(void*, void*),
 
 
 /**************************************************************************************/
-// hash_table_rehash: expand or contract the hash table
-// WARNING: this hasn't really been tested
+// hash_table_rehash: expand or contract the hash table. 0 doubles it; the
+// table never becomes more than 3/4 full.
 
 void hash_table_rehash(Hash_Table* table, int new_buckets) {
-  Hash_Table_Entry** new_entries;
-  Hash_Table_Entry** flat_entries;
-  Hash_Table_Entry** old_entries = table->entries;
-  uns                old_buckets = table->buckets;
-  Hash_Table_Entry*  temp;
-  uns                ii, jj;
-
   ASSERT(0, new_buckets >= 0);
-  if(new_buckets == 0) {  // use next prime
-    new_buckets = table->buckets;
-    for(ii = 0; ii < NUM_HASH_TABLE_PRIMES - 1; ii++)
-      if(hash_table_primes[ii] == old_buckets) {
-        new_buckets = hash_table_primes[ii + 1];
-        break;
-      }
-  }
-  if(new_buckets == old_buckets)
-    return;
-
-  // flatten hash table into an array of entries
-  flat_entries = (Hash_Table_Entry**)malloc(table->count *
-                                            sizeof(Hash_Table_Entry*));
-  for(ii = 0, jj = 0; ii < old_buckets; ii++)
-    for(temp = old_entries[ii]; temp; temp = temp->next)
-      flat_entries[jj++] = temp;
-  ASSERT(0, jj == table->count);
-
-  // replace old with new and free the old entry array
-  new_entries = (Hash_Table_Entry**)calloc(new_buckets,
-                                           sizeof(Hash_Table_Entry*));
-  ASSERT(0, new_entries);
-  ASSERT(0, new_buckets > 0 && new_buckets < 100000);
-  table->buckets = new_buckets;
-  table->entries = new_entries;
-  free(old_entries);
-
-  // insert each element
-  for(ii = 0; ii < table->count; ii++) {
-    Hash_Table_Entry* temp  = flat_entries[ii];
-    uns               index = HASH_INDEX(table, temp->key);
-    temp->next              = table->entries[index];
-    table->entries[index]   = temp;
-  }
-
-  free(flat_entries);
+  hash_table_resize(table, new_buckets ? new_buckets : table->buckets << 1);
 }
 
 /**************************************************************************************/
 // hash_table_access_replace: replace the data in an existing entry, or create
-// it
-//                            if it doesn't exist yet
+// it if it doesn't exist yet. The replacement is owned by the caller.
+
 void hash_table_access_replace(Hash_Table* table, int64 key,
                                void* replacement) {
-  // {{{ access hash table using simple key compare
-  uns               index    = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket   = table->entries[index];
-  Hash_Table_Entry* new_hash = NULL;
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev      = NULL;
-  Flag              new_entry = FALSE;
-  UNUSED(new_entry);
+  uns mask;
+  uns index;
+
   ASSERT(0, replacement);
-  ASSERT(0, index < table->buckets);
-  for(temp = bucket; temp != NULL; temp = temp->next) {
-    if(temp->key == key) {
+
+  if((uns)(table->count + 1) * 4 > table->buckets * 3)
+    hash_table_resize(table, table->buckets << 1);
+
+  mask = table->buckets - 1;
+  for(index = hash_index(table, key); table->entries[index].data;
+      index = (index + 1) & mask) {
+    Hash_Table_Entry* entry = &table->entries[index];
+    if(entry->key == key) {
       /* May not want to free the memory in case there are other valid pointers
-         to it. ASSERT(0,temp->data); free(table->data_size, temp->data);
-      */
-      temp->data = replacement;
+         to it. */
+      entry->data  = replacement;
+      entry->owned = FALSE;
       return;
-    } else {
-      prev = temp;
     }
   }
+  table->entries[index].key   = key;
+  table->entries[index].data  = replacement;
+  table->entries[index].owned = FALSE;
   table->count++;
-  new_entry = TRUE;
-  new_hash  = (Hash_Table_Entry*)smalloc(sizeof(Hash_Table_Entry));
-  ASSERT(0, new_hash);
-  new_hash->key  = key;
-  new_hash->next = NULL;
-  new_hash->data = replacement;
-
-  if(prev)
-    prev->next = new_hash;
-  else
-    table->entries[index] = new_hash;
-
-  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n",
-          (unsigned long int)sizeof(Hash_Table_Entry), table->name,
-          table->count);
-  // }}}
 }
@@ -35,19 +35,31 @@
 /**************************************************************************************/
 /* Types */
 
+/* Open addressing with linear probing. The table is a power of two slots and
+   grows when it is 3/4 full; deletion shifts the rest of the probe sequence
+   back, so there are no tombstones. The data elements are carved out of
+   chunks owned by the table and keep their address until they are deleted. */
+
 typedef struct Hash_Table_Entry_struct {
-  int64                           key;
-  void*                           data;
-  struct Hash_Table_Entry_struct* next;
+  int64 key;
+  void* data;   // NULL if the slot is empty
+  Flag  owned;  // data comes from the table's chunks (not access_replace)
 } Hash_Table_Entry;
 
 typedef struct Hash_Table_struct {
-  char*              name;
-  uns                buckets;
-  uns                data_size;
-  int                count;  // total number of elements in the hash table
-  Hash_Table_Entry** entries;
+  char*             name;
+  uns               buckets;  // number of slots, a power of two
+  uns               hash_shift;
+  uns               data_size;
+  int               count;  // total number of elements in the hash table
+  Hash_Table_Entry* entries;
   Flag (*eq_func)(void const* const, void const* const);
+
+  /* data element storage */
+  uns    elem_size;
+  char*  chunk_ptr;   // unused part of the newest chunk
+  uns    chunk_left;  // elements left at chunk_ptr
+  void*  free_elems;  // deleted elements, linked through their first word
 } Hash_Table;
 
 
@@ -55,6 +55,7 @@
 #define DEBUGU(proc_id, args...) _DEBUGU(proc_id, DEBUG_MAP, ##args)
 
 #define WAKE_UP_ENTRIES_INC 256 /* default 256 */
+#define DEP_SLOT_NONE MAX_UNS
 #define MEM_ADDR_SRC \
   0 /* address for memory instructions calculated off source 0 */
 
@@ -96,10 +97,27 @@ typedef struct Mem_Map_Traversal_struct {
 extern Op invalid_op;
 
 
+/**************************************************************************************/
+/* Dependency bit-matrix (WAKE_UP_MATRIX): every op that passes the map stage
+ * holds a slot until it is freed. Bit c of row p of the matrix for a
+ * dependence type is set when the op in slot c has a source of that type
+ * produced by the op in slot p, so waking up the dependents of an op is a scan
+ * of one row instead of a walk of its wake up list. */
+
+typedef struct Dep_Matrix_struct {
+  uns    num_slots;
+  uns    num_words;            /* uns64 words per row */
+  uns64* rows[NUM_DEP_TYPES];  /* num_slots rows of num_words each */
+  uns64* free_slots;           /* set bits are unused slots */
+  Op**   ops;                  /* op holding each slot */
+} Dep_Matrix;
+
 /**************************************************************************************/
 /* Global Variables */
 
-Map_Data* map_data = NULL;
+__thread Map_Data* map_data = NULL;
+
+static Dep_Matrix* dep_matrices = NULL; /* one per core */
 
 const char* const dep_type_names[NUM_DEP_TYPES] = {
   "REG_DATA",
@@ -115,6 +133,11 @@ static inline void read_store_map(Op*);
 static inline void update_map(Op*);
 
 static inline void expand_wake_up_entries(void);
+static void        init_dep_matrix(uns8 proc_id);
+static void        dep_matrix_alloc_slot(Op* op);
+static void        dep_matrix_free_slot(Op* op);
+static void        dep_matrix_wake(Op* op, Dep_Type type,
+                                   void (*wake_action)(Op*, Op*, uns8));
 static inline void update_store_hash(Op* op);
 static inline Op*  add_store_deps(Op* op);
 static inline void update_map_entry(Op* op, Map_Entry* map_entry);
@@ -162,8 +185,11 @@ void init_map(uns8 proc_id) {
   map_data->last_store[1].op     = &invalid_op;
   map_data->last_store[1].op_num = 0;
 
-  /* Allocate the wake_up_entry pool. */
-  expand_wake_up_entries();
+  /* Allocate the wake_up_entry pool (or the dependency matrix). */
+  if(WAKE_UP_MATRIX)
+    init_dep_matrix(proc_id);
+  else
+    expand_wake_up_entries();
 
   /* Initialize the memory dependence hash table. The number of
      buckets matters since we scan all entries (and all buckets) on
@@ -582,6 +608,9 @@ void wake_up_ops(Op* op, Dep_Type type, void (*wake_action)(Op*, Op*, uns8)) {
           op->off_path);
 
   ASSERT(op->proc_id, wake_action);
+  if(WAKE_UP_MATRIX)
+    dep_matrix_wake(op, type, wake_action);
+
   for(temp = op->wake_up_head; temp; temp = temp->next) {
     Op*     dep_op         = temp->op;
     Counter dep_unique_num = temp->unique_num;
@@ -631,6 +660,9 @@ void add_to_wake_up_lists(Op* op, Op_Info* op_info,
   ASSERT(map_data->proc_id, op_info);
   ASSERT(map_data->proc_id, op->proc_id == map_data->proc_id);
 
+  if(WAKE_UP_MATRIX)
+    dep_matrix_alloc_slot(op);
+
   for(ii = 0; ii < op_info->num_srcs; ii++) {
     Src_Info* src_info = &op_info->src_info[ii];
     Op*       src_op   = src_info->op;
@@ -648,42 +680,50 @@ void add_to_wake_up_lists(Op* op, Op_Info* op_info,
       /* make sure the source op is still in the machine */
       /* add to the src op's wake up list regardless of whether
              it has already produced a result or not */
-      Wake_Up_Entry* wake;
-
       ASSERTM(
         op->proc_id, op->proc_id == src_op->proc_id,
         "op num: %llu fetch: %llu, src_op num: %llu unique: %llu fetch: %llu\n",
         op->op_num, op->fetch_cycle, src_op->op_num, src_op->unique_num,
         src_op->fetch_cycle);
 
-      if(map_data->free_list_head == NULL) {
-        ASSERT(map_data->proc_id,
-               map_data->active_wake_up_entries == map_data->wake_up_entries);
-        expand_wake_up_entries();
-      }
-
       if(src_info->type == MEM_DATA_DEP)
         dep_on_in_window_store = TRUE;
 
-      wake = map_data->free_list_head;
-      map_data->active_wake_up_entries++;
-      map_data->free_list_head = wake->next;
-
-      wake->op         = op;
-      wake->unique_num = op->unique_num;
-      wake->dep_type   = src_info->type;
-      wake->rdy_bit    = ii;
-      wake->next       = NULL;
-
-      if(src_op->wake_up_tail == NULL) {
-        src_op->wake_up_head  = wake;
-        src_op->wake_up_tail  = wake;
-        src_op->wake_up_count = 1;
+      if(WAKE_UP_MATRIX) {
+        Dep_Matrix* m = &dep_matrices[op->proc_id];
+        ASSERT(op->proc_id, src_op->dep_slot != DEP_SLOT_NONE);
+        m->rows[src_info->type][src_op->dep_slot * m->num_words +
+                                op->dep_slot / 64] |= 1ULL << (op->dep_slot %
+                                                                64);
       } else {
-        ASSERT(map_data->proc_id, src_op->wake_up_head);
-        src_op->wake_up_tail->next = wake;
-        src_op->wake_up_tail       = wake;
-        src_op->wake_up_count++;
+        Wake_Up_Entry* wake;
+
+        if(map_data->free_list_head == NULL) {
+          ASSERT(map_data->proc_id,
+                 map_data->active_wake_up_entries == map_data->wake_up_entries);
+          expand_wake_up_entries();
+        }
+
+        wake = map_data->free_list_head;
+        map_data->active_wake_up_entries++;
+        map_data->free_list_head = wake->next;
+
+        wake->op         = op;
+        wake->unique_num = op->unique_num;
+        wake->dep_type   = src_info->type;
+        wake->rdy_bit    = ii;
+        wake->next       = NULL;
+
+        if(src_op->wake_up_tail == NULL) {
+          src_op->wake_up_head  = wake;
+          src_op->wake_up_tail  = wake;
+          src_op->wake_up_count = 1;
+        } else {
+          ASSERT(map_data->proc_id, src_op->wake_up_head);
+          src_op->wake_up_tail->next = wake;
+          src_op->wake_up_tail       = wake;
+          src_op->wake_up_count++;
+        }
       }
 
       if(TRACK_L1_MISS_DEPS) {
@@ -721,6 +761,9 @@ void free_wake_up_list(Op* op) {
   ASSERT(map_data->proc_id, op);
   ASSERT(map_data->proc_id, op->proc_id == map_data->proc_id);
 
+  if(op->dep_slot != DEP_SLOT_NONE)
+    dep_matrix_free_slot(op);
+
   if(op->wake_up_tail) {
     ASSERT(map_data->proc_id, op->wake_up_head);
     DEBUG(map_data->proc_id, "Freeing wake up list for op_num:%s\n",
@@ -738,6 +781,149 @@ void free_wake_up_list(Op* op) {
 }
 
 
+/**************************************************************************************/
+/* for_each_dep_op: calls func(op, dep_op) for the ops that are still in the
+ * machine and depend on op (through any type of dependence) */
+
+void for_each_dep_op(Op* op, void (*func)(Op*, Op*)) {
+  if(op->dep_slot != DEP_SLOT_NONE) {
+    Dep_Matrix* m = &dep_matrices[op->proc_id];
+    for(uns ww = 0; ww < m->num_words; ww++) {
+      uns64 bits = 0;
+      for(uns type = 0; type < NUM_DEP_TYPES; type++)
+        bits |= m->rows[type][op->dep_slot * m->num_words + ww];
+      for(; bits; bits &= bits - 1)
+        func(op, m->ops[ww * 64 + __builtin_ctzll(bits)]);
+    }
+    return;
+  }
+
+  for(Wake_Up_Entry* temp = op->wake_up_head; temp; temp = temp->next) {
+    Op* dep_op = temp->op;
+    if(dep_op->unique_num == temp->unique_num && dep_op->op_pool_valid)
+      func(op, dep_op);
+  }
+}
+
+
+/**************************************************************************************/
+/* has_dep_ops: did any op register a dependence on op? */
+
+Flag has_dep_ops(Op* op) {
+  if(op->dep_slot != DEP_SLOT_NONE) {
+    Dep_Matrix* m = &dep_matrices[op->proc_id];
+    for(uns type = 0; type < NUM_DEP_TYPES; type++)
+      for(uns ww = 0; ww < m->num_words; ww++)
+        if(m->rows[type][op->dep_slot * m->num_words + ww])
+          return TRUE;
+    return FALSE;
+  }
+  return op->wake_up_head != NULL;
+}
+
+
+/**************************************************************************************/
+/* init_dep_matrix: */
+
+static void init_dep_matrix(uns8 proc_id) {
+  if(!dep_matrices)
+    dep_matrices = (Dep_Matrix*)calloc(NUM_CORES, sizeof(Dep_Matrix));
+
+  Dep_Matrix* m = &dep_matrices[proc_id];
+  m->num_slots  = WAKE_UP_MATRIX_SLOTS ? WAKE_UP_MATRIX_SLOTS :
+                                         2 * NODE_TABLE_SIZE;
+  m->num_words  = ROUND_UP(m->num_slots, 64) / 64;
+  for(uns type = 0; type < NUM_DEP_TYPES; type++)
+    m->rows[type] = (uns64*)calloc(m->num_slots * m->num_words,
+                                   sizeof(uns64));
+  m->ops        = (Op**)calloc(m->num_slots, sizeof(Op*));
+  m->free_slots = (uns64*)calloc(m->num_words, sizeof(uns64));
+  for(uns slot = 0; slot < m->num_slots; slot++)
+    m->free_slots[slot / 64] |= 1ULL << (slot % 64);
+}
+
+
+/**************************************************************************************/
+/* dep_matrix_alloc_slot: the rows of a slot are cleared when it is handed out,
+ * its column is cleared by the dependents' producers when it is freed */
+
+static void dep_matrix_alloc_slot(Op* op) {
+  Dep_Matrix* m = &dep_matrices[op->proc_id];
+  uns         ww;
+
+  ASSERT(op->proc_id, op->dep_slot == DEP_SLOT_NONE);
+  for(ww = 0; ww < m->num_words && !m->free_slots[ww]; ww++)
+    ;
+  if(ww == m->num_words)
+    FATAL_ERROR(op->proc_id, "All %u dependency matrix slots are in use "
+                             "(increase WAKE_UP_MATRIX_SLOTS)\n",
+                m->num_slots);
+
+  uns slot = ww * 64 + __builtin_ctzll(m->free_slots[ww]);
+  m->free_slots[ww] &= ~(1ULL << (slot % 64));
+  for(uns type = 0; type < NUM_DEP_TYPES; type++)
+    memset(&m->rows[type][slot * m->num_words], 0,
+           sizeof(uns64) * m->num_words);
+  m->ops[slot] = op;
+  op->dep_slot = slot;
+}
+
+
+/**************************************************************************************/
+/* dep_matrix_free_slot: removes the op from the rows of its producers that
+ * are still in the machine. The rows of producers that already left are
+ * cleared when their slot is reused. */
+
+static void dep_matrix_free_slot(Op* op) {
+  Dep_Matrix* m    = &dep_matrices[op->proc_id];
+  uns         slot = op->dep_slot;
+
+  for(uns ii = 0; ii < op->oracle_info.num_srcs; ii++) {
+    Src_Info* src_info = &op->oracle_info.src_info[ii];
+    Op*       src_op   = src_info->op;
+    if(src_op->op_pool_valid && src_op->unique_num == src_info->unique_num &&
+       src_op->dep_slot != DEP_SLOT_NONE)
+      m->rows[src_info->type][src_op->dep_slot * m->num_words + slot / 64] &=
+        ~(1ULL << (slot % 64));
+  }
+
+  m->ops[slot] = NULL;
+  m->free_slots[slot / 64] |= 1ULL << (slot % 64);
+  op->dep_slot = DEP_SLOT_NONE;
+}
+
+
+/**************************************************************************************/
+/* dep_matrix_wake: the bit-matrix version of the wake up list walk in
+ * wake_up_ops() */
+
+static void dep_matrix_wake(Op* op, Dep_Type type,
+                            void (*wake_action)(Op*, Op*, uns8)) {
+  Dep_Matrix* m   = &dep_matrices[op->proc_id];
+  uns64*      row = &m->rows[type][op->dep_slot * m->num_words];
+
+  ASSERT(op->proc_id, op->dep_slot != DEP_SLOT_NONE);
+  for(uns ww = 0; ww < m->num_words; ww++) {
+    for(uns64 bits = row[ww]; bits; bits &= bits - 1) {
+      Op* dep_op = m->ops[ww * 64 + __builtin_ctzll(bits)];
+      ASSERT(op->proc_id, dep_op && dep_op->op_pool_valid);
+
+      /* a dependent may read more than one source produced by op */
+      for(uns ii = 0; ii < dep_op->oracle_info.num_srcs; ii++) {
+        Src_Info* src_info = &dep_op->oracle_info.src_info[ii];
+        if(src_info->op != op || src_info->unique_num != op->unique_num ||
+           src_info->type != type || !test_not_rdy_bit(dep_op, ii))
+          continue;
+        DEBUG(dep_op->proc_id, "Waking up  op_num:%s\n",
+              unsstr64(dep_op->op_num));
+        clear_not_rdy_bit(dep_op, ii);
+        wake_action(op, dep_op, ii);
+      }
+    }
+  }
+}
+
+
 /**************************************************************************************/
 /* add_src_from_op: . */
 
@@ -123,7 +123,7 @@ typedef struct Map_Data_struct {
 /**************************************************************************************/
 /* External Variables */
 
-extern Map_Data* map_data;
+extern __thread Map_Data* map_data;
 
 
 /**************************************************************************************/
@@ -138,6 +138,8 @@ void      map_op(Op*);
 void      map_mem_dep(Op*);
 void      wake_up_ops(Op*, Dep_Type, void (*)(Op*, Op*, uns8));
 void      free_wake_up_list(Op*);
+void      for_each_dep_op(Op*, void (*)(Op*, Op*));
+Flag      has_dep_ops(Op*);
 void      add_to_wake_up_lists(Op*, Op_Info*, void (*)(Op*, Op*, uns8));
 
 void add_src_from_op(Op*, Op*, Dep_Type);
@@ -59,11 +59,7 @@
 /**************************************************************************************/
 /* Global Variables */
 
-Map_Stage* map = NULL;
-// The next op number is used when deciding whether to consume ops from the
-// uop cache: i.e. check if any preceding instructions are still in the decoder.
-Counter map_stage_next_op_num = 1;
-int map_off_path = 0;
+__thread Map_Stage* map = NULL;
 
 /**************************************************************************************/
 /* Local prototypes */
@@ -71,6 +67,9 @@ int map_off_path = 0;
 static inline void stage_process_op(Op*);
 static inline Flag map_fetch_fill_op(Stage_Data* src_sd, int* fetch_idx);
 static inline void shift_ops_to_arr_start(Stage_Data* sd);
+static Stage_Data* map_stage_src(Stage_Data* dec_src_sd,
+                                 Stage_Data* uopq_src_sd,
+                                 Stage_Data** other_sd);
 
 /**************************************************************************************/
 /* set_map_stage: */
@@ -91,7 +90,8 @@ void init_map_stage(uns8 proc_id, const char* name) {
   DEBUG(proc_id, "Initializing %s stage\n", name);
 
   memset(map, 0, sizeof(Map_Stage));
-  map->proc_id = proc_id;
+  map->proc_id     = proc_id;
+  map->next_op_num = 1;
 
   map->sds = (Stage_Data*)malloc(sizeof(Stage_Data) * STAGE_MAX_DEPTH);
   for(ii = 0; ii < STAGE_MAX_DEPTH; ii++) {
@@ -130,7 +130,7 @@ void reset_map_stage() {
 
 void recover_map_stage() {
   uns ii, jj, kk;
-  map_off_path = 0;
+  map->off_path = FALSE;
   ASSERT(0, map);
   for(ii = 0; ii < STAGE_MAX_DEPTH; ii++) {
     Stage_Data* cur = &map->sds[ii];
@@ -151,9 +151,9 @@ void recover_map_stage() {
     }
   }
 
-  if (map_stage_next_op_num > bp_recovery_info->recovery_op_num) {
-    map_stage_next_op_num = bp_recovery_info->recovery_op_num + 1;
-    DEBUG(map->proc_id, "Recovering map_stage_next_op_num to %llu\n", map_stage_next_op_num);
+  if (map->next_op_num > bp_recovery_info->recovery_op_num) {
+    map->next_op_num = bp_recovery_info->recovery_op_num + 1;
+    DEBUG(map->proc_id, "Recovering map->next_op_num to %llu\n", map->next_op_num);
   }
 }
 
@@ -204,32 +204,14 @@ void update_map_stage(Stage_Data* dec_src_sd, Stage_Data* uopq_src_sd) {
   // via the uop queue.
   // Only consume if older ops have already been consumed by this stage.
   cur = &map->sds[STAGE_MAX_DEPTH - 1];
+  consume_from_sd = map_stage_src(dec_src_sd, uopq_src_sd, &other_sd);
   if (UOP_CACHE_ENABLE) {
-    // When the uop cache is enabled, the next op to be consumed by the map stage
-    // is from either the decode stage or the uop cache source.
-    // The uop cache source is either the uop queue or the icache stage uopc stage data bypassing the uop queue.
     // The map stage may consume multiple ops in one cycle from both
     // the map stage and the uop cache source if allowed.
-    ASSERT(map->proc_id, uopq_src_sd != NULL);
-    if (dec_src_sd->op_count && dec_src_sd->ops[0]->op_num == map_stage_next_op_num) {
-      consume_from_sd = dec_src_sd;
-      other_sd = uopq_src_sd;  //can only consume ALL ops from this stage if the other sd has them ready. Otherwise only the first few
-    } else if (uopq_src_sd->op_count && uopq_src_sd->ops[0]->op_num == map_stage_next_op_num) {
-      consume_from_sd = uopq_src_sd;
-      other_sd = dec_src_sd;
-    }
     fetch_from_both_srcs = MAP_CONSUME_FROM_BOTH_SRCS && cur->max_op_count >= consume_from_sd->op_count + other_sd->op_count;
-  } else {
-    // When the uop cache is disabled, the next op to be consumed by the map stage
-    // is from the decode stage.
-    ASSERT(map->proc_id, uopq_src_sd == NULL);
-    if (dec_src_sd->op_count) {
-      ASSERT(map->proc_id, dec_src_sd->ops[0]->op_num == map_stage_next_op_num);
-      consume_from_sd = dec_src_sd;
-    }
   }
 
-  if(!map_off_path) {
+  if(!map->off_path) {
     if(stall)
       STAT_EVENT(map->proc_id, MAP_STAGE_STALLED);
     else
@@ -259,11 +241,11 @@ void update_map_stage(Stage_Data* dec_src_sd, Stage_Data* uopq_src_sd) {
     for(int ii = 0; ii < cur->op_count; ii++) {
       Op* op = cur->ops[ii];
       if (op && op->off_path)
-        map_off_path = 1;
+        map->off_path = TRUE;
     }
     // Probably should count number of on-path ops. 
     // Any stage can receive a mix of on/off-path ops in a single cycle.
-    if (!map_off_path)
+    if (!map->off_path)
       STAT_EVENT(map->proc_id, MAP_STAGE_RECEIVED_OPS_0 + cur->op_count);
     ASSERT(map->proc_id, cur->op_count <= MAP_STAGE_RECEIVED_OPS_MAX);
   }
@@ -285,6 +267,73 @@ void update_map_stage(Stage_Data* dec_src_sd, Stage_Data* uopq_src_sd) {
 }
 
 
+/**************************************************************************************/
+/* map_stage_src: the stage data the next op to map comes from, or NULL if it
+ * is not there yet. other_sd gets the other source when the uop cache is on. */
+
+static Stage_Data* map_stage_src(Stage_Data* dec_src_sd,
+                                 Stage_Data* uopq_src_sd,
+                                 Stage_Data** other_sd) {
+  if (UOP_CACHE_ENABLE) {
+    // When the uop cache is enabled, the next op to be consumed by the map stage
+    // is from either the decode stage or the uop cache source.
+    // The uop cache source is either the uop queue or the icache stage uopc stage data bypassing the uop queue.
+    ASSERT(map->proc_id, uopq_src_sd != NULL);
+    if (dec_src_sd->op_count && dec_src_sd->ops[0]->op_num == map->next_op_num) {
+      *other_sd = uopq_src_sd;  //can only consume ALL ops from this stage if the other sd has them ready. Otherwise only the first few
+      return dec_src_sd;
+    } else if (uopq_src_sd->op_count && uopq_src_sd->ops[0]->op_num == map->next_op_num) {
+      *other_sd = dec_src_sd;
+      return uopq_src_sd;
+    }
+  } else {
+    // When the uop cache is disabled, the next op to be consumed by the map stage
+    // is from the decode stage.
+    ASSERT(map->proc_id, uopq_src_sd == NULL);
+    if (dec_src_sd->op_count) {
+      ASSERT(map->proc_id, dec_src_sd->ops[0]->op_num == map->next_op_num);
+      return dec_src_sd;
+    }
+  }
+  return NULL;
+}
+
+
+/**************************************************************************************/
+/* map_stage_is_idle: update_map_stage() would move no op */
+
+Flag map_stage_is_idle(Stage_Data* dec_src_sd, Stage_Data* uopq_src_sd) {
+  Stage_Data* other_sd = NULL;
+  for(uns ii = 0; ii < STAGE_MAX_DEPTH - 1; ii++) {
+    if(!map->sds[ii].op_count && map->sds[ii + 1].op_count)
+      return FALSE;
+  }
+  return map->sds[STAGE_MAX_DEPTH - 1].op_count ||
+         !map_stage_src(dec_src_sd, uopq_src_sd, &other_sd);
+}
+
+
+/**************************************************************************************/
+/* map_idle_cycles: what update_map_stage() does over the given number of
+ * cycles in which map_stage_is_idle() holds */
+
+void map_idle_cycles(Stage_Data* dec_src_sd, Stage_Data* uopq_src_sd,
+                     Counter cycles) {
+  Stage_Data* other_sd = NULL;
+  if(!map->off_path) {
+    if(map->last_sd->op_count > 0)
+      INC_STAT_EVENT(map->proc_id, MAP_STAGE_STALLED, cycles);
+    else
+      INC_STAT_EVENT(map->proc_id, MAP_STAGE_NOT_STALLED, cycles);
+    if(map_stage_src(dec_src_sd, uopq_src_sd, &other_sd) == NULL)
+      INC_STAT_EVENT(map->proc_id, MAP_STAGE_STARVED, cycles);
+    else
+      INC_STAT_EVENT(map->proc_id, MAP_STAGE_NOT_STARVED, cycles);
+  } else
+    INC_STAT_EVENT(map->proc_id, MAP_STAGE_OFF_PATH, cycles);
+}
+
+
 /**************************************************************************************/
 /* map_process_op: */
 
@@ -304,14 +353,14 @@ static inline Flag map_fetch_fill_op(Stage_Data* src_sd, int* fetch_idx) {
 
   Op* op = src_sd->ops[*fetch_idx];
 
-  if (op && op->op_num == map_stage_next_op_num) {
+  if (op && op->op_num == map->next_op_num) {
     DEBUG(map->proc_id, "Fetching opnum=%llu from %s at idx=%i\n", op->op_num, src_sd->name, *fetch_idx);
     if (!op->decode_cycle) decode_stage_process_op(op);
     op->map_cycle = cycle_count;
     dest_sd->ops[dest_sd->op_count++] = op;
     src_sd->ops[*fetch_idx] = NULL;
     src_sd->op_count--;
-    map_stage_next_op_num++;
+    map->next_op_num++;
     *fetch_idx = *fetch_idx + 1;
     return TRUE;
   }
@@ -41,13 +41,17 @@ typedef struct Map_Stage_struct {
                         * allocated number of pipe stages) */
   Stage_Data* last_sd; /* pointer to last decode pipeline stage
                         * (for passing ops to map) */
+  Counter next_op_num; /* next op to consume, used when deciding whether to
+                        * consume ops from the uop cache: i.e. check if any
+                        * preceding instructions are still in the decoder */
+  Flag off_path;       /* an off-path op was mapped since the last recovery */
 } Map_Stage;
 
 
 /**************************************************************************************/
 /* External Variables */
 
-extern Map_Stage* map;
+extern __thread Map_Stage* map;
 
 
 /**************************************************************************************/
@@ -60,6 +64,9 @@ void reset_map_stage(void);
 void recover_map_stage(void);
 void debug_map_stage(void);
 void update_map_stage(Stage_Data* dec_src_sd, Stage_Data* uop_queue_src_sd);
+Flag map_stage_is_idle(Stage_Data* dec_src_sd, Stage_Data* uop_queue_src_sd);
+void map_idle_cycles(Stage_Data* dec_src_sd, Stage_Data* uop_queue_src_sd,
+                     Counter cycles);
 
 
 /**************************************************************************************/
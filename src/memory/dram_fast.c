@@ -0,0 +1,965 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/dram_fast.c
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : Fast DRAM latency model. Addresses are mapped to channels,
+ *                banks and rows the way Ramulator maps them (RoBaRaCoCh).
+ *                Each bank keeps its open row and a list of waiting requests,
+ *                and is only looked at when it can take a new request: it
+ *                picks a row hit (at most DRAM_FAST_ROW_HIT_CAP in a row) or
+ *                else its oldest request, of the type the channel is draining
+ *                (writes between Ramulator's write queue watermarks, reads
+ *                otherwise). The request then pays tRP/tRCD according to the
+ *                open row and books the first free burst on the channel's
+ *                data bus. A DRAM cycle with nothing to do costs a heap peek.
+ *
+ *                What this does not model (command bus conflicts, tFAW,
+ *                refresh, write to read turnarounds, scheduling across banks)
+ *                is folded into a read latency of DRAM_FAST_LATENCY_OFFSET +
+ *                DRAM_FAST_LOAD_FACTOR * u / (1 - u), where u is the channel's
+ *                recent data bus utilization. Both terms can be fit to the
+ *                ramulator.stat.out of Ramulator runs of the same DRAM
+ *                configuration (DRAM_FAST_FIT_STATS): the load of each channel
+ *                in the stats is replayed through this model, and the terms
+ *                are fit to how much slower Ramulator was at each load.
+ ***************************************************************************************/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "debug/debug_macros.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "libs/hash_lib.h"
+#include "memory/dram_fast.h"
+#include "memory/memory.h"
+
+#include "debug/debug.param.h"
+#include "memory/memory.param.h"
+#include "power/power.param.h"
+#include "ramulator.param.h"
+#include "statistics.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_MEMORY, ##args)
+
+// An instruction and a data fetch can wait on the same line
+#define DRAM_FAST_MAX_SAME_ADDR_READS 2
+// Same as Ramulator's FR-FCFS schedulers
+#define DRAM_FAST_ROW_HIT_CAP 16
+#define DRAM_FAST_WR_HIGH_WATERMARK 0.8
+#define DRAM_FAST_WR_LOW_WATERMARK 0.2
+// DRAM cycles ahead that the data bus can be booked
+#define DRAM_FAST_BUS_HORIZON 4096
+// Largest channel id read from a fitted stat file
+#define DRAM_FAST_FIT_MAX_CHANNELS 64
+// Requests replayed per fitted channel
+#define DRAM_FAST_FIT_REQS 20000
+// Utilization at which the load term stops growing
+#define DRAM_FAST_MAX_UTIL 0.8
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Dram_Fast_Access_struct {
+  Addr    addr;
+  Addr    row;
+  Counter arrival_cycle;
+  uns     proc_id;
+  Flag    is_write;
+
+  struct Dram_Fast_Access_struct* next;
+} Dram_Fast_Access;
+
+typedef struct Dram_Fast_Bank_struct {
+  Flag              row_open;
+  Addr              row;
+  uns               row_hits;     // hits served since the row was opened
+  Counter           act_cycle;    // when the open row was activated
+  Counter           ready_cycle;  // when the bank can take its next command
+  Flag              scheduled;    // an event will look at the bank
+  Dram_Fast_Access* head;         // waiting requests, oldest first
+  Dram_Fast_Access* tail;
+} Dram_Fast_Bank;
+
+typedef struct Dram_Fast_Channel_struct {
+  Dram_Fast_Bank* banks;
+  uns             num_reads;  // waiting for a bank
+  uns             num_writes;
+  Flag            write_mode;
+
+  /* data bus bookings, by cycle modulo DRAM_FAST_BUS_HORIZON */
+  uns8*   bus_busy;
+  Counter bus_clear_cycle;  // bookings before this cycle have been cleared
+
+  /* data bus utilization of the last DRAM_FAST_UTIL_WINDOW cycles */
+  Counter window_start;
+  Counter window_busy;
+  double  util;
+} Dram_Fast_Channel;
+
+// Either a read that leaves DRAM or a bank that can take a new request
+typedef struct Dram_Fast_Event_struct {
+  Counter           cycle;
+  Counter           seq;     // events of the same cycle happen in order
+  Dram_Fast_Access* access;  // the read, NULL for a bank event
+  uns               channel;
+  uns               bank;
+} Dram_Fast_Event;
+
+// The Scarab requests waiting on one read, in the order they arrived
+typedef struct Dram_Fast_Read_struct {
+  Mem_Req* reqs[DRAM_FAST_MAX_SAME_ADDR_READS];
+  uns      num_reqs;
+} Dram_Fast_Read;
+
+// Weighted sums of (utilization, latency residual) points
+typedef struct Dram_Fast_Fit_struct {
+  double sw, su, sr, suu, sur;
+  double row_hits, reads;
+  uns    num_points;
+} Dram_Fast_Fit;
+
+/**************************************************************************************/
+/* Global variables */
+
+static Dram_Fast_Channel* dram_fast_channels;
+static uns                dram_fast_num_banks;
+static uns                dram_fast_tx_bits;
+static uns                dram_fast_channel_bits;
+static uns                dram_fast_col_bits;
+static uns                dram_fast_bank_bits;
+
+static Counter dram_fast_cycle;
+static Counter dram_fast_seq;
+static double  dram_fast_latency_offset;
+static double  dram_fast_load_factor;
+
+/* replaying the load of a fitted channel: no stats, no Scarab requests */
+static Flag    dram_fast_fitting;
+static double  dram_fast_fit_latency;
+static Counter dram_fast_fit_reads;
+
+static Dram_Fast_Event* dram_fast_events;  // min-heap on (cycle, seq)
+static uns              dram_fast_num_events;
+static uns              dram_fast_max_events;
+
+static Dram_Fast_Access* dram_fast_free_accesses;
+
+static Hash_Table dram_fast_reads;  // Dram_Fast_Read by physical address
+
+// Addresses of finished reads whose requests are not all completed, in the
+// order they finished
+static Addr* dram_fast_done_reads;
+static uns   dram_fast_done_head;
+static uns   dram_fast_num_done;
+static uns   dram_fast_max_done;
+
+/**************************************************************************************/
+/* Prototypes */
+
+static void    dram_fast_fit(void);
+static void    dram_fast_fit_file(const char* file, Dram_Fast_Fit* fit);
+static double  dram_fast_replay(double rate, double write_frac,
+                                double hit_rate);
+static void    dram_fast_reset(void);
+static double  dram_fast_load(double util);
+static Flag    dram_fast_stat_channel(const char* name, const char* prefix,
+                                      const char* suffix, uns* channel);
+static void    dram_fast_map(Addr addr, uns* channel, uns* bank, Addr* row);
+static void    dram_fast_enqueue(uns channel_id, uns bank_id, Addr row,
+                                 Addr addr, Flag is_write, uns proc_id);
+static void    dram_fast_schedule_bank(uns channel_id, uns bank_id);
+static void    dram_fast_update_mode(uns channel_id);
+static void    dram_fast_issue(uns channel_id, uns bank_id);
+static void    dram_fast_process_events(void);
+static Counter dram_fast_book_bus(Dram_Fast_Channel* channel, Counter earliest);
+static void    dram_fast_push_event(Dram_Fast_Event* event);
+static void    dram_fast_pop_event(Dram_Fast_Event* event);
+static void    dram_fast_push_done(Addr addr);
+static Flag    dram_fast_complete(Mem_Req* req);
+static Flag    dram_fast_inst_req(Mem_Req_Type type);
+static Flag    dram_fast_data_req(Mem_Req_Type type);
+
+/**************************************************************************************/
+/* dram_fast_init: */
+
+void dram_fast_init(void) {
+  ASSERTM(0, ICACHE_LINE_SIZE == DCACHE_LINE_SIZE,
+          "The fast DRAM model supports only equal instruction and data "
+          "cache line sizes\n");
+  ASSERTM(0, !POWER_INTF_ON,
+          "The power model needs the DRAM chip organization from Ramulator\n");
+
+  dram_fast_num_banks = RAMULATOR_RANKS * RAMULATOR_BANKGROUPS *
+                        RAMULATOR_BANKS;
+  ASSERTM(0, (RAMULATOR_CHANNELS & (RAMULATOR_CHANNELS - 1)) == 0,
+          "RAMULATOR_CHANNELS must be a power of two\n");
+  ASSERTM(0, (dram_fast_num_banks & (dram_fast_num_banks - 1)) == 0,
+          "The number of banks per channel must be a power of two\n");
+  ASSERTM(0,
+          DCACHE_LINE_SIZE >= BUS_WIDTH_IN_BYTES &&
+            DCACHE_LINE_SIZE / BUS_WIDTH_IN_BYTES <= RAMULATOR_COLS,
+          "A cache line must be a whole number of bursts within a row\n");
+
+  dram_fast_tx_bits      = LOG2(DCACHE_LINE_SIZE);
+  dram_fast_channel_bits = LOG2(RAMULATOR_CHANNELS);
+  dram_fast_col_bits     = LOG2(RAMULATOR_COLS) -
+                       LOG2(DCACHE_LINE_SIZE / BUS_WIDTH_IN_BYTES);
+  dram_fast_bank_bits = LOG2(dram_fast_num_banks);
+
+  dram_fast_channels = (Dram_Fast_Channel*)calloc(RAMULATOR_CHANNELS,
+                                                  sizeof(Dram_Fast_Channel));
+  for(uns ii = 0; ii < RAMULATOR_CHANNELS; ii++) {
+    dram_fast_channels[ii].banks = (Dram_Fast_Bank*)calloc(
+      dram_fast_num_banks, sizeof(Dram_Fast_Bank));
+    dram_fast_channels[ii].bus_busy = (uns8*)calloc(DRAM_FAST_BUS_HORIZON,
+                                                    sizeof(uns8));
+  }
+
+  dram_fast_max_events = RAMULATOR_CHANNELS * (dram_fast_num_banks +
+                                               RAMULATOR_READQ_ENTRIES);
+  dram_fast_events = (Dram_Fast_Event*)malloc(sizeof(Dram_Fast_Event) *
+                                               dram_fast_max_events);
+  dram_fast_max_done   = RAMULATOR_CHANNELS * RAMULATOR_READQ_ENTRIES;
+  dram_fast_done_reads = (Addr*)malloc(sizeof(Addr) * dram_fast_max_done);
+
+  init_hash_table(&dram_fast_reads, "Fast DRAM model reads",
+                  RAMULATOR_CHANNELS * RAMULATOR_READQ_ENTRIES,
+                  sizeof(Dram_Fast_Read));
+
+  if(DRAM_FAST_FIT_STATS) {
+    // the replays measure the model without the terms being fit
+    dram_fast_latency_offset = 0;
+    dram_fast_load_factor    = 0;
+    dram_fast_fit();
+    dram_fast_reset();
+  } else {
+    dram_fast_latency_offset = DRAM_FAST_LATENCY_OFFSET;
+    dram_fast_load_factor    = DRAM_FAST_LOAD_FACTOR;
+  }
+}
+
+
+/**************************************************************************************/
+/* dram_fast_finish: */
+
+void dram_fast_finish(void) {
+  for(uns ii = 0; ii < RAMULATOR_CHANNELS; ii++) {
+    free(dram_fast_channels[ii].banks);
+    free(dram_fast_channels[ii].bus_busy);
+  }
+  free(dram_fast_channels);
+  free(dram_fast_events);
+  free(dram_fast_done_reads);
+  while(dram_fast_free_accesses) {
+    Dram_Fast_Access* next = dram_fast_free_accesses->next;
+    free(dram_fast_free_accesses);
+    dram_fast_free_accesses = next;
+  }
+}
+
+
+/**************************************************************************************/
+/* dram_fast_fit: Fits the latency offset and load factor to the Ramulator stat
+   files in DRAM_FAST_FIT_STATS (comma separated). Each channel of each file is
+   one point: its read latency, less the read latency of this model under the
+   same request rate, write share and read row hit rate, is the residual that
+   is fit as offset + factor * dram_fast_load(utilization), weighted by
+   reads. */
+
+static void dram_fast_fit(void) {
+  Dram_Fast_Fit fit;
+  char*         files = strdup(DRAM_FAST_FIT_STATS);
+
+  memset(&fit, 0, sizeof(fit));
+  for(char* file = strtok(files, ","); file; file = strtok(NULL, ","))
+    dram_fast_fit_file(file, &fit);
+  free(files);
+
+  if(fit.sw == 0)
+    FATAL_ERROR(0, "No DRAM reads found in DRAM_FAST_FIT_STATS (%s)\n",
+                DRAM_FAST_FIT_STATS);
+
+  double mean_u = fit.su / fit.sw;
+  double mean_r = fit.sr / fit.sw;
+  double var_u  = fit.suu / fit.sw - mean_u * mean_u;
+  // one load level only gives an offset
+  dram_fast_load_factor    = var_u > 1e-9 ?
+                               (fit.sur / fit.sw - mean_u * mean_r) / var_u :
+                               0.0;
+  dram_fast_latency_offset = mean_r - dram_fast_load_factor * mean_u;
+
+  fprintf(mystdout,
+          "** Fast DRAM model fit to %u channel(s): row hit rate %.3f, "
+          "--dram_fast_latency_offset=%.2f --dram_fast_load_factor=%.2f\n",
+          fit.num_points, fit.row_hits / fit.reads, dram_fast_latency_offset,
+          dram_fast_load_factor);
+}
+
+
+/**************************************************************************************/
+/* dram_fast_fit_file: */
+
+static void dram_fast_fit_file(const char* file, Dram_Fast_Fit* fit) {
+  double hits[DRAM_FAST_FIT_MAX_CHANNELS]      = {0};
+  double misses[DRAM_FAST_FIT_MAX_CHANNELS]    = {0};
+  double conflicts[DRAM_FAST_FIT_MAX_CHANNELS] = {0};
+  double accesses[DRAM_FAST_FIT_MAX_CHANNELS]  = {0};  // reads and writes
+  double latency[DRAM_FAST_FIT_MAX_CHANNELS]   = {0};
+  double cycles                                = 0;
+  char   line[1024];
+  char   name[256];
+  double value;
+  uns    channel;
+  FILE*  fp = fopen(file, "r");
+
+  if(!fp)
+    FATAL_ERROR(0, "Could not open Ramulator stat file %s\n", file);
+
+  // Per core breakdowns are on lines of their own that start with [core]
+  while(fgets(line, sizeof(line), fp)) {
+    if(sscanf(line, "%255s %lf", name, &value) != 2)
+      continue;
+    if(!strcmp(name, "ramulator.dram_cycles"))
+      cycles = value;
+    else if(dram_fast_stat_channel(name, "ramulator.read_row_hits_channel_",
+                                   "_core", &channel))
+      hits[channel] = value;
+    else if(dram_fast_stat_channel(name, "ramulator.read_row_misses_channel_",
+                                   "_core", &channel))
+      misses[channel] = value;
+    else if(dram_fast_stat_channel(
+              name, "ramulator.read_row_conflicts_channel_", "_core", &channel))
+      conflicts[channel] = value;
+    else if(dram_fast_stat_channel(name, "ramulator.row_hits_channel_",
+                                   "_core", &channel) ||
+            dram_fast_stat_channel(name, "ramulator.row_misses_channel_",
+                                   "_core", &channel) ||
+            dram_fast_stat_channel(name, "ramulator.row_conflicts_channel_",
+                                   "_core", &channel))
+      accesses[channel] += value;
+    else if(dram_fast_stat_channel(name, "ramulator.read_latency_avg_", "",
+                                   &channel))
+      latency[channel] = value;
+  }
+  fclose(fp);
+
+  ASSERTM(0, cycles > 0, "No ramulator.dram_cycles in %s\n", file);
+  for(uns ii = 0; ii < DRAM_FAST_FIT_MAX_CHANNELS; ii++) {
+    double reads = hits[ii] + misses[ii] + conflicts[ii];
+    if(reads == 0)
+      continue;
+    double rate     = MIN2(accesses[ii] / cycles, 1.0);
+    double load     = dram_fast_load(rate * RAMULATOR_TBL);
+    double residual = latency[ii] - dram_fast_replay(rate,
+                                                     1 - reads / accesses[ii],
+                                                     hits[ii] / reads);
+
+    fit->sw += reads;
+    fit->su += reads * load;
+    fit->sr += reads * residual;
+    fit->suu += reads * load * load;
+    fit->sur += reads * load * residual;
+    fit->row_hits += hits[ii];
+    fit->reads += reads;
+    fit->num_points++;
+  }
+}
+
+
+/**************************************************************************************/
+/* dram_fast_replay: Runs DRAM_FAST_FIT_REQS random requests through one
+   channel, arriving with the given probability each cycle to random banks, and
+   returns their average read latency. A request goes to the row last used in
+   its bank with probability hit_rate and to a new row otherwise. */
+
+static double dram_fast_replay(double rate, double write_frac,
+                               double hit_rate) {
+  Addr* bank_rows = (Addr*)calloc(dram_fast_num_banks, sizeof(Addr));
+  Addr  next_row  = 0;
+  uns   num_sent  = 0;
+  uns64 rng       = 88172645463325252ULL;  // xorshift64
+
+#define DRAM_FAST_RAND()                                        \
+  (rng ^= rng << 13, rng ^= rng >> 7, rng ^= rng << 17,         \
+   (double)(rng >> 11) / (double)(1ULL << 53))
+
+  dram_fast_reset();
+  dram_fast_fitting     = TRUE;
+  dram_fast_fit_latency = 0;
+  dram_fast_fit_reads   = 0;
+  while(num_sent < DRAM_FAST_FIT_REQS ||
+        dram_fast_channels[0].num_reads || dram_fast_num_events) {
+    if(num_sent < DRAM_FAST_FIT_REQS && DRAM_FAST_RAND() < rate) {
+      Flag is_write = DRAM_FAST_RAND() < write_frac;
+      uns  bank_id  = (uns)(DRAM_FAST_RAND() * dram_fast_num_banks);
+      if(DRAM_FAST_RAND() >= hit_rate)
+        bank_rows[bank_id] = ++next_row;
+      // a full queue holds the next request back, as in Scarab
+      if(is_write ? dram_fast_channels[0].num_writes <
+                      RAMULATOR_WRITEQ_ENTRIES :
+                    dram_fast_channels[0].num_reads < RAMULATOR_READQ_ENTRIES) {
+        dram_fast_enqueue(0, bank_id, bank_rows[bank_id], 0, is_write, 0);
+        num_sent++;
+      }
+    }
+    dram_fast_cycle++;
+    dram_fast_process_events();
+  }
+  dram_fast_fitting = FALSE;
+#undef DRAM_FAST_RAND
+
+  free(bank_rows);
+  return dram_fast_fit_reads ? dram_fast_fit_latency / dram_fast_fit_reads : 0;
+}
+
+
+/**************************************************************************************/
+/* dram_fast_reset: Empties the channels after a replay */
+
+static void dram_fast_reset(void) {
+  for(uns ii = 0; ii < RAMULATOR_CHANNELS; ii++) {
+    Dram_Fast_Channel* channel = &dram_fast_channels[ii];
+    for(uns jj = 0; jj < dram_fast_num_banks; jj++) {
+      Dram_Fast_Bank* bank = &channel->banks[jj];
+      if(bank->head) {
+        bank->tail->next        = dram_fast_free_accesses;
+        dram_fast_free_accesses = bank->head;
+      }
+    }
+    memset(channel->banks, 0, sizeof(Dram_Fast_Bank) * dram_fast_num_banks);
+    memset(channel->bus_busy, 0, DRAM_FAST_BUS_HORIZON);
+    channel->num_reads       = 0;
+    channel->num_writes      = 0;
+    channel->write_mode      = FALSE;
+    channel->bus_clear_cycle = 0;
+    channel->window_start    = 0;
+    channel->window_busy     = 0;
+    channel->util            = 0;
+  }
+  ASSERT(0, !dram_fast_num_events);
+  dram_fast_cycle = 0;
+  dram_fast_seq   = 0;
+}
+
+
+/**************************************************************************************/
+/* dram_fast_load: How a queue's wait grows with its utilization */
+
+static double dram_fast_load(double util) {
+  util = MIN2(util, DRAM_FAST_MAX_UTIL);
+  return util / (1 - util);
+}
+
+
+/**************************************************************************************/
+/* dram_fast_stat_channel: Matches a per channel stat name, prefix<channel>suffix */
+
+static Flag dram_fast_stat_channel(const char* name, const char* prefix,
+                                   const char* suffix, uns* channel) {
+  size_t len = strlen(prefix);
+  char*  end;
+
+  if(strncmp(name, prefix, len) || !isdigit((unsigned char)name[len]))
+    return FALSE;
+  unsigned long id = strtoul(name + len, &end, 10);
+  if(strcmp(end, suffix) || id >= DRAM_FAST_FIT_MAX_CHANNELS)
+    return FALSE;
+  *channel = id;
+  return TRUE;
+}
+
+
+/**************************************************************************************/
+/* dram_fast_map: the bits Ramulator's RoBaRaCoCh mapping takes, from the
+   bottom: the line offset, channel, column, rank, bank group, bank, and the
+   rest of the address as the row. The model does not tell the ranks and bank
+   groups apart, so the rank, bank group and bank bits together form a flat
+   bank index, with the rank in its low bits. */
+
+static void dram_fast_map(Addr addr, uns* channel, uns* bank, Addr* row) {
+  addr >>= dram_fast_tx_bits;
+  *channel = addr & N_BIT_MASK(dram_fast_channel_bits);
+  addr >>= dram_fast_channel_bits + dram_fast_col_bits;
+  *bank = addr & N_BIT_MASK(dram_fast_bank_bits);
+  *row  = addr >> dram_fast_bank_bits;
+}
+
+
+/**************************************************************************************/
+/* dram_fast_send: Same contract as ramulator_send() */
+
+int dram_fast_send(Mem_Req* req) {
+  Flag            is_write = req->type == MRT_WB;
+  Addr            addr     = req->phys_addr;
+  Dram_Fast_Read* read;
+  uns             channel_id, bank_id;
+  Addr            row;
+
+  ASSERTM(req->proc_id, req->state == MRS_MEM_NEW,
+          "A request in state %d cannot be issued to DRAM\n", req->state);
+
+  if(!is_write) {
+    read = (Dram_Fast_Read*)hash_table_access(&dram_fast_reads, addr);
+    if(read) {
+      DEBUG(req->proc_id, "Fast DRAM: Duplicate (%s) request to address %llx\n",
+            Mem_Req_Type_str(req->type), req->addr);
+      ASSERT(req->proc_id, read->num_reqs < DRAM_FAST_MAX_SAME_ADDR_READS);
+      read->reqs[read->num_reqs++] = req;
+      req->mem_queue_cycle         = cycle_count;
+      return TRUE;
+    }
+  }
+
+  dram_fast_map(addr, &channel_id, &bank_id, &row);
+  Dram_Fast_Channel* channel = &dram_fast_channels[channel_id];
+  if(is_write ? channel->num_writes >= RAMULATOR_WRITEQ_ENTRIES :
+                channel->num_reads >= RAMULATOR_READQ_ENTRIES) {
+    DEBUG(req->proc_id, "Fast DRAM: The request has been rejected.\n");
+    STAT_EVENT(req->proc_id, DRAM_FAST_QUEUE_FULL);
+    return FALSE;
+  }
+
+  STAT_EVENT(req->proc_id, POWER_MEMORY_CTRL_ACCESS);
+  if(is_write) {
+    STAT_EVENT(req->proc_id, POWER_MEMORY_CTRL_WRITE);
+  } else {
+    STAT_EVENT(req->proc_id, POWER_MEMORY_CTRL_READ);
+
+    Flag new_entry;
+    read = (Dram_Fast_Read*)hash_table_access_create(&dram_fast_reads, addr,
+                                                     &new_entry);
+    ASSERT(req->proc_id, new_entry);
+    read->reqs[0]  = req;
+    read->num_reqs = 1;
+  }
+  dram_fast_enqueue(channel_id, bank_id, row, addr, is_write, req->proc_id);
+
+  DEBUG(req->proc_id, "Fast DRAM: The request has been enqueued.\n");
+  req->mem_queue_cycle = cycle_count;
+  return TRUE;
+}
+
+
+/**************************************************************************************/
+/* dram_fast_tick: Handles the events of this DRAM cycle and, like Ramulator,
+   completes at most one finished read per cycle */
+
+void dram_fast_tick(void) {
+  dram_fast_cycle++;
+  dram_fast_process_events();
+
+  if(dram_fast_num_done) {
+    Addr            addr = dram_fast_done_reads[dram_fast_done_head];
+    Dram_Fast_Read* read = (Dram_Fast_Read*)hash_table_access(&dram_fast_reads,
+                                                              addr);
+    ASSERT(0, read && read->num_reqs);
+    if(dram_fast_complete(read->reqs[0])) {
+      for(uns ii = 1; ii < read->num_reqs; ii++)
+        read->reqs[ii - 1] = read->reqs[ii];
+      if(--read->num_reqs == 0) {
+        hash_table_access_delete(&dram_fast_reads, addr);
+        dram_fast_done_head = (dram_fast_done_head + 1) % dram_fast_max_done;
+        dram_fast_num_done--;
+      }
+    }
+  }
+}
+
+
+/**************************************************************************************/
+/* dram_fast_search_queue: Same contract as ramulator_search_queue() */
+
+Mem_Req* dram_fast_search_queue(Addr phys_addr, Mem_Req_Type type) {
+  ASSERTM(0,
+          dram_fast_inst_req(type) || dram_fast_data_req(type) ||
+            type == MRT_MIN_PRIORITY,
+          "Fast DRAM: Cannot search for write requests\n");
+  Dram_Fast_Read* read = (Dram_Fast_Read*)hash_table_access(&dram_fast_reads,
+                                                            phys_addr);
+  if(!read)
+    return NULL;
+
+  for(uns ii = 0; ii < read->num_reqs; ii++) {
+    Mem_Req* req = read->reqs[ii];
+    if((dram_fast_inst_req(req->type) && dram_fast_inst_req(type)) ||
+       (dram_fast_data_req(req->type) && dram_fast_data_req(type)))
+      return req;
+  }
+  return NULL;
+}
+
+
+/**************************************************************************************/
+/* dram_fast_enqueue: Adds a request to its bank's waiting list */
+
+static void dram_fast_enqueue(uns channel_id, uns bank_id, Addr row,
+                              Addr addr, Flag is_write, uns proc_id) {
+  Dram_Fast_Channel* channel = &dram_fast_channels[channel_id];
+  Dram_Fast_Bank*    bank    = &channel->banks[bank_id];
+  Dram_Fast_Access*  access;
+
+  if(dram_fast_free_accesses) {
+    access                  = dram_fast_free_accesses;
+    dram_fast_free_accesses = access->next;
+  } else {
+    access = (Dram_Fast_Access*)malloc(sizeof(Dram_Fast_Access));
+  }
+  access->addr          = addr;
+  access->row           = row;
+  access->arrival_cycle = dram_fast_cycle;
+  access->proc_id       = proc_id;
+  access->is_write      = is_write;
+  access->next          = NULL;
+  if(bank->tail)
+    bank->tail->next = access;
+  else
+    bank->head = access;
+  bank->tail = access;
+
+  if(is_write)
+    channel->num_writes++;
+  else
+    channel->num_reads++;
+  dram_fast_update_mode(channel_id);
+  dram_fast_schedule_bank(channel_id, bank_id);
+}
+
+
+/**************************************************************************************/
+/* dram_fast_process_events: Handles the events up to this DRAM cycle */
+
+static void dram_fast_process_events(void) {
+  Dram_Fast_Event event;
+
+  while(dram_fast_num_events && dram_fast_events[0].cycle <= dram_fast_cycle) {
+    dram_fast_pop_event(&event);
+    if(!event.access) {
+      dram_fast_issue(event.channel, event.bank);
+      continue;
+    }
+    Counter latency = event.cycle - event.access->arrival_cycle;
+    if(dram_fast_fitting) {
+      dram_fast_fit_latency += latency;
+      dram_fast_fit_reads++;
+    } else {
+      STAT_EVENT(event.access->proc_id, DRAM_FAST_READS);
+      INC_STAT_EVENT(event.access->proc_id, DRAM_FAST_READ_LATENCY, latency);
+      dram_fast_push_done(event.access->addr);
+    }
+    event.access->next      = dram_fast_free_accesses;
+    dram_fast_free_accesses = event.access;
+  }
+}
+
+
+/**************************************************************************************/
+/* dram_fast_schedule_bank: Makes sure a bank with waiting requests gets looked
+   at once it can take a command */
+
+static void dram_fast_schedule_bank(uns channel_id, uns bank_id) {
+  Dram_Fast_Bank* bank = &dram_fast_channels[channel_id].banks[bank_id];
+  Dram_Fast_Event event;
+
+  if(bank->scheduled || !bank->head)
+    return;
+  event.cycle     = MAX2(bank->ready_cycle, dram_fast_cycle + 1);
+  event.seq       = dram_fast_seq++;
+  event.access    = NULL;
+  event.channel   = channel_id;
+  event.bank      = bank_id;
+  bank->scheduled = TRUE;
+  dram_fast_push_event(&event);
+}
+
+
+/**************************************************************************************/
+/* dram_fast_update_mode: Ramulator's switch between draining reads and
+   writes */
+
+static void dram_fast_update_mode(uns channel_id) {
+  Dram_Fast_Channel* channel    = &dram_fast_channels[channel_id];
+  Flag               write_mode = channel->write_mode;
+
+  if(!write_mode && channel->num_writes > (uns)(DRAM_FAST_WR_HIGH_WATERMARK *
+                                                RAMULATOR_WRITEQ_ENTRIES))
+    write_mode = TRUE;
+  else if(write_mode &&
+          channel->num_writes < (uns)(DRAM_FAST_WR_LOW_WATERMARK *
+                                      RAMULATOR_WRITEQ_ENTRIES) &&
+          channel->num_reads)
+    write_mode = FALSE;
+
+  if(write_mode != channel->write_mode) {
+    channel->write_mode = write_mode;
+    for(uns ii = 0; ii < dram_fast_num_banks; ii++)
+      dram_fast_schedule_bank(channel_id, ii);
+  }
+}
+
+
+/**************************************************************************************/
+/* dram_fast_issue: Starts the request a bank picks now, if any */
+
+static void dram_fast_issue(uns channel_id, uns bank_id) {
+  Dram_Fast_Channel* channel = &dram_fast_channels[channel_id];
+  Dram_Fast_Bank*    bank    = &channel->banks[bank_id];
+  Dram_Fast_Access * access = NULL, *access_prev = NULL, *prev = NULL;
+
+  bank->scheduled = FALSE;
+  for(Dram_Fast_Access* cur = bank->head; cur; prev = cur, cur = cur->next) {
+    if(cur->is_write != channel->write_mode)
+      continue;
+    if(bank->row_open && cur->row == bank->row &&
+       bank->row_hits < DRAM_FAST_ROW_HIT_CAP) {
+      access      = cur;
+      access_prev = prev;
+      break;
+    }
+    if(!access) {
+      access      = cur;
+      access_prev = prev;
+    }
+  }
+  if(!access)
+    return;  // waits for the channel to switch modes
+
+  if(access_prev)
+    access_prev->next = access->next;
+  else
+    bank->head = access->next;
+  if(bank->tail == access)
+    bank->tail = access_prev;
+  if(access->is_write)
+    channel->num_writes--;
+  else
+    channel->num_reads--;
+
+  Flag    hit         = bank->row_open && bank->row == access->row;
+  Flag    conflict    = bank->row_open && !hit;
+  Counter start       = dram_fast_cycle;
+  Counter cas         = start;
+  uns     cas_latency = access->is_write ? RAMULATOR_TCWL : RAMULATOR_TCL;
+  if(hit) {
+    bank->row_hits++;
+  } else {
+    if(conflict)
+      start = MAX2(start, bank->act_cycle + RAMULATOR_TRAS) + RAMULATOR_TRP;
+    bank->row_open  = TRUE;
+    bank->row       = access->row;
+    bank->row_hits  = 0;
+    bank->act_cycle = start;
+    cas             = start + RAMULATOR_TRCD;
+  }
+
+  if(!dram_fast_fitting) {
+    uns proc_id = access->proc_id;
+    if(hit) {
+      STAT_EVENT(proc_id, DRAM_FAST_ROW_HITS);
+    } else {
+      STAT_EVENT(proc_id,
+                 conflict ? DRAM_FAST_ROW_CONFLICTS : DRAM_FAST_ROW_MISSES);
+      if(conflict)
+        STAT_EVENT(proc_id, POWER_DRAM_PRECHARGE);
+      STAT_EVENT(proc_id, POWER_DRAM_ACTIVATE);
+    }
+    STAT_EVENT(proc_id, access->is_write ? POWER_DRAM_WRITE : POWER_DRAM_READ);
+  }
+
+  // the column command waits until its burst has the bus
+  Counter data      = dram_fast_book_bus(channel, cas + cas_latency);
+  bank->ready_cycle = data - cas_latency + RAMULATOR_TCCDL;
+
+  if(access->is_write) {
+    access->next            = dram_fast_free_accesses;
+    dram_fast_free_accesses = access;
+  } else {
+    Dram_Fast_Event event;
+    double          extra = dram_fast_latency_offset +
+                   dram_fast_load_factor * dram_fast_load(channel->util);
+    event.cycle = data + RAMULATOR_TBL + (extra > 0 ? (Counter)(extra + 0.5) :
+                                                      0);
+    event.seq     = dram_fast_seq++;
+    event.access  = access;
+    event.channel = channel_id;
+    event.bank    = bank_id;
+    dram_fast_push_event(&event);
+  }
+
+  dram_fast_update_mode(channel_id);
+  dram_fast_schedule_bank(channel_id, bank_id);
+}
+
+
+/**************************************************************************************/
+/* dram_fast_book_bus: Books the first free burst on the data bus that starts
+   no earlier than the given cycle, and returns its start */
+
+static Counter dram_fast_book_bus(Dram_Fast_Channel* channel,
+                                  Counter            earliest) {
+  Counter clear_end = dram_fast_cycle;
+
+  if(clear_end - channel->bus_clear_cycle > DRAM_FAST_BUS_HORIZON)
+    channel->bus_clear_cycle = clear_end - DRAM_FAST_BUS_HORIZON;
+  for(; channel->bus_clear_cycle < clear_end; channel->bus_clear_cycle++)
+    channel->bus_busy[channel->bus_clear_cycle % DRAM_FAST_BUS_HORIZON] = FALSE;
+
+  Counter data    = earliest;
+  uns     num_free = 0;  // free cycles from data on
+  while(num_free < RAMULATOR_TBL) {
+    if(channel->bus_busy[(data + num_free) % DRAM_FAST_BUS_HORIZON]) {
+      data += num_free + 1;
+      num_free = 0;
+    } else {
+      num_free++;
+    }
+  }
+  ASSERTM(0, data + RAMULATOR_TBL - dram_fast_cycle <= DRAM_FAST_BUS_HORIZON,
+          "Fast DRAM: The data bus is booked too far ahead\n");
+  for(uns ii = 0; ii < RAMULATOR_TBL; ii++)
+    channel->bus_busy[(data + ii) % DRAM_FAST_BUS_HORIZON] = TRUE;
+
+  if(dram_fast_cycle - channel->window_start >= DRAM_FAST_UTIL_WINDOW) {
+    channel->util = MIN2(1.0, (double)channel->window_busy /
+                                (dram_fast_cycle - channel->window_start));
+    channel->window_start = dram_fast_cycle;
+    channel->window_busy  = 0;
+  }
+  channel->window_busy += RAMULATOR_TBL;
+  return data;
+}
+
+
+/**************************************************************************************/
+/* dram_fast_push_event: */
+
+static void dram_fast_push_event(Dram_Fast_Event* event) {
+  if(dram_fast_num_events == dram_fast_max_events) {
+    dram_fast_max_events *= 2;
+    dram_fast_events = (Dram_Fast_Event*)realloc(
+      dram_fast_events, sizeof(Dram_Fast_Event) * dram_fast_max_events);
+  }
+
+  uns ii = dram_fast_num_events++;
+  while(ii > 0) {
+    uns              parent = (ii - 1) / 2;
+    Dram_Fast_Event* up     = &dram_fast_events[parent];
+    if(up->cycle < event->cycle ||
+       (up->cycle == event->cycle && up->seq < event->seq))
+      break;
+    dram_fast_events[ii] = *up;
+    ii                   = parent;
+  }
+  dram_fast_events[ii] = *event;
+}
+
+
+/**************************************************************************************/
+/* dram_fast_pop_event: */
+
+static void dram_fast_pop_event(Dram_Fast_Event* event) {
+  ASSERT(0, dram_fast_num_events);
+  *event               = dram_fast_events[0];
+  Dram_Fast_Event last = dram_fast_events[--dram_fast_num_events];
+
+  uns ii = 0;
+  while(TRUE) {
+    uns child = 2 * ii + 1;
+    if(child >= dram_fast_num_events)
+      break;
+    Dram_Fast_Event* left = &dram_fast_events[child];
+    if(child + 1 < dram_fast_num_events) {
+      Dram_Fast_Event* right = &dram_fast_events[child + 1];
+      if(right->cycle < left->cycle ||
+         (right->cycle == left->cycle && right->seq < left->seq))
+        child++;
+    }
+    Dram_Fast_Event* down = &dram_fast_events[child];
+    if(last.cycle < down->cycle ||
+       (last.cycle == down->cycle && last.seq < down->seq))
+      break;
+    dram_fast_events[ii] = *down;
+    ii                   = child;
+  }
+  dram_fast_events[ii] = last;
+}
+
+
+/**************************************************************************************/
+/* dram_fast_push_done: */
+
+static void dram_fast_push_done(Addr addr) {
+  if(dram_fast_num_done == dram_fast_max_done) {
+    Addr* grown = (Addr*)malloc(sizeof(Addr) * dram_fast_max_done * 2);
+    for(uns ii = 0; ii < dram_fast_num_done; ii++)
+      grown[ii] = dram_fast_done_reads[(dram_fast_done_head + ii) %
+                                       dram_fast_max_done];
+    free(dram_fast_done_reads);
+    dram_fast_done_reads = grown;
+    dram_fast_done_head  = 0;
+    dram_fast_max_done *= 2;
+  }
+  dram_fast_done_reads[(dram_fast_done_head + dram_fast_num_done) %
+                       dram_fast_max_done] = addr;
+  dram_fast_num_done++;
+}
+
+
+/**************************************************************************************/
+/* dram_fast_complete: Hands a finished read back to the memory system if the
+   L1 fill queue has room */
+
+static Flag dram_fast_complete(Mem_Req* req) {
+  if((uns)mem->l1fill_queue.entry_count >= MEM_L1_FILL_QUEUE_ENTRIES)
+    return FALSE;
+  DEBUG(req->proc_id, "Fast DRAM: Completing a (%s) request to address %llx\n",
+        Mem_Req_Type_str(req->type), req->addr);
+  mem_complete_bus_in_access(req, 0);
+  return TRUE;
+}
+
+
+/**************************************************************************************/
+/* dram_fast_inst_req: */
+
+static Flag dram_fast_inst_req(Mem_Req_Type type) {
+  return type == MRT_IFETCH || type == MRT_IPRF || type == MRT_FDIPPRFON ||
+         type == MRT_FDIPPRFOFF || type == MRT_UOCPRF;
+}
+
+
+/**************************************************************************************/
+/* dram_fast_data_req: */
+
+static Flag dram_fast_data_req(Mem_Req_Type type) {
+  return type == MRT_DFETCH || type == MRT_DPRF || type == MRT_DSTORE;
+}
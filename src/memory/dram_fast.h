@@ -0,0 +1,48 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/dram_fast.h
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : A fast DRAM latency model that can stand in for Ramulator
+ *                (DRAM_FAST_MODEL). It has the same interface as ramulator.h
+ *                and uses the same organization and timing parameters.
+ ***************************************************************************************/
+
+#ifndef __DRAM_FAST_H__
+#define __DRAM_FAST_H__
+
+#include "globals/global_types.h"
+#include "memory/memory.h"
+
+/**************************************************************************************/
+/* Prototypes */
+
+void dram_fast_init(void);
+void dram_fast_finish(void);
+
+int  dram_fast_send(Mem_Req* req);
+void dram_fast_tick(void);
+
+Mem_Req* dram_fast_search_queue(Addr phys_addr, Mem_Req_Type type);
+
+#endif /* #ifndef __DRAM_FAST_H__ */
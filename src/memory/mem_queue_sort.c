@@ -0,0 +1,135 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/mem_queue_sort.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Priority order of the memory queues
+ ***************************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "memory/mem_queue_sort.h"
+
+/**************************************************************************************/
+/* Global Variables */
+
+/* scratch space for mem_merge_runs() */
+static Mem_Queue_Entry* mem_sort_scratch      = NULL;
+static int              mem_sort_scratch_size = 0;
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static int  mem_queue_run_end(Mem_Queue_Entry* base, int start, int count);
+static void mem_merge_runs(Mem_Queue_Entry* base, int start, int mid, int end);
+
+/**************************************************************************************/
+/* mem_compare_priority: */
+
+int mem_compare_priority(const void* a, const void* b) {
+  Mem_Queue_Entry* e0        = (Mem_Queue_Entry*)a;
+  Mem_Queue_Entry* e1        = (Mem_Queue_Entry*)b;
+  Counter          priority0 = e0->priority;
+  Counter          priority1 = e1->priority;
+
+  if(priority0 < priority1)
+    return -1;
+  else if(priority1 < priority0)
+    return 1;
+  else
+    return 0;
+}
+
+/**************************************************************************************/
+/* mem_queue_run_end: end of the non-decreasing run that begins at start */
+
+static int mem_queue_run_end(Mem_Queue_Entry* base, int start, int count) {
+  int ii;
+  for(ii = start + 1; ii < count; ii++)
+    if(base[ii].priority < base[ii - 1].priority)
+      break;
+  return ii;
+}
+
+/**************************************************************************************/
+/* mem_merge_runs: stable merge of the sorted runs [start, mid) and [mid, end).
+ * Entries of the left run that already precede the whole right run stay in
+ * place. */
+
+static void mem_merge_runs(Mem_Queue_Entry* base, int start, int mid,
+                           int end) {
+  int lo = start, hi = mid;
+  while(lo < hi) {
+    int probe = lo + (hi - lo) / 2;
+    if(base[probe].priority <= base[mid].priority)
+      lo = probe + 1;
+    else
+      hi = probe;
+  }
+  start = lo;
+
+  if(mid - start > mem_sort_scratch_size) {
+    mem_sort_scratch_size = mid - start;
+    mem_sort_scratch      = (Mem_Queue_Entry*)realloc(
+      mem_sort_scratch, sizeof(Mem_Queue_Entry) * mem_sort_scratch_size);
+  }
+  memcpy(mem_sort_scratch, &base[start],
+         sizeof(Mem_Queue_Entry) * (mid - start));
+
+  int left = 0, left_end = mid - start, right = mid, dst = start;
+  while(left < left_end && right < end) {
+    if(base[right].priority < mem_sort_scratch[left].priority)
+      base[dst++] = base[right++];
+    else
+      base[dst++] = mem_sort_scratch[left++];
+  }
+  while(left < left_end)
+    base[dst++] = mem_sort_scratch[left++];
+}
+
+/**************************************************************************************/
+/* mem_queue_sort: orders a queue by priority. When a queue is re-sorted it is
+ * almost in order already: new entries were appended at the tail or a few
+ * entries were demoted to MRT_MIN_PRIORITY for removal. With run_sort
+ * (MEM_QUEUE_RUN_SORT) a stable natural merge sort only merges the existing
+ * sorted runs, which costs a single scan when the queue is already sorted, and
+ * entries of equal priority keep their queue order. */
+
+void mem_queue_sort(Mem_Queue_Entry* base, int count, Flag run_sort) {
+  if(!run_sort) {
+    qsort(base, count, sizeof(Mem_Queue_Entry), mem_compare_priority);
+    return;
+  }
+
+  while(mem_queue_run_end(base, 0, count) < count) {
+    int start = 0;
+    while(start < count) {
+      int mid = mem_queue_run_end(base, start, count);
+      if(mid == count)
+        break;
+      int end = mem_queue_run_end(base, mid, count);
+      mem_merge_runs(base, start, mid, end);
+      start = end;
+    }
+  }
+}
@@ -0,0 +1,54 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/mem_queue_sort.h
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Priority order of the memory queues. Kept apart from
+ *                memory.c so that src/test/mem_queue_sort_bench.c can time it.
+ ***************************************************************************************/
+
+#ifndef __MEM_QUEUE_SORT_H__
+#define __MEM_QUEUE_SORT_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Mem_Queue_Entry_struct {
+  int     reqbuf;   /* request buffer num */
+  Counter priority; /* priority of the miss */
+  Counter rdy_cycle;
+} Mem_Queue_Entry;
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* qsort() comparison of two Mem_Queue_Entry by priority */
+int mem_compare_priority(const void* a, const void* b);
+
+/* Orders count entries by priority, with qsort() or, if run_sort, by merging
+   the sorted runs they already form (stable) */
+void mem_queue_sort(Mem_Queue_Entry* base, int count, Flag run_sort);
+
+#endif /* #ifndef __MEM_QUEUE_SORT_H__ */
@@ -116,6 +116,10 @@ struct Mem_Req_struct {
   Addr                     addr;     /* address to fetch */
   Addr                     phys_addr;   /* physical address */
   uns                      size;        /* size to fetch */
+  int                      addr_index_next; /* next request in the same
+                                               address index bucket */
+  Flag                     addr_indexed; /* is the request in the address
+                                            index? */
   uns                      mlc_bank;    /* which MLC bank it is going to */
   uns                      l1_bank;     /* which l1 bank it is going to */
   uns                      mem_channel; /* mutiple channel support */
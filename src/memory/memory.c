@@ -50,6 +50,7 @@
 #include "debug/debug.param.h"
 #include "dvfs/perf_pred.h"
 #include "icache_stage.h"
+#include "map.h"
 #include "memory.param.h"
 #include "prefetcher//stream.param.h"
 #include "prefetcher/l2l1pref.h"
@@ -60,6 +61,7 @@
 #include "statistics.h"
 //#include "dram.h"
 //#include "dram.param.h"
+#include "dram_fast.h"
 #include "ramulator.h"
 #include "ramulator.param.h"
 
@@ -94,7 +96,7 @@ static uns      mem_req_pref_entries   = 0;
 static uns      mem_req_wb_entries     = 0;
 
 Memory*              mem = NULL;
-extern Icache_Stage* ic;
+extern __thread Icache_Stage* ic;
 extern Counter  last_recover_cycle;
 
 Counter Mem_Req_Priority[MRT_NUM_ELEMS];
@@ -106,14 +108,16 @@ Counter Mem_Req_Priority_Offset[MRT_NUM_ELEMS];
 static void init_mem_req_type_priorities(void);
 static void init_uncores(void);
 static void update_memory_queues(void);
-static void update_on_chip_memory_stats(void);
+static void update_on_chip_memory_stats(Counter cycles);
 
 static void mark_ops_as_l1_miss(Mem_Req* req);
 static void mark_l1_miss_deps(Op* op);
+static void mark_l1_miss_dep(Op* op, Op* dep_op);
 static void unmark_l1_miss_deps(Op* op);
+static void unmark_l1_miss_dep(Op* op, Op* dep_op);
 static void update_mem_req_occupancy_counter(Mem_Req_Type type, int delta);
 
-int         mem_compare_priority(const void* a, const void* b);
+static void mem_sort_queue(Mem_Queue* queue);
 void        mem_start_mlc_access(Mem_Req* req);
 static void mem_process_core_fill_reqs(uns proc_id);
 Flag mem_process_mlc_hit_access(Mem_Req* req, Mem_Queue_Entry* mlc_queue_entry,
@@ -152,6 +156,12 @@ static inline Flag insert_new_req_into_mlc_queue(uns proc_id, Mem_Req* new_req);
 static void mem_process_mlc_reqs(void);
 static void mem_process_l1_reqs(void);
 
+static void     init_mem_addr_index(void);
+static uns      mem_addr_index_bucket(Addr addr);
+static void     mem_addr_index_insert(Mem_Req* req);
+static void     mem_addr_index_remove(Mem_Req* req);
+static Mem_Req* mem_addr_index_first(Addr addr);
+static Mem_Req* mem_addr_index_next(Mem_Req* req, Addr addr);
 static inline Mem_Req* mem_search_queue(Mem_Queue* queue, uns8 proc_id,
                                         Addr addr, Mem_Req_Type type, uns size,
                                         Flag*             demand_hit_prefetch,
@@ -180,6 +190,8 @@ static Mem_Req* mem_kick_out_prefetch_from_queues(uns     mem_bank,
 static Mem_Req* mem_kick_out_oldest_first_prefetch_from_queues(
   uns mem_bank, Counter new_priority, uns queues_to_search);
 
+static int mem_send_to_dram(Mem_Req* req);
+
 static void mem_init_new_req(Mem_Req* new_req, Mem_Req_Type type,
                              Mem_Queue_Type queue_type, uns8 proc_id, Addr addr,
                              uns size, uns delay, Op* op,
@@ -327,6 +339,8 @@ void init_memory() {
     mem->req_buffer[ii].state = MRS_INV;
   }
   mem->num_req_buffers_per_core = calloc(NUM_CORES, sizeof(uns));
+  if(MEM_REQ_ADDR_INDEX)
+    init_mem_addr_index();
   init_list(&mem->req_buffer_free_list, "REQ BUF FREE LIST", sizeof(int), TRUE);
 
   if(ROUND_ROBIN_TO_L1) {
@@ -394,7 +408,10 @@ void init_memory() {
   mem->l1_ave_num_ways_per_core = (double*)malloc(sizeof(double) * NUM_CORES);
 
   // init_dram ();
-  ramulator_init();
+  if(DRAM_FAST_MODEL)
+    dram_fast_init();
+  else
+    ramulator_init();
 
   reset_memory();
 
@@ -532,6 +549,8 @@ void reset_memory() {
     *free_list_entry          = ii;
     mem->req_buffer[ii].state = MRS_INV;
   }
+  if(MEM_REQ_ADDR_INDEX)
+    init_mem_addr_index();
 
   mem->req_count = 0;
 
@@ -637,6 +656,8 @@ void mem_free_reqbuf(Mem_Req* req) {
 
   ASSERT(req->proc_id, req->reserved_entry_count == 0);
 
+  if(MEM_REQ_ADDR_INDEX)
+    mem_addr_index_remove(req);
   req->state = MRS_INV;
   mem->req_count--;
   ASSERT(req->proc_id, mem->req_count >= 0);
@@ -864,44 +885,47 @@ void update_memory_queues() {
   }
 
   if(!ALL_FIFO_QUEUES && (cycle_l1q_insert_count > 0)) {
-    qsort(mem->l1_queue.base, mem->l1_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_sort_queue(&mem->l1_queue);
     cycle_l1q_insert_count = 0;
   }
 
   if(!ALL_FIFO_QUEUES && (cycle_mlcq_insert_count > 0)) {
-    qsort(mem->mlc_queue.base, mem->mlc_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_sort_queue(&mem->mlc_queue);
     cycle_mlcq_insert_count = 0;
   }
 
   if(!ALL_FIFO_QUEUES && (cycle_busoutq_insert_count > 0)) {
-    qsort(mem->bus_out_queue.base, mem->bus_out_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_sort_queue(&mem->bus_out_queue);
     cycle_busoutq_insert_count = 0;
   }
 }
 
-void update_on_chip_memory_stats() {
-  STAT_EVENT_ALL(L1_CYCLE);
-  STAT_EVENT(0, MIN2(MEM_REQ_DEMANDS__0 + mem_req_demand_entries / 4,
-                     MEM_REQ_DEMANDS_64));
-  STAT_EVENT(
-    0, MIN2(MEM_REQ_PREFS__0 + mem_req_pref_entries / 4, MEM_REQ_PREFS_64));
-  STAT_EVENT(0, MIN2(MEM_REQ_WRITEBACKS__0 + mem_req_wb_entries / 4,
-                     MEM_REQ_WRITEBACKS_64));
-  INC_STAT_EVENT(0, MEM_REQ_DEMAND_CYCLES, mem_req_demand_entries);
-  INC_STAT_EVENT(0, MEM_REQ_PREF_CYCLES, mem_req_pref_entries);
-  INC_STAT_EVENT(0, MEM_REQ_WB_CYCLES, mem_req_wb_entries);
+void update_on_chip_memory_stats(Counter cycles) {
+  INC_STAT_EVENT_ALL(L1_CYCLE, cycles);
+  INC_STAT_EVENT(0,
+                 MIN2(MEM_REQ_DEMANDS__0 + mem_req_demand_entries / 4,
+                      MEM_REQ_DEMANDS_64),
+                 cycles);
+  INC_STAT_EVENT(
+    0, MIN2(MEM_REQ_PREFS__0 + mem_req_pref_entries / 4, MEM_REQ_PREFS_64),
+    cycles);
+  INC_STAT_EVENT(0,
+                 MIN2(MEM_REQ_WRITEBACKS__0 + mem_req_wb_entries / 4,
+                      MEM_REQ_WRITEBACKS_64),
+                 cycles);
+  INC_STAT_EVENT(0, MEM_REQ_DEMAND_CYCLES, mem_req_demand_entries * cycles);
+  INC_STAT_EVENT(0, MEM_REQ_PREF_CYCLES, mem_req_pref_entries * cycles);
+  INC_STAT_EVENT(0, MEM_REQ_WB_CYCLES, mem_req_wb_entries * cycles);
   for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-    STAT_EVENT(
+    INC_STAT_EVENT(
       proc_id,
-      CORE_MLP_0 + MIN2(mem->uncores[proc_id].num_outstanding_l1_misses, 32));
+      CORE_MLP_0 + MIN2(mem->uncores[proc_id].num_outstanding_l1_misses, 32),
+      cycles);
     INC_STAT_EVENT(proc_id, CORE_MLP,
-                   mem->uncores[proc_id].num_outstanding_l1_misses);
+                   mem->uncores[proc_id].num_outstanding_l1_misses * cycles);
     Counter l1_lines = GET_TOTAL_STAT_EVENT(proc_id, NORESET_L1_FILL) -
                        GET_TOTAL_STAT_EVENT(proc_id, NORESET_L1_EVICT);
-    INC_STAT_EVENT(proc_id, L1_LINES, l1_lines);
+    INC_STAT_EVENT(proc_id, L1_LINES, l1_lines * cycles);
   }
 }
 
@@ -920,7 +944,7 @@ void update_memory() {
 
     pref_update();
     update_memory_queues();
-    update_on_chip_memory_stats();
+    update_on_chip_memory_stats(1);
 
     mem_process_mlc_fill_reqs();
     mem_process_l1_fill_reqs();
@@ -930,7 +954,10 @@ void update_memory() {
     cycle_count = freq_cycle_count(FREQ_DOMAIN_MEMORY);
 
     // dram_process_main_memory_reqs();
-    ramulator_tick();
+    if(DRAM_FAST_MODEL)
+      dram_fast_tick();
+    else
+      ramulator_tick();
   }
 
   if(freq_is_ready(FREQ_DOMAIN_L1)) {
@@ -950,20 +977,48 @@ void update_memory() {
 }
 
 /**************************************************************************************/
-/* mem_compare_priority: */
-
-int mem_compare_priority(const void* a, const void* b) {
-  Mem_Queue_Entry* e0        = (Mem_Queue_Entry*)a;
-  Mem_Queue_Entry* e1        = (Mem_Queue_Entry*)b;
-  Counter          priority0 = e0->priority;
-  Counter          priority1 = e1->priority;
-
-  if(priority0 < priority1)
-    return -1;
-  else if(priority1 < priority0)
-    return 1;
-  else
+/* memory_idle_cycles: the memory cycles from now on in which update_memory()
+ * only counts cycles, because no request waits above the DRAM and the DRAM
+ * has nothing to do. Zero if a request is waiting. */
+
+Counter memory_idle_cycles() {
+  if(DRAM_FAST_MODEL)
+    return 0;
+  if(mem->mlc_queue.entry_count || mem->mlc_fill_queue.entry_count ||
+     mem->l1_queue.entry_count || mem->bus_out_queue.entry_count ||
+     mem->l1fill_queue.entry_count || l1_in_buf_count ||
+     cycle_l1q_insert_count || cycle_mlcq_insert_count ||
+     cycle_busoutq_insert_count)
+    return 0;
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    if(mem->core_fill_queues[proc_id].entry_count)
+      return 0;
+  }
+  Counter cycles = ramulator_idle_tick_count();
+  if(cycles == 0 || !pref_queues_empty())
     return 0;
+  return cycles;
+}
+
+/**************************************************************************************/
+/* skip_idle_memory: update_memory() over the last l1_cycles L1 and mem_cycles
+ * memory cycles, all of them within memory_idle_cycles() */
+
+void skip_idle_memory(Counter l1_cycles, Counter mem_cycles) {
+  if(l1_cycles) {
+    cycle_count = freq_cycle_count(FREQ_DOMAIN_L1);
+    perf_pred_cycle();
+    pref_skip_idle_cycles(l1_cycles);
+    update_on_chip_memory_stats(l1_cycles);
+  }
+  ramulator_skip_ticks(mem_cycles);
+}
+
+/**************************************************************************************/
+/* mem_sort_queue: */
+
+static void mem_sort_queue(Mem_Queue* queue) {
+  mem_queue_sort(queue->base, queue->entry_count, MEM_QUEUE_RUN_SORT);
 }
 
 /**************************************************************************************/
@@ -1638,7 +1693,7 @@ static Flag mem_complete_l1_access(Mem_Req*         req,
         // bus_out_seq_num : 0);
         ASSERT(req->proc_id, MRS_L1_WAIT == req->state);
         req->state    = MRS_MEM_NEW;
-        l1_hit_access = ramulator_send(req);
+        l1_hit_access = mem_send_to_dram(req);
 
         if(!l1_hit_access) {
           // request rejected by Ramulator, so restore state to
@@ -1697,7 +1752,7 @@ static Flag mem_complete_l1_access(Mem_Req*         req,
 
         ASSERT(req->proc_id, MRS_L1_WAIT == req->state);
         req->state     = MRS_MEM_NEW;
-        l1_miss_access = ramulator_send(req);
+        l1_miss_access = mem_send_to_dram(req);
         if(!l1_miss_access) {
           // STAT_EVENT(req->proc_id, REJECTED_QUEUE_BUS_OUT);
 
@@ -1956,8 +2011,7 @@ static void mem_process_l1_reqs() {
     /* After this sort requests that should be removed will be at the tail of
      * the l1_queue */
     DEBUG(0, "l1_queue removal\n");
-    qsort(mem->l1_queue.base, mem->l1_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_sort_queue(&mem->l1_queue);
     mem->l1_queue.entry_count -= l1_queue_removal_count;
     ASSERT(req->proc_id, mem->l1_queue.entry_count >= 0);
     /* if HIER_MSHR_ON, requests stay in the queues until filled (by reserving
@@ -1970,11 +2024,9 @@ static void mem_process_l1_reqs() {
   /* Sort the out queue if requests were inserted */
   if(!ALL_FIFO_QUEUES && (out_queue_insertion_count > 0)) {
     if(CONSTANT_MEMORY_LATENCY) {  // request went straight to L1 fill queue
-      qsort(mem->l1fill_queue.base, mem->l1fill_queue.entry_count,
-            sizeof(Mem_Queue_Entry), mem_compare_priority);
+      mem_sort_queue(&mem->l1fill_queue);
     } else {
-      qsort(mem->bus_out_queue.base, mem->bus_out_queue.entry_count,
-            sizeof(Mem_Queue_Entry), mem_compare_priority);
+      mem_sort_queue(&mem->bus_out_queue);
     }
   }
 }
@@ -2048,8 +2100,7 @@ static void mem_process_mlc_reqs() {
     /* After this sort requests that should be removed will be at the tail of
      * the mlc_queue */
     DEBUG(0, "mlc_queue removal\n");
-    qsort(mem->mlc_queue.base, mem->mlc_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_sort_queue(&mem->mlc_queue);
     mem->mlc_queue.entry_count -= mlc_queue_removal_count;
     ASSERT(req->proc_id, mem->mlc_queue.entry_count >= 0);
     /* if HIER_MSHR_ON, requests stay in the queues until filled (by reserving
@@ -2061,8 +2112,7 @@ static void mem_process_mlc_reqs() {
 
   /* Sort the l1 queue if requests were inserted */
   if(!ALL_FIFO_QUEUES && (l1_queue_insertion_count > 0)) {
-    qsort(mem->l1_queue.base, mem->l1_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_sort_queue(&mem->l1_queue);
   }
 }
 
@@ -2352,7 +2402,7 @@ static void mem_process_bus_out_reqs() {
     // else
     //    mem_insert_req_into_queue (req, req->queue, ALL_FIFO_QUEUES ?
     //    mem_seq_num : 0);
-    Flag sent = ramulator_send(
+    Flag sent = mem_send_to_dram(
       req);  // Ramulator_note: Does ramulator need to do anything
              // with mem_seq_num?
     if(sent) {
@@ -2380,8 +2430,7 @@ static void mem_process_bus_out_reqs() {
     //}
 
     DEBUG(0, "bus_out_queue removal\n");
-    qsort(mem->bus_out_queue.base, mem->bus_out_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_sort_queue(&mem->bus_out_queue);
     mem->bus_out_queue.entry_count--;
     ASSERT(req->proc_id, mem->bus_out_queue.entry_count >= 0);
 
@@ -2393,6 +2442,16 @@ static void mem_process_bus_out_reqs() {
   }
 }
 
+/**************************************************************************************/
+/* mem_send_to_dram: Hands a request to the DRAM model in use. Returns FALSE if
+ * it was rejected */
+
+static int mem_send_to_dram(Mem_Req* req) {
+  if(DRAM_FAST_MODEL)
+    return dram_fast_send(req);
+  return ramulator_send(req);
+}
+
 /**************************************************************************************/
 /* mem_complete_bus_in_access: */
 
@@ -2458,8 +2517,7 @@ static void remove_from_l1_fill_queue(uns  proc_id,
     /* After this sort requests that should be removed will be at the tail of
      * the l1_queue */
     DEBUG(0, "l1fill_queue removal\n");
-    qsort(mem->l1fill_queue.base, mem->l1fill_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_sort_queue(&mem->l1fill_queue);
     mem->l1fill_queue.entry_count -= *p_l1fill_queue_removal_count;
     ASSERT(proc_id, mem->l1fill_queue.entry_count >= 0);
     /* free corresponding reserved entries in the L1 queue if HIER_MSHR_ON */
@@ -2640,8 +2698,7 @@ static void mem_process_mlc_fill_reqs() {
     /* After this sort requests that should be removed will be at the tail of
      * the mlc_queue */
     DEBUG(0, "mlc_fill_queue removal\n");
-    qsort(mem->mlc_fill_queue.base, mem->mlc_fill_queue.entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_sort_queue(&mem->mlc_fill_queue);
     mem->mlc_fill_queue.entry_count -= mlc_fill_queue_removal_count;
     ASSERT(req->proc_id, mem->mlc_fill_queue.entry_count >= 0);
     /* free corresponding reserved entries in the MLC queue if HIER_MSHR_ON */
@@ -2694,19 +2751,123 @@ static void mem_process_core_fill_reqs(uns proc_id) {
     /* After this sort requests that should be removed will be at the tail of
      * the core_fill_queue */
     DEBUG(0, "core_fill_queue removal\n");
-    qsort(core_fill_queue->base, core_fill_queue->entry_count,
-          sizeof(Mem_Queue_Entry), mem_compare_priority);
+    mem_sort_queue(core_fill_queue);
     core_fill_queue->entry_count -= core_fill_queue_removal_count;
     ASSERT(req->proc_id, core_fill_queue->entry_count >= 0);
   }
 }
 
+/**************************************************************************************/
+/* init_mem_addr_index: the index block is the largest request size, so that
+ * every address match of mem_search_queue() (done at the granularity of the
+ * matched request's size) is within one block */
+
+static void init_mem_addr_index() {
+  uns max_size = MAX2(MAX2(ICACHE_LINE_SIZE, DCACHE_LINE_SIZE),
+                      MAX2(MLC_LINE_SIZE, L1_LINE_SIZE));
+  mem->addr_index_shift = LOG2(max_size);
+  mem->addr_index_bits  = LOG2(mem->total_mem_req_buffers) + 2;
+
+  if(!mem->addr_index)
+    mem->addr_index = (int*)malloc(sizeof(int) << mem->addr_index_bits);
+  for(uns ii = 0; ii < (1 << mem->addr_index_bits); ii++)
+    mem->addr_index[ii] = -1;
+  for(uns ii = 0; ii < mem->total_mem_req_buffers; ii++)
+    mem->req_buffer[ii].addr_indexed = FALSE;
+}
+
+/**************************************************************************************/
+/* mem_addr_index_bucket: */
+
+static uns mem_addr_index_bucket(Addr addr) {
+  uns64 block = addr >> mem->addr_index_shift;
+  return (uns)((block * 0x9e3779b97f4a7c15ULL) >> (64 - mem->addr_index_bits));
+}
+
+/**************************************************************************************/
+/* mem_addr_index_insert: */
+
+static void mem_addr_index_insert(Mem_Req* req) {
+  ASSERT(req->proc_id, !req->addr_indexed);
+  ASSERTM(req->proc_id, req->size <= (1 << mem->addr_index_shift),
+          "Request size %d is larger than the address index block\n",
+          req->size);
+  ASSERT(req->proc_id,
+         req->type != MRT_DSTORE || req->addr % req->size == 0);
+
+  uns bucket             = mem_addr_index_bucket(req->addr);
+  req->addr_index_next    = mem->addr_index[bucket];
+  mem->addr_index[bucket] = req->id;
+  req->addr_indexed       = TRUE;
+}
+
+/**************************************************************************************/
+/* mem_addr_index_remove: */
+
+static void mem_addr_index_remove(Mem_Req* req) {
+  if(!req->addr_indexed)
+    return;
+
+  int* link = &mem->addr_index[mem_addr_index_bucket(req->addr)];
+  while(*link != req->id) {
+    ASSERT(req->proc_id, *link >= 0);
+    link = &mem->req_buffer[*link].addr_index_next;
+  }
+  *link             = req->addr_index_next;
+  req->addr_indexed = FALSE;
+}
+
+/**************************************************************************************/
+/* mem_addr_index_first: first valid request in the index block of addr */
+
+static Mem_Req* mem_addr_index_first(Addr addr) {
+  int id = mem->addr_index[mem_addr_index_bucket(addr)];
+  for(; id >= 0; id = mem->req_buffer[id].addr_index_next) {
+    Mem_Req* req = &mem->req_buffer[id];
+    if((req->addr >> mem->addr_index_shift) ==
+       (addr >> mem->addr_index_shift))
+      return req;
+  }
+  return NULL;
+}
+
+/**************************************************************************************/
+/* mem_addr_index_next: */
+
+static Mem_Req* mem_addr_index_next(Mem_Req* req, Addr addr) {
+  int id = req->addr_index_next;
+  for(; id >= 0; id = mem->req_buffer[id].addr_index_next) {
+    Mem_Req* next = &mem->req_buffer[id];
+    if((next->addr >> mem->addr_index_shift) ==
+       (addr >> mem->addr_index_shift))
+      return next;
+  }
+  return NULL;
+}
+
 /**************************************************************************************/
 /* scan_stores: */
 
 Flag scan_stores(Addr addr, uns size) {
   uns ii;
 
+  if(MEM_REQ_ADDR_INDEX) {
+    /* store requests are line aligned, so a store that contains the load
+       shares its index block */
+    for(Mem_Req* req = mem_addr_index_first(addr); req;
+        req          = mem_addr_index_next(req, addr)) {
+      if(req->type == MRT_DSTORE &&
+         BYTE_CONTAIN(req->addr, req->size, addr, size)) {
+        ASSERTM(req->proc_id,
+                req->proc_id == get_proc_id_from_cmp_addr(addr),
+                "Load from %d matched a store from %d!\n",
+                get_proc_id_from_cmp_addr(addr), req->proc_id);
+        return SUCCESS;
+      }
+    }
+    return FAILURE;
+  }
+
   for(ii = 0; ii < mem->total_mem_req_buffers; ii++) {
     Mem_Req* req = &mem->req_buffer[ii];
     if(req->state != MRS_INV && req->type == MRT_DSTORE &&
@@ -2745,6 +2906,11 @@ static inline Mem_Req* mem_search_queue(
 
   *demand_hit_prefetch = FALSE;
 
+  /* queue entries can only match valid requests to the same line, and
+     usually there are none */
+  if(MEM_REQ_ADDR_INDEX && !mem_addr_index_first(addr))
+    return NULL;
+
   // CMP ignore "size" from argument
 
   for(ii = 0; ii < queue->entry_count; ii++) {
@@ -2902,7 +3068,9 @@ static inline Mem_Req* mem_search_reqbuf(
 
   // ASSERT(proc_id, !(queues_to_search & QUEUE_MEM));
   if(queues_to_search & QUEUE_MEM) {
-    req = ramulator_search_queue(addr_translate(addr), type);
+    req = DRAM_FAST_MODEL ?
+            dram_fast_search_queue(addr_translate(addr), type) :
+            ramulator_search_queue(addr_translate(addr), type);
     if(req) {
       *ramulator_match = TRUE;
       if(req->type == MRT_IPRF) {
@@ -3131,8 +3299,7 @@ Flag mem_adjust_matching_request(Mem_Req* req, Mem_Req_Type type, Addr addr,
         req->type = type;
         memview_req_changed_type(req);
       }
-      qsort(req->queue->base, req->queue->entry_count, sizeof(Mem_Queue_Entry),
-            mem_compare_priority); /* Sort the associated queue */
+      mem_sort_queue(req->queue); /* Sort the associated queue */
     }
 
     switch(req->queue->type) {
@@ -3325,8 +3492,7 @@ static Mem_Req* mem_kick_out_prefetch_from_queue(uns mem_bank, Mem_Queue* queue,
   if(queue->entry_count == 0)
     return NULL;
 
-  qsort(queue->base, queue->entry_count, sizeof(Mem_Queue_Entry),
-        mem_compare_priority);
+  mem_sort_queue(queue);
 
   if(KICKOUT_OLDEST_PREFETCH) {
     int      ii, oldest_index = 0;
@@ -3373,8 +3539,7 @@ static Mem_Req* mem_kick_out_prefetch_from_queue(uns mem_bank, Mem_Queue* queue,
       queue->base[oldest_index].priority =
         Mem_Req_Priority_Offset[MRT_MIN_PRIORITY];
       DEBUG(0, "%s removal\n", queue->name);
-      qsort(queue->base, queue->entry_count, sizeof(Mem_Queue_Entry),
-            mem_compare_priority);
+      mem_sort_queue(queue);
       queue->entry_count--;
       pref_req_drop_process(
         req_kicked_out->proc_id,
@@ -3513,6 +3678,9 @@ static void mem_init_new_req(
   if(!kicked_out_another) {
     mem->req_count++;
   } else {
+    /* a kicked out prefetch is reused without being freed */
+    if(MEM_REQ_ADDR_INDEX)
+      mem_addr_index_remove(new_req);
     mem_clear_reqbuf(new_req);
   }
 
@@ -3544,6 +3712,8 @@ static void mem_init_new_req(
   new_req->priority = new_priority;
   new_req->size     = size;
   ASSERT(new_req->proc_id, new_req->size <= VA_PAGE_SIZE_BYTES);
+  if(MEM_REQ_ADDR_INDEX)
+    mem_addr_index_insert(new_req);
   new_req->reserved_entry_count = 0;
   // TODO: actually populate mem_flat_bank, mem_channel, and mem_bank by
   // grabbing that information from Ramulator
@@ -4344,7 +4514,7 @@ static Flag new_mem_l1_wb_req(Mem_Req_Type type, uns8 proc_id, Addr addr,
   if(!ROUND_ROBIN_TO_L1) {
     bus_out_seq_num++;  // RAMULATOR_remove: this is not currently used
 
-    is_sent = ramulator_send(new_req);
+    is_sent = mem_send_to_dram(new_req);
     if(!is_sent) {
       mem_free_reqbuf(new_req);  // RAMULATOR_todo: optimize this
       return FALSE;
@@ -4760,28 +4930,6 @@ Flag mlc_fill_line(Mem_Req* req) {
   /* if (!get_write_port(&MLC(req->proc_id)->ports[req->mlc_bank])) return
    * FAILURE; */
 
-  // Put prefetches in the right position for replacement
-  // cmp FIXME prefetchers
-  if(req->type == MRT_DPRF || req->type == MRT_IPRF) {
-    mem->pref_replpos = INSERT_REPL_DEFAULT;
-    if(PREF_INSERT_LRU) {
-      mem->pref_replpos = INSERT_REPL_LRU;
-      STAT_EVENT(req->proc_id, PREF_REPL_LRU);
-    } else if(PREF_INSERT_MIDDLE) {
-      mem->pref_replpos = INSERT_REPL_MID;
-      STAT_EVENT(req->proc_id, PREF_REPL_MID);
-    } else if(PREF_INSERT_LOWQTR) {
-      mem->pref_replpos = INSERT_REPL_LOWQTR;
-      STAT_EVENT(req->proc_id, PREF_REPL_LOWQTR);
-    }
-    data = (MLC_Data*)cache_insert_replpos(
-      &MLC(req->proc_id)->cache, req->proc_id, req->addr, &line_addr,
-      &repl_line_addr, mem->pref_replpos, TRUE);
-  } else {
-    data = (MLC_Data*)cache_insert(&MLC(req->proc_id)->cache, req->proc_id,
-                                   req->addr, &line_addr, &repl_line_addr);
-  }
-
   if(req->type == MRT_WB_NODIRTY || req->type == MRT_WB) {
     STAT_EVENT(req->proc_id, MLC_WB_FILL);
     STAT_EVENT(req->proc_id, CORE_MLC_WB_FILL);
@@ -4919,6 +5067,28 @@ Flag mlc_fill_line(Mem_Req* req) {
     }
   }
 
+  // Put prefetches in the right position for replacement
+  // cmp FIXME prefetchers
+  if(req->type == MRT_DPRF || req->type == MRT_IPRF) {
+    mem->pref_replpos = INSERT_REPL_DEFAULT;
+    if(PREF_INSERT_LRU) {
+      mem->pref_replpos = INSERT_REPL_LRU;
+      STAT_EVENT(req->proc_id, PREF_REPL_LRU);
+    } else if(PREF_INSERT_MIDDLE) {
+      mem->pref_replpos = INSERT_REPL_MID;
+      STAT_EVENT(req->proc_id, PREF_REPL_MID);
+    } else if(PREF_INSERT_LOWQTR) {
+      mem->pref_replpos = INSERT_REPL_LOWQTR;
+      STAT_EVENT(req->proc_id, PREF_REPL_LOWQTR);
+    }
+    data = (MLC_Data*)cache_insert_replpos(
+      &MLC(req->proc_id)->cache, req->proc_id, req->addr, &line_addr,
+      &repl_line_addr, mem->pref_replpos, TRUE);
+  } else {
+    data = (MLC_Data*)cache_insert(&MLC(req->proc_id)->cache, req->proc_id,
+                                   req->addr, &line_addr, &repl_line_addr);
+  }
+
   /* this will make it bring the line into the mlc and then modify it */
   data->proc_id = req->proc_id;
   data->dirty   = ((req->type == MRT_WB) &&
@@ -5104,91 +5274,73 @@ void mark_ops_as_l1_miss_satisfied(Mem_Req* req) {
 
 /**************************************************************************************/
 /* mark_l1_miss_deps: */
-/* recursively go through the wake up lists of the op and mark ops as
+/* recursively go through the dependents of the op and mark ops as
  * l1_miss_dep */
 static void mark_l1_miss_deps(Op* op) {
-  Wake_Up_Entry* temp;
-
   ASSERT(op->proc_id,
          (op->engine_info.l1_miss && !op->engine_info.l1_miss_satisfied) ||
            op->engine_info.dep_on_l1_miss);
 
-  for(temp = op->wake_up_head; temp; temp = temp->next) {
-    Op*     dep_op         = temp->op;
-    Counter dep_unique_num = temp->unique_num;
-
-
-    if(dep_op->unique_num == dep_unique_num && dep_op->op_pool_valid) {
-      ASSERT(op->proc_id, op->proc_id == dep_op->proc_id);
-      /*printf("MARK c: %s dep_op: %s %s %s %s op: %s %s %s %s\n",
-         unsstr64(cycle_count), unsstr64(dep_op->unique_num),
-         unsstr64(dep_op->exec_cycle), disasm_op(dep_op, TRUE),
-         unsstr64(dep_op->oracle_info.va), unsstr64(op->unique_num),
-         unsstr64(op->exec_cycle), disasm_op(op, TRUE),
-         unsstr64(op->oracle_info.va)); */
-      ASSERT(dep_op->proc_id, !dep_op->engine_info.l1_miss ||
-                                dep_op->table_info->mem_type == MEM_ST);
-      if(!dep_op->engine_info.dep_on_l1_miss) {
-        dep_op->engine_info.dep_on_l1_miss = TRUE;
-        mark_l1_miss_deps(dep_op);
-      }
-    }
+  for_each_dep_op(op, mark_l1_miss_dep);
+}
+
+static void mark_l1_miss_dep(Op* op, Op* dep_op) {
+  ASSERT(op->proc_id, op->proc_id == dep_op->proc_id);
+  ASSERT(dep_op->proc_id, !dep_op->engine_info.l1_miss ||
+                            dep_op->table_info->mem_type == MEM_ST);
+  if(!dep_op->engine_info.dep_on_l1_miss) {
+    dep_op->engine_info.dep_on_l1_miss = TRUE;
+    mark_l1_miss_deps(dep_op);
   }
 }
 
 /**************************************************************************************/
 /* unmark_l1_miss_deps: */
-/* recursively go through the wake up lists of the op and unmark ops as
+/* recursively go through the dependents of the op and unmark ops as
  * l1_miss_dep */
 
 static void unmark_l1_miss_deps(Op* op) {
-  Wake_Up_Entry* temp;
-
   ASSERT(op->proc_id, op->engine_info.l1_miss_satisfied ||
                         (!op->engine_info.dep_on_l1_miss &&
                          op->engine_info.was_dep_on_l1_miss));
 
-  /* Go thru the wake up list and unmark ops if they are not dependent on
+  /* Go thru the dependents and unmark ops if they are not dependent on
    * another l1 miss */
-  for(temp = op->wake_up_head; temp; temp = temp->next) {
-    Op*     dep_op         = temp->op;
-    Counter dep_unique_num = temp->unique_num;
-
-    if(dep_op->unique_num == dep_unique_num && dep_op->op_pool_valid) {
-      int      ii;
-      Op_Info* op_info              = &dep_op->oracle_info;
-      Flag     still_dep_on_l1_miss = FALSE;
-
-      ASSERT(op->proc_id, op->proc_id == dep_op->proc_id);
-      ASSERT(dep_op->proc_id, dep_op->engine_info.dep_on_l1_miss ||
-                                dep_op->engine_info.was_dep_on_l1_miss);
-
-      if(dep_op->engine_info.dep_on_l1_miss) {
-        /* Determine if the op is dependent on another l1_miss */
-        for(ii = 0; ii < op_info->num_srcs; ii++) {
-          Src_Info* src_info = &op_info->src_info[ii];
-          Op*       src_op   = src_info->op;
-
-          if(src_op->unique_num == src_info->unique_num &&
-             src_op->op_pool_valid) {
-            if(src_op->unique_num != op->unique_num)
-              if((src_op->engine_info.l1_miss &&
-                  !src_op->engine_info.l1_miss_satisfied) ||
-                 src_op->engine_info.dep_on_l1_miss)
-                still_dep_on_l1_miss = TRUE;
-          }
-          if(still_dep_on_l1_miss)
-            break;
-        }
+  for_each_dep_op(op, unmark_l1_miss_dep);
+}
 
-        /* If the op is not dependent on another l1 miss, then go ahead and
-           unmark it and figure out if we need to unmark its dependents */
-        if(!still_dep_on_l1_miss) {
-          dep_op->engine_info.dep_on_l1_miss     = FALSE;
-          dep_op->engine_info.was_dep_on_l1_miss = TRUE;
-          unmark_l1_miss_deps(dep_op);
-        }
+static void unmark_l1_miss_dep(Op* op, Op* dep_op) {
+  int      ii;
+  Op_Info* op_info              = &dep_op->oracle_info;
+  Flag     still_dep_on_l1_miss = FALSE;
+
+  ASSERT(op->proc_id, op->proc_id == dep_op->proc_id);
+  ASSERT(dep_op->proc_id, dep_op->engine_info.dep_on_l1_miss ||
+                            dep_op->engine_info.was_dep_on_l1_miss);
+
+  if(dep_op->engine_info.dep_on_l1_miss) {
+    /* Determine if the op is dependent on another l1_miss */
+    for(ii = 0; ii < op_info->num_srcs; ii++) {
+      Src_Info* src_info = &op_info->src_info[ii];
+      Op*       src_op   = src_info->op;
+
+      if(src_op->unique_num == src_info->unique_num && src_op->op_pool_valid) {
+        if(src_op->unique_num != op->unique_num)
+          if((src_op->engine_info.l1_miss &&
+              !src_op->engine_info.l1_miss_satisfied) ||
+             src_op->engine_info.dep_on_l1_miss)
+            still_dep_on_l1_miss = TRUE;
       }
+      if(still_dep_on_l1_miss)
+        break;
+    }
+
+    /* If the op is not dependent on another l1 miss, then go ahead and
+       unmark it and figure out if we need to unmark its dependents */
+    if(!still_dep_on_l1_miss) {
+      dep_op->engine_info.dep_on_l1_miss     = FALSE;
+      dep_op->engine_info.was_dep_on_l1_miss = TRUE;
+      unmark_l1_miss_deps(dep_op);
     }
   }
 }
@@ -37,6 +37,7 @@
 #include "libs/hash_lib.h"
 #include "libs/list_lib.h"
 #include "libs/port_lib.h"
+#include "memory/mem_queue_sort.h"
 #include "memory/mem_req.h"
 #include "op_info.h"
 //#include "dram.h"
@@ -92,12 +93,6 @@ typedef enum Mem_Queue_Type_enum {
   QUEUE_CORE_FILL = 1 << 6,
 } Mem_Queue_Type;
 
-typedef struct Mem_Queue_Entry_struct {
-  int     reqbuf;   /* request buffer num */
-  Counter priority; /* priority of the miss */
-  Counter rdy_cycle;
-} Mem_Queue_Entry;
-
 typedef struct Mem_Queue_struct {
   Mem_Queue_Entry* base;
   int              entry_count;
@@ -146,6 +141,12 @@ typedef struct Memory_struct {
 
   int req_count;
 
+  /* line address index over the valid request buffers (MEM_REQ_ADDR_INDEX):
+     bucket heads of request buffer ids chained through addr_index_next */
+  int* addr_index;
+  uns  addr_index_bits;
+  uns  addr_index_shift; /* log2 of the largest request size */
+
   /* uncore (includes MLC and L1) */
   Uncore* uncores;
 
@@ -216,7 +217,6 @@ typedef struct Umon_Cache_Data_struct {
 
 /**************************************************************************************/
 /* Prototypes */
-int mem_compare_priority(const void* a, const void* b);
 
 void set_memory(Memory*);
 void init_memory(void);
@@ -224,6 +224,8 @@ void reset_memory(void);
 void recover_memory(void);
 void debug_memory(void);
 void update_memory(void);
+Counter memory_idle_cycles(void);
+void    skip_idle_memory(Counter l1_cycles, Counter mem_cycles);
 
 Flag     scan_stores(Addr, uns);
 void     op_nuke_mem_req(Op*);
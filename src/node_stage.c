@@ -39,6 +39,7 @@
 #include "op_pool.h"
 
 #include "bp/bp.h"
+#include "cmp_threads.h"
 #include "exec_ports.h"
 #include "frontend/frontend.h"
 #include "memory/memory.h"
@@ -68,9 +69,7 @@
 /**************************************************************************************/
 /* Global Variables */
 
-Node_Stage*            node                   = NULL;
-Rob_Stall_Reason       rob_stall_reason       = ROB_STALL_NONE;
-Rob_Block_Issue_Reason rob_block_issue_reason = ROB_BLOCK_ISSUE_NONE;
+__thread Node_Stage* node = NULL;
 
 
 /**************************************************************************************/
@@ -84,11 +83,13 @@ void flush_window(void);
 void debug_print_node_table(void);
 void debug_print_rs(void);
 void debug_print_ready_list(void);
+static void node_rdy_remove(Op* op);
+static Op*  node_rdy_scan(uns age);
 Flag op_not_ready_for_retire(Op* op);
 Flag is_node_table_empty(void);
-void collect_not_ready_to_retire_stats(Op* op);
+void collect_not_ready_to_retire_stats(Op* op, Counter cycles);
 Flag is_node_table_full(void);
-void collect_node_table_full_stats(Op* op);
+void collect_node_table_full_stats(Op* op, Counter cycles);
 
 /**************************************************************************************/
 /* set_node_stage:*/
@@ -111,6 +112,16 @@ void init_node_stage(uns8 proc_id, const char* name) {
   node->sd.max_op_count = NUM_FUS;  // Bandwidth between schedule and FUS
   node->sd.ops          = (Op**)malloc(sizeof(Op*) * node->sd.max_op_count);
 
+  // oldest-first ready ops are kept in a bitmap indexed by node table slot
+  if(RDY_LIST_OLDEST_FIRST) {
+    node->rdy_bits = (uns64*)calloc(ROUND_UP(NODE_TABLE_SIZE, 64) / 64,
+                                    sizeof(uns64));
+    node->rdy_ops  = (Op**)calloc(NODE_TABLE_SIZE, sizeof(Op*));
+  }
+
+  node->rob_stall_reason       = ROB_STALL_NONE;
+  node->rob_block_issue_reason = ROB_BLOCK_ISSUE_NONE;
+
   reset_node_stage();
 }
 
@@ -127,6 +138,10 @@ void reset_node_stage() {
   node->node_tail       = NULL;
   node->rdy_head        = NULL;
   node->next_op_into_rs = NULL;
+  if(RDY_LIST_OLDEST_FIRST)
+    memset(node->rdy_bits, 0,
+           sizeof(uns64) * (ROUND_UP(NODE_TABLE_SIZE, 64) / 64));
+  node->rdy_count = 0;
 
   node->node_count           = 0;
   node->ret_op               = 1;
@@ -149,6 +164,10 @@ void reset_all_ops_node_stage() {
   node->node_tail       = NULL;
   node->rdy_head        = NULL;
   node->next_op_into_rs = NULL;
+  if(RDY_LIST_OLDEST_FIRST)
+    memset(node->rdy_bits, 0,
+           sizeof(uns64) * (ROUND_UP(NODE_TABLE_SIZE, 64) / 64));
+  node->rdy_count = 0;
 
   node->node_count       = 0;
   node->node_count       = 0;
@@ -182,16 +201,14 @@ void recover_node_stage() {
 }
 
 void flush_ready_list() {
-  Op*  op;
-  Op** last;
-  for(op = node->rdy_head, last = &node->rdy_head; op; op = op->next_rdy) {
+  Op* next;
+  for(Op* op = node_rdy_first(); op; op = next) {
     ASSERT(node->proc_id, node->proc_id == op->proc_id);
+    next = node_rdy_next(op);
     if(FLUSH_OP(op)) {
       ASSERT(node->proc_id, op->op_num > bp_recovery_info->recovery_op_num);
-      *last           = op->next_rdy;
-      op->in_rdy_list = FALSE;
-    } else
-      last = &op->next_rdy;
+      node_rdy_remove(op);
+    }
   }
 }
 
@@ -365,7 +382,7 @@ void debug_print_ready_list() {
 
   DPRINTF("Ready list:");
 
-  for(op = node->rdy_head; op; op = op->next_rdy) {
+  for(op = node_rdy_first(); op; op = node_rdy_next(op)) {
     DPRINTF(" %s", unsstr64(op->op_num));
   }
 
@@ -421,11 +438,11 @@ void node_issue(Stage_Data* src_sd) {
   for(ii = 0; ii < src_sd->max_op_count; ii++) {
     /* if node table is full, stall */
     if(is_node_table_full()) {
-      collect_node_table_full_stats(node->node_head);
-      rob_block_issue_reason = ROB_BLOCK_ISSUE_FULL;
+      collect_node_table_full_stats(node->node_head, 1);
+      node->rob_block_issue_reason = ROB_BLOCK_ISSUE_FULL;
       return;
     }
-    rob_block_issue_reason = ROB_BLOCK_ISSUE_NONE;
+    node->rob_block_issue_reason = ROB_BLOCK_ISSUE_NONE;
 
     // If it is not full, issue the next op
     Op* op = src_sd->ops[ii];
@@ -445,6 +462,10 @@ void node_issue(Stage_Data* src_sd) {
     /* set op fields */
     op->node_id     = node->node_count;
     op->issue_cycle = cycle_count;
+    /* the node table is a FIFO, so slots are handed out in a circle */
+    op->rob_slot = node->node_tail ?
+                     (node->node_tail->rob_slot + 1) % NODE_TABLE_SIZE :
+                     0;
 
     /* add to node list & update node state*/
     ASSERT(node->proc_id, !op->in_node_list);
@@ -507,75 +528,81 @@ void check_if_mem_blocked() {
 }
 
 /**************************************************************************************/
-/* bubble: bubble pass for the ready list. Part of the bubble sort function
- * below. */
-
-static Flag bubble(Op* head, int n) {
-  Flag swapped     = FALSE;
-  Flag swapped_now = FALSE;
-  int  i;
-  Op*  prev = NULL;
-  Op*  cur  = head;
-  Op*  next = head->next_rdy;
-
-  for(i = 0; i < n - 1; i++) {
-    swapped_now = FALSE;
-    if(cur->op_num > next->op_num) {
-      if(prev)
-        prev->next_rdy = next;
-      cur->next_rdy  = next->next_rdy;
-      next->next_rdy = cur;
-      swapped        = TRUE;
-      swapped_now    = TRUE;
-      if(!prev)
-        node->rdy_head = next;
-    }
-    if(swapped_now) {
-      prev = next;
-      next = cur->next_rdy;
-    } else {
-      prev = cur;
-      cur  = next;
-      next = next->next_rdy;
-    }
+/* Ready ops: a list with the most recently readied op first, or with
+ * RDY_LIST_OLDEST_FIRST a bitmap over the node table slots. Since the node
+ * table is allocated in a circle starting at node_head, the age of a slot is
+ * its distance from node_head->rob_slot, and visiting the set bits from there
+ * yields the ready ops oldest first. */
+
+void node_rdy_insert(Op* op) {
+  ASSERT(node->proc_id, !op->in_rdy_list && op->in_node_list);
+  if(RDY_LIST_OLDEST_FIRST) {
+    ASSERT(node->proc_id, op->rob_slot < NODE_TABLE_SIZE);
+    node->rdy_bits[op->rob_slot / 64] |= 1ULL << (op->rob_slot % 64);
+    node->rdy_ops[op->rob_slot] = op;
+  } else {
+    op->prev_rdy = NULL;
+    op->next_rdy = node->rdy_head;
+    if(node->rdy_head)
+      node->rdy_head->prev_rdy = op;
+    node->rdy_head = op;
   }
-
-  return swapped;
+  node->rdy_count++;
+  op->in_rdy_list = TRUE;
 }
 
-/**************************************************************************************/
-/* sort_node_ready_list: sorts the ready list */
-
-inline static void sort_node_ready_list() {
-  Op* op;
-  int i;
-  int count_rdy = 0;
-  for(op = node->rdy_head; op; op = op->next_rdy) {
-    count_rdy++;
+static void node_rdy_remove(Op* op) {
+  ASSERT(node->proc_id, op->in_rdy_list);
+  if(RDY_LIST_OLDEST_FIRST) {
+    ASSERT(node->proc_id, node->rdy_ops[op->rob_slot] == op);
+    node->rdy_bits[op->rob_slot / 64] &= ~(1ULL << (op->rob_slot % 64));
+    node->rdy_ops[op->rob_slot] = NULL;
+  } else {
+    if(op->prev_rdy)
+      op->prev_rdy->next_rdy = op->next_rdy;
+    else
+      node->rdy_head = op->next_rdy;
+    if(op->next_rdy)
+      op->next_rdy->prev_rdy = op->prev_rdy;
   }
+  node->rdy_count--;
+  op->in_rdy_list = FALSE;
+}
 
-  DEBUG(node->proc_id, "Unsorted ready list: count: %d\n", count_rdy);
-  if(DEBUG_NODE_STAGE && DEBUG_RANGE_COND(node->proc_id)) {
-    for(op = node->rdy_head; op; op = op->next_rdy) {
-      DPRINTF("%s ", unsstr64(op->op_num));
+/* node_rdy_scan: oldest ready op whose age is at least age */
+static Op* node_rdy_scan(uns age) {
+  if(!node->rdy_count)
+    return NULL;
+  ASSERT(node->proc_id, node->node_head);
+  uns head_slot = node->node_head->rob_slot;
+  while(age < NODE_TABLE_SIZE) {
+    uns slot = head_slot + age;
+    if(slot >= NODE_TABLE_SIZE)
+      slot -= NODE_TABLE_SIZE;
+    uns64 bits = node->rdy_bits[slot / 64] >> (slot % 64);
+    if(bits) {
+      uns dist = __builtin_ctzll(bits);
+      /* beyond the age limit the bits belong to the oldest ops again */
+      return age + dist < NODE_TABLE_SIZE ? node->rdy_ops[slot + dist] : NULL;
     }
-    DPRINTF("\n");
+    /* move to the next word, or to slot 0 when wrapping around */
+    age += MIN2(64 - slot % 64, NODE_TABLE_SIZE - slot);
   }
+  return NULL;
+}
 
-  for(i = count_rdy; (i > 1) && bubble(node->rdy_head, i); i--)
-    ;
-
-  count_rdy = 0;
-  for(op = node->rdy_head; op; op = op->next_rdy)
-    count_rdy++;
+Op* node_rdy_first() {
+  if(!RDY_LIST_OLDEST_FIRST)
+    return node->rdy_head;
+  return node_rdy_scan(0);
+}
 
-  DEBUG(node->proc_id, "Sorted ready list: count: %d\n", count_rdy);
-  if(DEBUG_NODE_STAGE && DEBUG_RANGE_COND(node->proc_id)) {
-    for(op = node->rdy_head; op; op = op->next_rdy) {
-      DPRINTF("%s ", unsstr64(op->op_num));
-    }
-    DPRINTF("\n");
-  }
+Op* node_rdy_next(Op* op) {
+  if(!RDY_LIST_OLDEST_FIRST)
+    return op->next_rdy;
+  uns age = (op->rob_slot + NODE_TABLE_SIZE - node->node_head->rob_slot) %
+            NODE_TABLE_SIZE;
+  return node_rdy_scan(age + 1);
 }
 
 /**************************************************************************************/
@@ -671,7 +698,7 @@ void node_sched_ops() {
   // Check to see if the L1 Q is (still) full
   check_if_mem_blocked();
 
-  for(op = node->rdy_head; op; op = op->next_rdy) {
+  for(op = node_rdy_first(); op; op = node_rdy_next(op)) {
     ASSERT(node->proc_id, node->proc_id == op->proc_id);
     ASSERTM(node->proc_id, op->in_rdy_list, "op_num %llu\n", op->op_num);
     if(op->state == OS_WAIT_MEM) {
@@ -733,11 +760,11 @@ void node_retire() {
     // check to see if the head of the node table is ready to retire
     if(op_not_ready_for_retire(op)) {
       // op is not ready to retire
-      collect_not_ready_to_retire_stats(op);
+      collect_not_ready_to_retire_stats(op, 1);
       break;
     }
 
-    rob_stall_reason = ROB_STALL_NONE;
+    node->rob_stall_reason = ROB_STALL_NONE;
 
     /**op is ready to retire**/
     ASSERTM(node->proc_id, op->state != OS_TENTATIVE, "op_num: %llu\n",
@@ -796,9 +823,13 @@ void node_retire() {
 
       if(op->exit) {
         retired_exit[op->proc_id] = TRUE;
+        cmp_threads_lock();
         decoupled_fe_retire(op, op->proc_id, -1);
+        cmp_threads_unlock();
       } else if(retire_op) {
+        cmp_threads_lock();
         decoupled_fe_retire(op, op->proc_id, op->inst_uid);
+        cmp_threads_unlock();
       }
     }
     uop_count[node->proc_id]++;
@@ -830,7 +861,7 @@ void node_retire() {
                  LD_EXEC_CYCLES_0 + (op->done_cycle - op->sched_cycle));
     }
     if(op->table_info->mem_type == MEM_LD) {
-      STAT_EVENT(op->proc_id, LD_NO_DEPENDENTS + (op->wake_up_head ? 1 : 0));
+      STAT_EVENT(op->proc_id, LD_NO_DEPENDENTS + (has_dep_ops(op) ? 1 : 0));
     }
     STAT_EVENT(op->proc_id, RET_OP_EXEC_COUNT_0 + MIN2(32, op->exec_count));
 
@@ -947,9 +978,7 @@ void node_fill_rs() {
       DEBUG(node->proc_id, "Adding to ready list  op_num:%s op:%s l1:%d\n",
             unsstr64(op->op_num), disasm_op(op, TRUE), op->engine_info.l1_miss);
       op->state = (cycle_count + 1 >= op->rdy_cycle ? OS_READY : OS_WAIT_FWD);
-      op->next_rdy    = node->rdy_head;
-      node->rdy_head  = op;
-      op->in_rdy_list = TRUE;
+      node_rdy_insert(op);
     }
 
     // This is the max number of ops we can fill into the RS per cycle.
@@ -970,18 +999,16 @@ void node_handle_scheduled_ops() {
   /* this traversal could be made more efficient since we know what
      ops we tried to schedule last cycle, but for now let's look at
      the whole ready list */
-  Op** last = &node->rdy_head;
-  for(Op* op = node->rdy_head; op; op = op->next_rdy) {
+  Op* next;
+  for(Op* op = node_rdy_first(); op; op = next) {
+    next = node_rdy_next(op);
     if(op->state == OS_SCHEDULED || op->state == OS_MISS) {
       DEBUG(node->proc_id,
             "Removing from RS (and ready list)  op_num:%s op:%s l1:%d\n",
             unsstr64(op->op_num), disasm_op(op, TRUE), op->engine_info.l1_miss);
-      *last           = op->next_rdy;
-      op->in_rdy_list = FALSE;
+      node_rdy_remove(op);
       ASSERT(node->proc_id, node->rs[op->rs_id].rs_op_count > 0);
       node->rs[op->rs_id].rs_op_count--;
-    } else {
-      last = &op->next_rdy;
     }
   }
 }
@@ -992,7 +1019,7 @@ void node_handle_scheduled_ops() {
 
 Flag is_node_stage_stalled() {
   return (node->node_count == NODE_TABLE_SIZE) && /* node table is full */
-         !node->rdy_head &&                       /* no ready ops */
+         !node->rdy_count &&                      /* no ready ops */
          !node->next_op_into_rs; /* no ops waiting to enter RS */
 }
 
@@ -1037,17 +1064,17 @@ Flag is_node_table_empty() {
   return FALSE;
 }
 
-void collect_not_ready_to_retire_stats(Op* op) {
-  rob_stall_reason = ROB_STALL_OTHER;
+void collect_not_ready_to_retire_stats(Op* op, Counter cycles) {
+  node->rob_stall_reason = ROB_STALL_OTHER;
   if(op->recovery_scheduled) {
-    rob_stall_reason = ROB_STALL_WAIT_FOR_RECOVERY;
+    node->rob_stall_reason = ROB_STALL_WAIT_FOR_RECOVERY;
   } else if(op->redirect_scheduled) {
-    rob_stall_reason = ROB_STALL_WAIT_FOR_REDIRECT;
+    node->rob_stall_reason = ROB_STALL_WAIT_FOR_REDIRECT;
   }
 
   if(op->engine_info.l1_miss) {
-    rob_stall_reason = ROB_STALL_WAIT_FOR_L1_MISS;
-    STAT_EVENT(op->proc_id, RET_BLOCKED_L1_MISS);
+    node->rob_stall_reason = ROB_STALL_WAIT_FOR_L1_MISS;
+    INC_STAT_EVENT(op->proc_id, RET_BLOCKED_L1_MISS, cycles);
     Flag bw_prefetch = !op->engine_info.l1_miss_satisfied &&  // op->req is OK
                                                               // to use
                        op->req->demand_match_prefetch && op->req->bw_prefetch;
@@ -1056,25 +1083,69 @@ void collect_not_ready_to_retire_stats(Op* op) {
                            !op->req->demand_match_prefetch &&
                            op->req->bw_prefetchable;
     if(bw_prefetch || bw_prefetchable)
-      STAT_EVENT(op->proc_id, RET_BLOCKED_L1_MISS_BW_PREF);
+      INC_STAT_EVENT(op->proc_id, RET_BLOCKED_L1_MISS_BW_PREF, cycles);
   }
 
   if(op->engine_info.l1_miss || op->state == OS_WAIT_MEM) {
-    rob_stall_reason = ROB_STALL_WAIT_FOR_MEMORY;
-    STAT_EVENT(op->proc_id, RET_BLOCKED_MEM_STALL);
+    node->rob_stall_reason = ROB_STALL_WAIT_FOR_MEMORY;
+    INC_STAT_EVENT(op->proc_id, RET_BLOCKED_MEM_STALL, cycles);
     if(num_offchip_stall_reqs(op->proc_id) > 0) {
-      STAT_EVENT(op->proc_id, RET_BLOCKED_OFFCHIP_DEMAND);
+      INC_STAT_EVENT(op->proc_id, RET_BLOCKED_OFFCHIP_DEMAND, cycles);
     }
   }
 
   if(op->engine_info.dcmiss) {
-    rob_stall_reason = ROB_STALL_WAIT_FOR_DC_MISS;
-    STAT_EVENT(op->proc_id, RET_BLOCKED_DC_MISS);
+    node->rob_stall_reason = ROB_STALL_WAIT_FOR_DC_MISS;
+    INC_STAT_EVENT(op->proc_id, RET_BLOCKED_DC_MISS, cycles);
     if(!op->engine_info.l1_miss)
-      STAT_EVENT(op->proc_id, RET_BLOCKED_L1_ACCESS);
+      INC_STAT_EVENT(op->proc_id, RET_BLOCKED_L1_ACCESS, cycles);
   }
 
-  node->ret_stall_length++;
+  node->ret_stall_length += cycles;
+}
+
+/**************************************************************************************/
+/* node_stage_is_idle: update_node_stage() and node_sched_ops() would move no
+ * op this cycle, and only the memory system can change that: nothing is ready
+ * or can enter the node table or the RSs, no MSHR freed up for a blocked
+ * core, and the head waits on a miss or on its sources. */
+
+Flag node_stage_is_idle(Stage_Data* src_sd) {
+  if(node->rdy_count || node->sd.op_count)
+    return FALSE;
+  if(src_sd->op_count && !is_node_table_full())
+    return FALSE;
+  if(node->next_op_into_rs && find_emptiest_rs(node->next_op_into_rs) != -1)
+    return FALSE;
+  if(node->mem_blocked &&
+     mem_can_allocate_req_buffer(node->proc_id, MRT_DFETCH, FALSE))
+    return FALSE;
+
+  Op* head = node->node_head;
+  if(head)
+    return head->state == OS_MISS ||
+           ((head->state == OS_IN_RS || head->state == OS_ISSUED) &&
+            head->srcs_not_rdy_vector);
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* node_idle_cycles: what update_node_stage() and node_sched_ops() do over the
+ * given number of cycles in which node_stage_is_idle() holds */
+
+void node_idle_cycles(Stage_Data* src_sd, Counter cycles) {
+  INC_STAT_EVENT(node->proc_id, NODE_CYCLE, cycles);
+  INC_STAT_EVENT(node->proc_id, POWER_CYCLE, cycles);
+  if(src_sd->op_count) {
+    collect_node_table_full_stats(node->node_head, cycles);
+    node->rob_block_issue_reason = ROB_BLOCK_ISSUE_FULL;
+  }
+  if(node->node_head) {
+    collect_not_ready_to_retire_stats(node->node_head, cycles);
+    INC_STAT_EVENT(node->proc_id, ROW_SIZE_0, cycles);
+  }
+  INC_STAT_EVENT(node->proc_id, CORE_MEM_BLOCKED, node->mem_blocked * cycles);
+  node->mem_block_length += node->mem_blocked * cycles;
 }
 
 Flag is_node_table_full() {
@@ -1082,18 +1153,18 @@ Flag is_node_table_full() {
   return (node->node_count == NODE_TABLE_SIZE);
 }
 
-void collect_node_table_full_stats(Op* op) {
+void collect_node_table_full_stats(Op* op, Counter cycles) {
   if(!(op->state == OS_DONE || OP_DONE(op))) {
     if(op->table_info->op_type == OP_ILD || op->table_info->op_type == OP_IST ||
        op->table_info->op_type == OP_FLD || op->table_info->op_type == OP_FST) {
-      STAT_EVENT(node->proc_id, FULL_WINDOW_MEM_OP);
+      INC_STAT_EVENT(node->proc_id, FULL_WINDOW_MEM_OP, cycles);
     } else if(op->table_info->op_type >= OP_FCVT &&
               op->table_info->op_type <= OP_FCMOV) {
-      STAT_EVENT(node->proc_id, FULL_WINDOW_FP_OP);
+      INC_STAT_EVENT(node->proc_id, FULL_WINDOW_FP_OP, cycles);
     } else {
-      STAT_EVENT(node->proc_id, FULL_WINDOW_OTHER_OP);
+      INC_STAT_EVENT(node->proc_id, FULL_WINDOW_OTHER_OP, cycles);
     }
   }
 
-  STAT_EVENT(node->proc_id, FULL_WINDOW_STALL);
+  INC_STAT_EVENT(node->proc_id, FULL_WINDOW_STALL, cycles);
 }
@@ -58,6 +58,10 @@ typedef struct Node_Stage_struct {
   Op* rdy_head;  // linked-list of ops that are ready to schedule. Ops
                  // are put in here when they are issued, or after they
                  // are issued and another op wakes them up.
+  uns64* rdy_bits;   // with RDY_LIST_OLDEST_FIRST, the ready ops instead, one
+                     // bit per node table slot (op->rob_slot)
+  Op**   rdy_ops;    // ready op in each node table slot
+  uns    rdy_count;  // number of ready ops
 
   Counter ret_op;  // next op number to retire
 
@@ -70,13 +74,17 @@ typedef struct Node_Stage_struct {
   Flag mem_blocked;       // are we out of mem req buffers for this core
   uns  mem_block_length;  // length of the current memory block
   uns  ret_stall_length;  // length of the current retirement stall
+
+  Rob_Stall_Reason       rob_stall_reason;        // why the ROB head is not
+                                                  // retiring
+  Rob_Block_Issue_Reason rob_block_issue_reason;  // why ops are not issued
 } Node_Stage;
 
 
 /**************************************************************************************/
 // External Variables
 
-extern Node_Stage* node;
+extern __thread Node_Stage* node;
 
 
 /**************************************************************************************/
@@ -97,6 +105,13 @@ void  node_issue(Stage_Data*);
 void  node_fill_rs(void);
 void  node_retire(void);
 void  check_if_mem_blocked(void);
+Flag  node_stage_is_idle(Stage_Data*);
+void  node_idle_cycles(Stage_Data*, Counter cycles);
+
+/* ready ops, in the order the scheduler visits them */
+void node_rdy_insert(Op*);
+Op*  node_rdy_first(void);
+Op*  node_rdy_next(Op*);
 void  oldest_first_sched(Op*);
 int64 find_emptiest_rs(Op*);
 
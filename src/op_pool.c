@@ -28,6 +28,10 @@ Ops, thus eliminating dynamic allocation all over the place.  Basically, it
 allocates them once and then hands out pointers every time 'alloc_op' is called.
 ***************************************************************************************/
 
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
 #include "debug/debug_macros.h"
 #include "globals/assert.h"
 #include "globals/global_defs.h"
@@ -58,15 +62,36 @@ allocates them once and then hands out pointers every time 'alloc_op' is called.
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_OP_POOL, ##args)
 #define DEBUGU(proc_id, args...) _DEBUGU(proc_id, DEBUG_OP_POOL, ##args)
 
-// TODO: it should be increased to 512 to use more than 50,000 FDIP lookahead buffer entries
-#define OP_POOL_ENTRIES_INC 128 /* default 128 */
+/* ops are allocated in huge-page sized slabs, so that a large pool (e.g. for
+   a 50,000 entry FDIP lookahead buffer) is not spread over many small
+   mallocs and TLB entries */
+#define OP_POOL_SLAB_BYTES (2 << 20)
+#define OP_POOL_SLAB_OPS (OP_POOL_SLAB_BYTES / sizeof(Op))
+
+/* the hot fields at the head of an Op (see op.h) fit in three cache lines */
+_Static_assert(offsetof(Op, op_pool_valid) <= 3 * 64,
+               "hot Op fields spill out of their cache lines");
+
+/* Inst_Infos of fake ops (they have no static instruction to share one) are
+   allocated this many at a time */
+#define FAKE_INST_INFO_POOL_INC 256
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Fake_Inst_Info_struct {
+  Inst_Info                     info; /* first, so the Inst_Info* is the entry */
+  struct Fake_Inst_Info_struct* next;
+} Fake_Inst_Info;
 
 /**************************************************************************************/
 /* Global variables */
 
-uns        op_pool_entries    = 0;
-uns        op_pool_active_ops = 0;
-static Op* op_pool_free_head;
+uns        op_pool_entries = 0;
+uns        op_pool_active_ops[MAX_NUM_PROCS];
+static Op* op_pool_free_head[MAX_NUM_PROCS]; /* each core allocates from and
+                                                 frees to its own list */
+static Fake_Inst_Info* fake_inst_info_free_head[MAX_NUM_PROCS];
 
 Op invalid_op;
 
@@ -75,7 +100,7 @@ Op invalid_op;
 /* Prototypes */
 
 
-static inline void expand_op_pool(void);
+static inline void expand_op_pool(uns proc_id);
 
 
 /**************************************************************************************/
@@ -94,7 +119,7 @@ void init_op_pool() {
   reset_op_pool();
 
   /* allocate memory for op pool */
-  expand_op_pool();
+  expand_op_pool(0);
 }
 
 
@@ -103,8 +128,8 @@ void init_op_pool() {
 
 void reset_op_pool() {
   DEBUGU(0, "Resetting op pool...\n");
-  op_pool_entries    = 0;
-  op_pool_active_ops = 0;
+  op_pool_entries = 0;
+  memset(op_pool_active_ops, 0, sizeof(op_pool_active_ops));
 }
 
 
@@ -114,21 +139,20 @@ void reset_op_pool() {
 Op* alloc_op(uns proc_id) {
   Op* new_op;
 
-  if(op_pool_free_head == NULL) {
-    ASSERT(0, op_pool_active_ops == op_pool_entries);
-    expand_op_pool();
-  }
+  ASSERT(proc_id, proc_id < MAX_NUM_PROCS);
+  if(op_pool_free_head[proc_id] == NULL)
+    expand_op_pool(proc_id);
 
-  new_op = op_pool_free_head;
+  new_op = op_pool_free_head[proc_id];
   ASSERT(0, !new_op->op_pool_valid);
   new_op->op_pool_valid = TRUE;
 
   op_pool_setup_op(proc_id, new_op);
 
-  op_pool_active_ops++;
+  op_pool_active_ops[proc_id]++;
   DEBUG(0, "Allocating op  id:%u  op_pool_active_ops:%u  op_pool_entries:%d\n",
-        new_op->op_pool_id, op_pool_active_ops, op_pool_entries);
-  op_pool_free_head = new_op->op_pool_next;
+        new_op->op_pool_id, op_pool_active_ops[proc_id], op_pool_entries);
+  op_pool_free_head[proc_id] = new_op->op_pool_next;
 
   return new_op;
 }
@@ -145,14 +169,11 @@ void free_op(Op* op) {
     pipeview_print_op(op);
 
   op->op_pool_valid = FALSE;
-  op_pool_active_ops--;
-  ASSERTM(0, op_pool_active_ops >= 0, "op_pool_active_ops:%u\n",
-          op_pool_active_ops);
+  op_pool_active_ops[op->proc_id]--;
+  ASSERTM(0, op_pool_active_ops[op->proc_id] >= 0, "op_pool_active_ops:%u\n",
+          op_pool_active_ops[op->proc_id]);
   DEBUG(0, "Freed op  id:%u  op_pool_active_ops: %u\n", op->op_pool_id,
-        op_pool_active_ops);
-
-  if(op->sched_info)
-    free(op->sched_info);
+        op_pool_active_ops[op->proc_id]);
 
   if(op->table_info->mem_type == MEM_ST)
     delete_store_hash_entry(op);
@@ -161,16 +182,45 @@ void free_op(Op* op) {
     ASSERT(0, op->table_info == op->inst_info->table_info);
     //we no longer allocate memory for fake nops
     //free(op->inst_info->table_info);
-    free(op->inst_info);
-    op->inst_info = NULL;
+    Fake_Inst_Info* entry = (Fake_Inst_Info*)op->inst_info;
+    entry->next           = fake_inst_info_free_head[op->proc_id];
+    fake_inst_info_free_head[op->proc_id] = entry;
+    op->inst_info                         = NULL;
   }
 
-  op->op_pool_next  = op_pool_free_head;
-  op_pool_free_head = op;
+  op->op_pool_next                = op_pool_free_head[op->proc_id];
+  op_pool_free_head[op->proc_id] = op;
   free_wake_up_list(op);
 }
 
 
+/**************************************************************************************/
+/* alloc_fake_inst_info: returns a zeroed Inst_Info for a fake op, which
+   free_op gives back */
+
+Inst_Info* alloc_fake_inst_info(uns proc_id) {
+  Fake_Inst_Info* entry;
+  uns             ii;
+
+  ASSERT(proc_id, proc_id < MAX_NUM_PROCS);
+  if(fake_inst_info_free_head[proc_id] == NULL) {
+    entry = (Fake_Inst_Info*)malloc(FAKE_INST_INFO_POOL_INC *
+                                    sizeof(Fake_Inst_Info));
+    if(!entry)
+      FATAL_ERROR(proc_id, "Could not allocate fake inst infos\n");
+    for(ii = 0; ii < FAKE_INST_INFO_POOL_INC - 1; ii++)
+      entry[ii].next = &entry[ii + 1];
+    entry[ii].next                    = NULL;
+    fake_inst_info_free_head[proc_id] = entry;
+  }
+
+  entry                             = fake_inst_info_free_head[proc_id];
+  fake_inst_info_free_head[proc_id] = entry->next;
+  memset(&entry->info, 0, sizeof(Inst_Info));
+  return &entry->info;
+}
+
+
 /**************************************************************************************/
 /* op_pool_init_op: this function is called only once per op
    struct---when it is first allocated.  Intialization put in here
@@ -179,6 +229,7 @@ void free_op(Op* op) {
 void op_pool_init_op(Op* op) {
   op->oracle_info.mispred  = FALSE;
   op->oracle_info.misfetch = FALSE;
+  op->dep_slot             = MAX_UNS;
 }
 
 
@@ -196,7 +247,6 @@ void op_pool_setup_op(uns proc_id, Op* op) {
   op->srcs_not_rdy_vector     = 0x0;
   op->derived_from_prog_input = 0;
   op->sources_addr_reg        = 0;
-  op->sched_info              = NULL;
   op->marked                  = FALSE;
 
   op->op_num              = op_count[proc_id];
@@ -263,25 +313,33 @@ void op_pool_setup_op(uns proc_id, Op* op) {
 
 
 /**************************************************************************************/
-/* expand_op_pool: */
-
-static inline void expand_op_pool() {
-  Op* new_pool = (Op*)calloc(OP_POOL_ENTRIES_INC, sizeof(Op));
-  uns ii;
-
-  DEBUGU(0, "Expanding op pool to size %d\n",
-         op_pool_entries + OP_POOL_ENTRIES_INC);
-  for(ii = 0; ii < OP_POOL_ENTRIES_INC - 1; ii++) {
+/* expand_op_pool: adds one slab of ops to the core's free list */
+
+static inline void expand_op_pool(uns proc_id) {
+  Op*   new_pool;
+  uns   ii;
+  void* slab;
+
+  if(posix_memalign(&slab, OP_POOL_SLAB_BYTES, OP_POOL_SLAB_BYTES))
+    FATAL_ERROR(0, "Could not allocate an op pool slab\n");
+#ifdef MADV_HUGEPAGE
+  madvise(slab, OP_POOL_SLAB_BYTES, MADV_HUGEPAGE);
+#endif
+  memset(slab, 0, OP_POOL_SLAB_BYTES);
+  new_pool = (Op*)slab;
+
+  DEBUGU(0, "Expanding op pool of core %u to size %d\n", proc_id,
+         op_pool_entries + (uns)OP_POOL_SLAB_OPS);
+  for(ii = 0; ii < OP_POOL_SLAB_OPS - 1; ii++) {
     new_pool[ii].op_pool_valid = FALSE;
     new_pool[ii].op_pool_next  = &new_pool[ii + 1];
     new_pool[ii].op_pool_id    = op_pool_entries++;
     op_pool_init_op(&new_pool[ii]);
   }
   new_pool[ii].op_pool_valid = FALSE;
-  new_pool[ii].op_pool_next  = op_pool_free_head;
+  new_pool[ii].op_pool_next  = op_pool_free_head[proc_id];
   new_pool[ii].op_pool_id    = op_pool_entries++;
   op_pool_init_op(&new_pool[ii]);
 
-  op_pool_free_head = &new_pool[0];
-  ASSERT(0, op_pool_entries <= OP_POOL_ENTRIES_INC * 128);
+  op_pool_free_head[proc_id] = &new_pool[0];
 }
@@ -33,12 +33,14 @@
 extern "C" {
 #endif
 
+#include "globals/global_defs.h"
+
 /**************************************************************************************/
 /* Global Variables */
 
 extern Op  invalid_op;
 extern uns op_pool_entries;
-extern uns op_pool_active_ops;
+extern uns op_pool_active_ops[MAX_NUM_PROCS]; /* per core */
 
 
 /**************************************************************************************/
@@ -50,6 +52,7 @@ Op*  alloc_op(uns proc_id);
 void free_op(Op*);
 void op_pool_init_op(Op*);
 void op_pool_setup_op(uns proc_id, Op* op);
+Inst_Info* alloc_fake_inst_info(uns proc_id);
 
 /**************************************************************************************/
 
@@ -113,7 +113,6 @@ static FILE*   open_fifo(uns pid, const char* mode);
 static void    slave_clean_up(void);
 static void    master_clean_up(void);
 static void    run_master(void);
-static void    decouple_open_files(void);
 
 void init_slave(void) {
   char buf[MAX_STR_LENGTH + 1];
@@ -55,4 +55,9 @@ Flag opt2_in_use(void);
    heartbeats */
 Flag opt2_is_leader(void);
 
+/* Reopens every inherited file descriptor (except stdin/out/err) at its
+   current offset, so that a forked process no longer shares file offsets
+   with its parent */
+void decouple_open_files(void);
+
 #endif
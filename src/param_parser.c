@@ -157,6 +157,8 @@ void dump_params(char** arg_list, Param_Record used_params[], Flag exe_found);
 /* Local prototypes */
 
 static void print_help(void);
+static void parse_arg_list(uns arg_list_count, char** arg_list,
+                           Param_Record used_params[]);
 void        mark_all_params_as_unused(Param_Record* used_params);
 Flag        contains_help_options(int argc, char* argv[]);
 Flag        param_file_exists(FILE* f);
@@ -779,27 +781,15 @@ uns get_param_file_args_and_command_line_args(char*** arg_list_ptr, int argc,
          argc; /*Return the total number of args in the arg_list*/
 }
 
-char** get_params(int argc, char* argv[]) {
-  uns arg_list_count; /*Count of all args and values in the arg_list (like argc
-                         for the command line)*/
-  char** arg_list = NULL; /*Merged list of all args and values from PARAMS.in
-                             and the command line (like argv for the command
-                             line)*/
-  Param_Record used_params[NUM_PARAMS]; /*Keeps track of the values that are
-                                           actually used by the simulator. */
-
-  if(contains_help_options(argc, argv)) {
-    print_help();
-    exit(0);
-  }
-
-  arg_list_count = get_param_file_args_and_command_line_args(&arg_list, argc,
-                                                             argv);
+/**************************************************************************************/
+/* parse_arg_list: sets every parameter named in arg_list (which starts with a
+   program name, like argv) and recomputes the derived parameters. */
 
+static void parse_arg_list(uns arg_list_count, char** arg_list,
+                           Param_Record used_params[]) {
   int temp_index = 0;
   param_idx      = -1;
   opterr         = 0;  // Suppress getopt_long's error message (we have our own)
-  mark_all_params_as_unused(used_params);
   while(getopt_long(arg_list_count, arg_list, "", long_options, &temp_index) !=
         -1) {
     int index = param_idx;
@@ -844,6 +834,27 @@ char** get_params(int argc, char* argv[]) {
                      "(use --cbp_trace_r0).\n");
     }
   }
+}
+
+char** get_params(int argc, char* argv[]) {
+  uns arg_list_count; /*Count of all args and values in the arg_list (like argc
+                         for the command line)*/
+  char** arg_list = NULL; /*Merged list of all args and values from PARAMS.in
+                             and the command line (like argv for the command
+                             line)*/
+  Param_Record used_params[NUM_PARAMS]; /*Keeps track of the values that are
+                                           actually used by the simulator. */
+
+  if(contains_help_options(argc, argv)) {
+    print_help();
+    exit(0);
+  }
+
+  arg_list_count = get_param_file_args_and_command_line_args(&arg_list, argc,
+                                                             argv);
+  mark_all_params_as_unused(used_params);
+
+  parse_arg_list(arg_list_count, arg_list, used_params);
 
   ASSERTM(0, arg_list[arg_list_count] == 0x0,
           "3: Reading in parameters overflowed the space allocated for the "
@@ -852,6 +863,28 @@ char** get_params(int argc, char* argv[]) {
   return &arg_list[optind]; /* return pointer to simulated argv */
 }
 
+/**************************************************************************************/
+/* set_params: applies "--name value" overrides after get_params() (used by
+   the processes forked by a parameter sweep). */
+
+void set_params(uns num_args, char** args) {
+  char**       arg_list = (char**)malloc(sizeof(char*) * (num_args + 2));
+  Param_Record used_params[NUM_PARAMS];
+
+  arg_list[0] = "scarab";
+  for(uns ii = 0; ii < num_args; ii++)
+    arg_list[ii + 1] = args[ii];
+  arg_list[num_args + 1] = NULL;
+
+  mark_all_params_as_unused(used_params);
+  optind = 0; /* restart the getopt_long scan */
+  parse_arg_list(num_args + 1, arg_list, used_params);
+  if(optind <= num_args)
+    FATAL_ERROR(0, "Unexpected argument '%s' in parameter overrides\n",
+                arg_list[optind]);
+  free(arg_list);
+}
+
 static void print_help(void) {
   const char* help =
     "Scarab command-line option summary:\n"
@@ -325,6 +325,11 @@ int main(int argc, char* argv[]) {
   PIN_AddFiniFunction(Fini, 0);
 
   scarab = new Client(KnobSocketPath, KnobCoreId);
+  // Scarab has created the ring before accepting the connection
+  scarab_ring = ShmRing::open(
+    shm_ring_path(KnobSocketPath.Value(), KnobCoreId.Value()));
+  ASSERTM(0, !scarab_ring || max_buffer_size <= SHM_RING_BATCH_OPS,
+          "max_buffer_size is larger than SHM_RING_BATCH_OPS.\n");
 
   // Start the program, never returns
   PIN_StartProgram();
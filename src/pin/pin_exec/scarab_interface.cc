@@ -26,7 +26,10 @@ Scarab_To_Pin_Msg get_scarab_cmd() {
 
   DBG_PRINT(uid_ctr, dbg_print_start_uid, dbg_print_end_uid,
             "START: Receiving from Scarab\n");
-  cmd = scarab->receive<Scarab_To_Pin_Msg>();
+  if(scarab_ring)
+    cmd = scarab_ring->receive_cmd();
+  else
+    cmd = scarab->receive<Scarab_To_Pin_Msg>();
   DBG_PRINT(uid_ctr, dbg_print_start_uid, dbg_print_end_uid,
             "END: %d Received from Scarab\n", cmd.type);
 
@@ -45,10 +48,14 @@ bool scarab_buffer_full() {
 }
 
 void scarab_send_buffer() {
-  Message<ScarabOpBuffer_type> message = scarab_op_buffer;
   DBG_PRINT(uid_ctr, dbg_print_start_uid, dbg_print_end_uid,
             "START: Sending message to Scarab.\n");
-  scarab->send(message);
+  if(scarab_ring) {
+    scarab_ring->send_batch(scarab_op_buffer);
+  } else {
+    Message<ScarabOpBuffer_type> message = scarab_op_buffer;
+    scarab->send(message);
+  }
   DBG_PRINT(uid_ctr, dbg_print_start_uid, dbg_print_end_uid,
             "END: Sending message to Scarab.\n");
   scarab_op_buffer.clear();
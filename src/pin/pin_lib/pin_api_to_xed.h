@@ -41,6 +41,8 @@ extern "C" {
 
 enum class CustomOp : uint8_t { NONE, PREFETCH_CODE };
 
+struct DecodeCacheEntry;
+
 struct InstInfo {
   uint64_t                  pc;           // instruction address
   const xed_decoded_inst_t* ins;          // XED info
@@ -59,6 +61,9 @@ struct InstInfo {
   bool last_inst_from_trace;
   // used by MEMTRACE frontend to distinguish fetched/non-fetched inst
   bool fetched_instruction;
+  // used by MEMTRACE frontend to memoize the decoded static info, NULL if the
+  // instruction is not cached
+  DecodeCacheEntry* decode_entry;
 };
 
 #define XED_OP_NAME(ins, op) \
@@ -0,0 +1,197 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : shm_ring_interface_lib.cc
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : Setting up and tearing down the shared-memory ring, and the
+ *                blocking send and receive calls of both rings. Scarab creates
+ *                the file (in /dev/shm when it exists) and links it next to
+ *                the socket path, where PIN maps it. A side that waits polls,
+ *                then yields, then sleeps, and fails if the other process has
+ *                exited.
+ ***************************************************************************************/
+
+#include "shm_ring_interface_lib.h"
+
+extern "C" {
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+#include <algorithm>
+#include "message_queue_interface_lib.h"
+
+#define SHM_RING_DIR "/dev/shm"
+#define SHM_RING_SPINS 4096      // polls before yielding the cpu
+#define SHM_RING_YIELDS 65536    // yields before sleeping between polls
+#define SHM_RING_SLEEP_US 50
+#define SHM_RING_PEER_CHECK 4096  // polls between checks that the peer lives
+
+std::string shm_ring_path(const std::string& socket_path, uint32_t client_id) {
+  return socket_path + "." + std::to_string(client_id) + ".ring";
+}
+
+/********************************************************************************************
+ * ShmRing Functions
+ *******************************************************************************************/
+
+ShmRing::ShmRing(ShmRingLayout* _ring, bool _is_server,
+                 const std::string& _path, const std::string& _file) :
+    ring(_ring), is_server(_is_server), path(_path), file(_file) {}
+
+ShmRing* ShmRing::create(const std::string& path) {
+  static uint32_t num_rings = 0;
+  struct stat     sb;
+
+  // The ring lives in memory; the link next to the socket tells PIN where
+  std::string file = path;
+  if(stat(SHM_RING_DIR, &sb) == 0 && S_ISDIR(sb.st_mode))
+    file = std::string(SHM_RING_DIR) + "/scarab_ring." +
+           std::to_string(getpid()) + "." + std::to_string(num_rings++);
+
+  unlink(path.c_str());
+  unlink(file.c_str());
+  int fd = ::open(file.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  assertm(fd != -1, "Could not create the shared memory ring file.\n");
+  assertm(ftruncate(fd, sizeof(ShmRingLayout)) == 0,
+          "Could not size the shared memory ring file.\n");
+  void* mem = mmap(NULL, sizeof(ShmRingLayout), PROT_READ | PROT_WRITE,
+                   MAP_SHARED, fd, 0);
+  close(fd);
+  assertm(mem != MAP_FAILED, "Could not map the shared memory ring.\n");
+  if(file != path)
+    assertm(symlink(file.c_str(), path.c_str()) == 0,
+            "Could not link the shared memory ring.\n");
+
+  // The file starts zeroed, which is the empty state of the indices
+  ShmRingLayout* ring = static_cast<ShmRingLayout*>(mem);
+  ring->size          = sizeof(ShmRingLayout);
+  ring->server_pid.store(getpid());
+  std::atomic_thread_fence(std::memory_order_release);
+  ring->magic = SHM_RING_MAGIC;
+  return new ShmRing(ring, true, path, file);
+}
+
+ShmRing* ShmRing::open(const std::string& path) {
+  struct stat sb;
+  int         fd = ::open(path.c_str(), O_RDWR);
+  if(fd == -1)
+    return nullptr;
+  if(fstat(fd, &sb) != 0 || (size_t)sb.st_size != sizeof(ShmRingLayout)) {
+    close(fd);
+    assertm(false, "The shared memory ring was created by a different "
+                   "build of Scarab.\n");
+  }
+  void* mem = mmap(NULL, sizeof(ShmRingLayout), PROT_READ | PROT_WRITE,
+                   MAP_SHARED, fd, 0);
+  close(fd);
+  assertm(mem != MAP_FAILED, "Could not map the shared memory ring.\n");
+
+  ShmRingLayout* ring = static_cast<ShmRingLayout*>(mem);
+  assertm(ring->magic == SHM_RING_MAGIC &&
+            ring->size == sizeof(ShmRingLayout),
+          "The shared memory ring was created by a different build of "
+          "Scarab.\n");
+  std::atomic_thread_fence(std::memory_order_acquire);
+  ring->client_pid.store(getpid());
+  return new ShmRing(ring, false, path, path);
+}
+
+ShmRing::~ShmRing() {
+  munmap(ring, sizeof(ShmRingLayout));
+  if(is_server) {
+    unlink(path.c_str());
+    unlink(file.c_str());
+  }
+}
+
+// Called while the other side has not caught up: polls, then yields, then
+// sleeps, and makes sure the other side is still running
+void ShmRing::wait(uint32_t spins) {
+  if(spins < SHM_RING_SPINS)
+    return;
+  if(spins % SHM_RING_PEER_CHECK == 0) {
+    int32_t peer = is_server ? ring->client_pid.load() :
+                               ring->server_pid.load();
+    assertm(!peer || kill(peer, 0) == 0 || errno != ESRCH,
+            is_server ? "PIN process died while Scarab was waiting.\n" :
+                        "Scarab died while PIN was waiting.\n");
+  }
+  if(spins < SHM_RING_SPINS + SHM_RING_YIELDS)
+    sched_yield();
+  else
+    usleep(SHM_RING_SLEEP_US);
+}
+
+void ShmRing::send_cmd(const Scarab_To_Pin_Msg& msg) {
+  uint64_t tail = ring->cmd_tail.load(std::memory_order_relaxed);
+  for(uint32_t spins = 0; tail - ring->cmd_head.load(std::memory_order_acquire) ==
+                          SHM_RING_CMD_SLOTS;
+      spins++)
+    wait(spins);
+  ring->cmds[tail & (SHM_RING_CMD_SLOTS - 1)] = msg;
+  ring->cmd_tail.store(tail + 1, std::memory_order_release);
+}
+
+Scarab_To_Pin_Msg ShmRing::receive_cmd() {
+  uint64_t head = ring->cmd_head.load(std::memory_order_relaxed);
+  for(uint32_t spins = 0;
+      ring->cmd_tail.load(std::memory_order_acquire) == head; spins++)
+    wait(spins);
+  Scarab_To_Pin_Msg msg = ring->cmds[head & (SHM_RING_CMD_SLOTS - 1)];
+  ring->cmd_head.store(head + 1, std::memory_order_release);
+  return msg;
+}
+
+void ShmRing::send_batch(const ScarabOpBuffer_type& ops) {
+  assertm(ops.size() <= SHM_RING_BATCH_OPS,
+          "The op buffer is larger than SHM_RING_BATCH_OPS.\n");
+  uint64_t tail = ring->batch_tail.load(std::memory_order_relaxed);
+  for(uint32_t spins = 0;
+      tail - ring->batch_head.load(std::memory_order_acquire) ==
+      SHM_RING_BATCHES;
+      spins++)
+    wait(spins);
+  ShmOpBatch* batch = &ring->batches[tail % SHM_RING_BATCHES];
+  batch->num_ops    = ops.size();
+  std::copy(ops.begin(), ops.end(), batch->ops);
+  ring->batch_tail.store(tail + 1, std::memory_order_release);
+}
+
+ShmOpBatch* ShmRing::receive_batch() {
+  uint64_t head = ring->batch_head.load(std::memory_order_relaxed);
+  for(uint32_t spins = 0;
+      ring->batch_tail.load(std::memory_order_acquire) == head; spins++)
+    wait(spins);
+  return &ring->batches[head % SHM_RING_BATCHES];
+}
+
+void ShmRing::release_batch() {
+  uint64_t head = ring->batch_head.load(std::memory_order_relaxed);
+  ring->batch_head.store(head + 1, std::memory_order_release);
+}
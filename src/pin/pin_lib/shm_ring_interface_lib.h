@@ -0,0 +1,103 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : shm_ring_interface_lib.h
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : Shared-memory transport between Scarab and one pin_exec
+ *                client. Commands (Scarab_To_Pin_Msg) go through a
+ *                single-producer/single-consumer ring from Scarab to PIN, and
+ *                op buffers through a ring of fixed-size batches from PIN to
+ *                Scarab, which reads the ops in place. Neither side makes a
+ *                system call unless it has been waiting for a while. The
+ *                socket is still used to connect the processes.
+ *
+ *                Scarab creates the ring in /dev/shm before accepting the
+ *                clients and links it at shm_ring_path(), where PIN looks for
+ *                it once connected.
+ ***************************************************************************************/
+
+#ifndef __SHM_RING_INTERFACE_LIB_H__
+#define __SHM_RING_INTERFACE_LIB_H__
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include "pin_scarab_common_lib.h"
+
+#define SHM_RING_MAGIC 0x5343524253484d31ull  // "SCRBSHM1"
+#define SHM_RING_CMD_SLOTS 256                // power of two
+#define SHM_RING_BATCHES 2  // Scarab reads one batch while PIN sends the next
+#define SHM_RING_BATCH_OPS 64
+
+struct ShmOpBatch {
+  uint32_t      num_ops;
+  compressed_op ops[SHM_RING_BATCH_OPS];
+};
+
+// The mapped file. Each index is written by one side only, and sits on its own
+// cache line.
+struct ShmRingLayout {
+  uint64_t             magic;
+  uint64_t             size;  // sizeof(ShmRingLayout) of the creator
+  std::atomic<int32_t> server_pid;
+  std::atomic<int32_t> client_pid;
+  alignas(64) std::atomic<uint64_t> cmd_head;
+  alignas(64) std::atomic<uint64_t> cmd_tail;
+  alignas(64) std::atomic<uint64_t> batch_head;
+  alignas(64) std::atomic<uint64_t> batch_tail;
+  Scarab_To_Pin_Msg cmds[SHM_RING_CMD_SLOTS];
+  ShmOpBatch        batches[SHM_RING_BATCHES];
+};
+
+std::string shm_ring_path(const std::string& socket_path, uint32_t client_id);
+
+class ShmRing {
+ public:
+  // Scarab side: creates the ring of a client
+  static ShmRing* create(const std::string& path);
+  // PIN side: maps the ring Scarab created, nullptr if there is none
+  static ShmRing* open(const std::string& path);
+  ~ShmRing();
+
+  // Scarab side
+  void send_cmd(const Scarab_To_Pin_Msg& msg);
+  // The next op buffer, read in place until release_batch()
+  ShmOpBatch* receive_batch();
+  void        release_batch();
+
+  // PIN side
+  Scarab_To_Pin_Msg receive_cmd();
+  void              send_batch(const ScarabOpBuffer_type& ops);
+
+ private:
+  ShmRing(ShmRingLayout* _ring, bool _is_server, const std::string& _path,
+          const std::string& _file);
+  void wait(uint32_t spins);
+
+  ShmRingLayout* ring;
+  bool           is_server;
+  std::string    path;  // the link PIN opens
+  std::string    file;  // the ring itself
+};
+
+#endif
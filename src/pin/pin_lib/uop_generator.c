@@ -38,6 +38,7 @@
 #include "../../bp/bp.h"
 #include "../../bp/bp.param.h"
 #include "../../general.param.h"
+#include "../../op_pool.h"
 #include "../../statistics.h"
 
 #include "../../ctype_pin_inst.h"
@@ -826,28 +827,36 @@ static uns generate_uops(uns8 proc_id, ctype_pin_inst* pi,
   return idx;
 }
 
+// Instances of the same gather/scatter instruction can access a different
+// number of elements, so each shape gets a template of its own
+static uint64_t uop_template_variant(ctype_pin_inst* pi) {
+  if(!pi->is_gather_scatter)
+    return 0;
+  return 1 | ((uint64_t)pi->num_ld << 8) | ((uint64_t)pi->num_st << 16) |
+         ((uint64_t)pi->ld_size << 24) | ((uint64_t)pi->st_size << 32);
+}
+
 void convert_pinuop_to_t_uop(uns8 proc_id, ctype_pin_inst* pi,
                              Trace_Uop** trace_uop) {
-  Flag new_entry = FALSE;
-  Inst_Info* info;
-  // Due to JIT compilation, each branch must be decoded to verify which instruction the PC maps to.
-  // To decrease unnecessary malloc/free, fetch inst_info from hashmap
-  // instead of allocating. However first instruction must be decoded.
+  Flag          new_entry = FALSE;
+  Uop_Template* tmpl      = NULL;
+  Inst_Info*    info      = NULL;
+  // Due to JIT compilation, each branch must be decoded to verify which
+  // instruction the PC maps to. The uops of a static instruction are built
+  // the first time it is seen and kept in a template, so later instances only
+  // fill in their dynamic fields (addresses, direction, target). Fake
+  // instructions have no static identity: they copy the first one built into
+  // an Inst_Info from the op pool.
   static Inst_Info dummy_nop;
   static Flag generated_dummy_nop = FALSE;
+  Flag need_to_gen_uops;
   if(pi->fake_inst) {
-    info                   = (Inst_Info*)calloc(1, sizeof(Inst_Info));
-    if (generated_dummy_nop) {
-      *info = dummy_nop;
-      info->addr = pi->instruction_addr;
-    }
-    info->fake_inst        = TRUE;
-    info->fake_inst_reason = pi->fake_inst_reason;
+    need_to_gen_uops = !generated_dummy_nop;
   } else {
-    info = cpp_hash_table_access_create(proc_id, pi->instruction_addr, pi->inst_binary_lsb,
-                                        pi->inst_binary_msb, 0, &new_entry);
-    info->fake_inst        = FALSE;
-    info->fake_inst_reason = WPNM_NOT_IN_WPNM;
+    tmpl = cpp_hash_table_access_uop_template(
+      proc_id, pi->instruction_addr, pi->inst_binary_lsb, pi->inst_binary_msb,
+      uop_template_variant(pi), &new_entry);
+    need_to_gen_uops = new_entry;
   }
   int ii;
   int num_uop = 0;
@@ -867,38 +876,27 @@ void convert_pinuop_to_t_uop(uns8 proc_id, ctype_pin_inst* pi,
     pi->st_vaddr[st] = convert_to_cmp_addr(proc_id, pi->st_vaddr[st]);
   }
 
-  Flag need_to_gen_uops = new_entry || (pi->fake_inst && !generated_dummy_nop) ||
-                          pi->is_gather_scatter /* always regenerate uops for
-                                                   gather/scatter, because the
-                                                   num of uops could be
-                                                   different every time*/
-    ;
-
-  if (pi->fake_inst && !generated_dummy_nop)
-    generated_dummy_nop = TRUE;
-
   if(need_to_gen_uops) {
     num_uop = generate_uops(proc_id, pi, trace_uop);
     ASSERT(proc_id, num_uop > 0);
 
-    info->trace_info.num_uop = num_uop;
+    if(tmpl) {
+      tmpl->num_uop = num_uop;
+      tmpl->info    = (Inst_Info*)calloc(num_uop, sizeof(Inst_Info));
+      ASSERT(proc_id, tmpl->info);
+    }
 
     for(ii = 0; ii < num_uop; ii++) {
-      if(ii > 0) {
-        if(pi->fake_inst) {
-          info                   = (Inst_Info*)calloc(1, sizeof(Inst_Info));
-          info->fake_inst        = TRUE;
-          info->fake_inst_reason = pi->fake_inst_reason;
-        } else {
-          info = cpp_hash_table_access_create(proc_id, pi->instruction_addr, pi->inst_binary_lsb,
-                                              pi->inst_binary_msb, ii, &new_entry);
-
-          info->fake_inst        = FALSE;
-          info->fake_inst_reason = WPNM_NOT_IN_WPNM;
-        }
+      if(pi->fake_inst) {
+        info                   = alloc_fake_inst_info(proc_id);
+        info->fake_inst        = TRUE;
+        info->fake_inst_reason = pi->fake_inst_reason;
+      } else {
+        info                   = &tmpl->info[ii];
+        info->fake_inst        = FALSE;
+        info->fake_inst_reason = WPNM_NOT_IN_WPNM;
       }
-      need_to_gen_uops = new_entry || pi->fake_inst || pi->is_gather_scatter;
-      ASSERT(proc_id, need_to_gen_uops);
+      info->trace_info.num_uop = num_uop;
 
       trace_uop[ii]->addr      = pi->instruction_addr;
       trace_uop[ii]->inst_size = pi->size;
@@ -931,23 +929,27 @@ void convert_pinuop_to_t_uop(uns8 proc_id, ctype_pin_inst* pi,
       Flag is_last_uop = (ii == (num_uop - 1));
       convert_dyn_uop(proc_id, info, pi, trace_uop[ii],
                       info->table_info->mem_size, is_last_uop);
-      if  (pi->fake_inst) {
-        ASSERT(0, generated_dummy_nop);
-        dummy_nop = *info;
+      if(pi->fake_inst) {
+        generated_dummy_nop = TRUE;
+        dummy_nop           = *info;
       }
     }
   } else {
-    // instructions is decoded before .
-
-    num_uop = info->trace_info.num_uop;
-    ASSERT(proc_id, !(pi->is_gather_scatter));
+    // instructions is decoded before: only the dynamic fields change
+    if(pi->fake_inst) {
+      ASSERT(proc_id, dummy_nop.trace_info.num_uop == 1);
+      num_uop                = 1;
+      info                   = alloc_fake_inst_info(proc_id);
+      *info                  = dummy_nop;
+      info->addr             = pi->instruction_addr;
+      info->fake_inst_reason = pi->fake_inst_reason;
+    } else {
+      num_uop = tmpl->num_uop;
+    }
 
     for(ii = 0; ii < num_uop; ii++) {
-      if(ii > 0) {
-        info = cpp_hash_table_access_create(proc_id, pi->instruction_addr, pi->inst_binary_lsb,
-                                        pi->inst_binary_msb, ii, &new_entry);
-      }
-      ASSERT(proc_id, !new_entry);
+      if(tmpl)
+        info = &tmpl->info[ii];
 
       trace_uop[ii]->info = info;
       trace_uop[ii]->eom  = FALSE;
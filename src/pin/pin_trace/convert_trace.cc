@@ -0,0 +1,68 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/* Converts a bzip2 compressed pin trace into the compact trace format
+   (frontend/compact_trace.h). Memtraces are converted by running scarab with
+   --compact_trace_output. */
+
+#include <cstdio>
+#include <cstdlib>
+#include <inttypes.h>
+#include <iostream>
+#include <sys/stat.h>
+
+#include "../../frontend/compact_trace.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+  if(argc < 3) {
+    cerr << "Usage: convert_trace <bz2 trace file> <compact trace file>"
+         << endl;
+    exit(1);
+  }
+
+  char cmdline[1024];
+  sprintf(cmdline, "bzip2 -dc %s", argv[1]);
+  FILE* orig_stream = popen(cmdline, "r");
+  if(!orig_stream) {
+    cerr << "Cannot open trace file: " << argv[1] << endl;
+    exit(1);
+  }
+
+  uint64_t inst_count = 0;
+  {
+    Compact_Trace_Writer writer(argv[2]);
+    ctype_pin_inst       pin_inst;
+    while(fread(&pin_inst, sizeof(ctype_pin_inst), 1, orig_stream)) {
+      writer.write(&pin_inst);
+      inst_count++;
+    }
+  }
+  pclose(orig_stream);
+
+  struct stat st;
+  stat(argv[2], &st);
+  cout << inst_count << " instructions, "
+       << inst_count * sizeof(ctype_pin_inst) << " bytes uncompressed, "
+       << st.st_size << " bytes compact" << endl;
+  return 0;
+}
@@ -32,7 +32,7 @@ extern "C" {
 #include <memory>
 #include <numeric>
 
-uint32_t djolt_proc_id;
+__thread uint32_t djolt_proc_id;
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_DJOLT, ##args)
 // ============================================================
 //  D-JOLT parameters.
@@ -29,7 +29,7 @@ extern "C" {
 using std::cout;
 using std::endl;
 
-uint32_t fnlmma_proc_id;
+__thread uint32_t fnlmma_proc_id;
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_FNLMMA, ##args)
 
 #define AHEADPRED
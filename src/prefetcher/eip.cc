@@ -66,7 +66,7 @@ extern int per_cyc_ipref;
 extern const int MAX_FTQ_ENTRY_CYC;
 
 // To access cpu in my functions
-uint32_t eip_proc_id;
+__thread uint32_t eip_proc_id;
 uint32_t L1I_RQ_SIZE = 0;
 uint32_t L1I_TIMING_MSHR_SIZE = 0;
 uint32_t L1I_SET = 0;
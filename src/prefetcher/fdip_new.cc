@@ -20,10 +20,10 @@ extern "C" {
 #include <tuple>
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_FDIP, ##args)
 
-decoupled_fe_iter* iter;
+__thread decoupled_fe_iter* iter;
 extern const int MAX_FTQ_ENTRY_CYC = 2;
-int fdip_proc_id;
-Icache_Stage *ic_ref;
+__thread int fdip_proc_id;
+__thread Icache_Stage *ic_ref;
 std::vector<Op*> per_core_cur_op;
 std::vector<decoupled_fe_iter*> per_core_ftq_iter;
 std::vector<Addr> per_core_last_line_addr;
@@ -593,6 +593,40 @@ void update_fdip() {
   per_core_last_break_reason[ic_ref->proc_id] = break_reason;
 }
 
+uint64_t fdip_ftq_iter_offset(uns proc_id) {
+  return decoupled_fe_ftq_iter_offset(per_core_ftq_iter[proc_id]);
+}
+
+// The FDIP iterator has walked every op in the FTQ, so update_fdip() has
+// nothing left to prefetch this cycle
+Flag fdip_ftq_drained(uns proc_id) {
+  if (!FDIP_ENABLE)
+    return TRUE;
+  return decoupled_fe_ftq_iter_offset(per_core_ftq_iter[proc_id]) == decoupled_fe_ftq_num_ops();
+}
+
+// What update_fdip() does over the given number of cycles in which the FTQ
+// is drained
+void fdip_idle_cycles(uns proc_id, Counter cycles) {
+  if (!FDIP_ENABLE)
+    return;
+  if (FULL_WARMUP && warmup_dump_done[proc_id] && !per_core_warmed_up[proc_id])
+    per_core_warmed_up[proc_id] = TRUE;
+  per_cyc_ipref = 0;
+  if (FDIP_UTILITY_HASH_ENABLE || FDIP_UC_SIZE)
+    per_core_last_cl_unuseful[proc_id] = 0;
+  decoupled_fe_iter* fe_iter = per_core_ftq_iter[proc_id];
+  FDIP_Break break_reason = decoupled_fe_ftq_iter_ft_offset(fe_iter) ? BR_REACH_FTQ_END : BR_FTQ_EMPTY;
+  INC_STAT_EVENT(proc_id, FDIP_BREAK_REACH_FTQ_END + break_reason, cycles);
+  per_core_fdip_ftq_occupancy_ops[proc_id] += decoupled_fe_ftq_iter_offset(fe_iter) * cycles;
+  INC_STAT_EVENT(proc_id, FDIP_FTQ_OCCUPANCY_OPS_ACCUMULATED, decoupled_fe_ftq_iter_offset(fe_iter) * cycles);
+  if (break_reason == BR_REACH_FTQ_END) {
+    per_core_fdip_ftq_occupancy_blocks[proc_id] += decoupled_fe_ftq_iter_ft_offset(fe_iter) * cycles;
+    INC_STAT_EVENT(proc_id, FDIP_FTQ_OCCUPANCY_BLOCKS_ACCUMULATED, decoupled_fe_ftq_num_fts() * cycles);
+  }
+  per_core_last_break_reason[proc_id] = break_reason;
+}
+
 uns64 fdip_get_ghist() {
   return g_bp_data->global_hist;
 }
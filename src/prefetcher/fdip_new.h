@@ -57,6 +57,9 @@ extern "C" {
   void log_stats_bp_conf();
   void log_stats_bp_conf_emitted();
   void uftq_set_ftq_ft_num(uns proc_id);
+  uint64_t fdip_ftq_iter_offset(uns proc_id);
+  Flag fdip_ftq_drained(uns proc_id);
+  void fdip_idle_cycles(uns proc_id, Counter cycles);
 
   
 #ifdef __cplusplus
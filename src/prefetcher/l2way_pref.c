@@ -55,7 +55,7 @@
 /* Global Variables */
 
 extern Memory*       mem;
-extern Dcache_Stage* dc;
+extern __thread Dcache_Stage* dc;
 
 /***************************************************************************************/
 /* Local Prototypes */
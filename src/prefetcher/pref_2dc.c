@@ -109,6 +109,29 @@ void init_2dc(HWP* hwp, Pref_2DC* tdc_hwp_core){
   tdc_hwp_core->hash_func        = PREF_2DC_HASH_FUNC_DEFAULT;
   tdc_hwp_core->pref_degree      = PREF_2DC_DEGREE;
 }
+
+/* Warm state images: the delta cache, the region deltas and the last access */
+static void pref_2dc_table_state_io(Pref_2DC* tdc_hwp, FILE* file, Flag write) {
+  if(write)
+    cache_write_state(&tdc_hwp->cache, file);
+  else
+    cache_read_state(&tdc_hwp->cache, file);
+  pref_state_array(tdc_hwp->regions,
+                   sizeof(Pref_2DC_Region) * PREF_2DC_NUM_REGIONS, file, write);
+  pref_state_array(&tdc_hwp->last_access, sizeof(tdc_hwp->last_access), file,
+                   write);
+  pref_state_array(&tdc_hwp->last_loadPC, sizeof(tdc_hwp->last_loadPC), file,
+                   write);
+  pref_state_array(&tdc_hwp->pref_degree, sizeof(tdc_hwp->pref_degree), file,
+                   write);
+}
+
+void pref_2dc_state_io(FILE* file, Flag write) {
+  if(PREF_UMLC_ON)
+    pref_2dc_table_state_io(tdc_prefetcher_array.tdc_hwp_umlc, file, write);
+  if(PREF_UL1_ON)
+    pref_2dc_table_state_io(tdc_prefetcher_array.tdc_hwp_ul1, file, write);
+}
 void pref_2dc_ul1_prefhit(uns8 proc_id, Addr lineAddr, Addr loadPC,
                           uns32 global_hist) {
   pref_2dc_train(tdc_prefetcher_array.tdc_hwp_ul1, lineAddr, loadPC, TRUE);  // FIXME
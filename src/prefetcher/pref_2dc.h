@@ -65,6 +65,7 @@ typedef struct{
 /*************************************************************/
 /* HWP Interface */
 void pref_2dc_init(HWP* hwp);
+void pref_2dc_state_io(FILE* file, Flag write);
 
 void pref_2dc_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
                        uns32 global_hist);
@@ -78,7 +78,7 @@ static int pref_table_size;
 /* Global Variables */
 
 extern Memory*       mem;
-extern Dcache_Stage* dc;
+extern __thread Dcache_Stage* dc;
 
 HWP_Common pref;
 
@@ -93,6 +93,7 @@ static void pref_polbv_update_on_evict(uns8 pref_proc_id, uns8 evicted_proc_id,
 static void pref_polbv_lookup_on_miss(uns8 proc_id, Addr addr);
 static void pref_polbv_update_on_repref(uns8 proc_id, Addr addr);
 void        pref_feed_back_info_update(uns8 prefetcher_id);
+static void pref_state_io(FILE* file, Flag write);
 /***************************************************************************************/
 /* supporting functions */
 
@@ -262,6 +263,109 @@ void pref_done(void) {
   }
 }
 
+/**************************************************************************************/
+/* Warm state images: the framework's request queues, feedback counters,
+ * pollution bit vectors and filter tables, then the tables of each enabled
+ * prefetcher through its state_io_func. */
+
+void pref_state_array(void* ptr, size_t size, FILE* file, Flag write) {
+  size_t done = write ? fwrite(ptr, 1, size, file) : fread(ptr, 1, size, file);
+  if(done != size)
+    FATAL_ERROR(0, "Could not %s the prefetcher warm state\n",
+                write ? "write" : "read");
+}
+
+static void pref_state_io(FILE* file, Flag write) {
+  uns num_pref_cores = PREF_SHARED_QUEUES ? 1 : NUM_CORES;
+  for(uns proc_id = 0; proc_id < num_pref_cores; proc_id++) {
+    HWP_Core* pref_core = &pref.cores_array[proc_id];
+    pref_state_array(pref_core->dl0req_queue,
+                     sizeof(Pref_Mem_Req) * PREF_DL0REQ_QUEUE_SIZE, file, write);
+    pref_state_array(pref_core->umlc_req_queue,
+                     sizeof(Pref_Mem_Req) * PREF_UMLC_REQ_QUEUE_SIZE, file,
+                     write);
+    pref_state_array(pref_core->ul1req_queue,
+                     sizeof(Pref_Mem_Req) * PREF_UL1REQ_QUEUE_SIZE, file, write);
+    pref_state_array(&pref_core->dl0req_queue_req_pos,
+                     sizeof(pref_core->dl0req_queue_req_pos), file, write);
+    pref_state_array(&pref_core->dl0req_queue_send_pos,
+                     sizeof(pref_core->dl0req_queue_send_pos), file, write);
+    pref_state_array(&pref_core->umlc_req_queue_req_pos,
+                     sizeof(pref_core->umlc_req_queue_req_pos), file, write);
+    pref_state_array(&pref_core->umlc_req_queue_send_pos,
+                     sizeof(pref_core->umlc_req_queue_send_pos), file, write);
+    pref_state_array(&pref_core->ul1req_queue_req_pos,
+                     sizeof(pref_core->ul1req_queue_req_pos), file, write);
+    pref_state_array(&pref_core->ul1req_queue_send_pos,
+                     sizeof(pref_core->ul1req_queue_send_pos), file, write);
+    pref_state_array(&pref_core->ul1_misses, sizeof(pref_core->ul1_misses),
+                     file, write);
+    pref_state_array(&pref_core->curr_ul1_misses,
+                     sizeof(pref_core->curr_ul1_misses), file, write);
+    pref_state_array(&pref_core->pfpol, sizeof(pref_core->pfpol), file, write);
+    pref_state_array(&pref_core->curr_pfpol, sizeof(pref_core->curr_pfpol),
+                     file, write);
+    pref_state_array(&pref_core->update_acc, sizeof(pref_core->update_acc),
+                     file, write);
+    if(PREF_POLBV_ON)
+      pref_state_array(pref_core->pref_polbv_info,
+                       sizeof(Pref_Polbv_Info) * PREF_POLBV_SIZE, file, write);
+    if(PREF_HFILTER_ON)
+      pref_state_array(pref_core->pref_hfilter_pht,
+                       sizeof(uns8) * (0x1 << PREF_HFILTER_INDEX_BITS), file,
+                       write);
+  }
+
+  for(int ii = 0; ii < pref_table_size; ii++) {
+    HWP_Info* hwp_info = pref_table[ii].hwp_info;
+    pref_state_array(hwp_info->useful_core, sizeof(Counter) * NUM_CORES, file,
+                     write);
+    pref_state_array(hwp_info->sent_core, sizeof(Counter) * NUM_CORES, file,
+                     write);
+    pref_state_array(hwp_info->late_core, sizeof(Counter) * NUM_CORES, file,
+                     write);
+    pref_state_array(hwp_info->curr_useful_core, sizeof(Counter) * NUM_CORES,
+                     file, write);
+    pref_state_array(hwp_info->curr_sent_core, sizeof(Counter) * NUM_CORES,
+                     file, write);
+    pref_state_array(hwp_info->curr_late_core, sizeof(Counter) * NUM_CORES,
+                     file, write);
+    pref_state_array(hwp_info->dyn_degree_core, sizeof(uns) * NUM_CORES, file,
+                     write);
+  }
+
+  pref_state_array(&pref.num_ul1_evicted, sizeof(pref.num_ul1_evicted), file,
+                   write);
+  pref_state_array(&pref.num_ul1_misses, sizeof(pref.num_ul1_misses), file,
+                   write);
+  pref_state_array(&pref.curr_num_ul1_misses, sizeof(pref.curr_num_ul1_misses),
+                   file, write);
+  pref_state_array(&pref.phase, sizeof(pref.phase), file, write);
+
+  for(int ii = 0; ii < pref_table_size; ii++) {
+    HWP* hwp     = &pref_table[ii];
+    Flag enabled = hwp->hwp_info->enabled;
+    pref_state_array(&enabled, sizeof(enabled), file, write);
+    if(enabled != hwp->hwp_info->enabled)
+      FATAL_ERROR(0, "Warm state image was saved with the %s prefetcher %s\n",
+                  hwp->name, enabled ? "on" : "off");
+    if(!enabled)
+      continue;
+    if(!hwp->state_io_func)
+      FATAL_ERROR(0, "Prefetcher %s does not support warm state images\n",
+                  hwp->name);
+    hwp->state_io_func(file, write);
+  }
+}
+
+void pref_write_state(FILE* file) {
+  pref_state_io(file, TRUE);
+}
+
+void pref_read_state(FILE* file) {
+  pref_state_io(file, FALSE);
+}
+
 // FIXME LATER
 void pref_dl0_miss(Addr line_addr, Addr load_PC) {
   int ii;
@@ -868,6 +972,52 @@ void pref_update_core(uns proc_id) {
   }
 }
 
+Flag pref_queues_empty(void) {
+  if(!PREF_FRAMEWORK_ON)
+    return TRUE;
+
+  for(uns proc_id = 0; proc_id < (PREF_SHARED_QUEUES ? 1 : NUM_CORES);
+      proc_id++) {
+    HWP_Core* pref_core = pref.cores[proc_id];
+    for(uns ii = 0; ii < PREF_DL0REQ_QUEUE_SIZE; ii++)
+      if(pref_core->dl0req_queue[ii].valid)
+        return FALSE;
+    for(uns ii = 0; ii < PREF_UMLC_REQ_QUEUE_SIZE; ii++)
+      if(pref_core->umlc_req_queue[ii].valid)
+        return FALSE;
+    for(uns ii = 0; ii < PREF_UL1REQ_QUEUE_SIZE; ii++)
+      if(pref_core->ul1req_queue[ii].valid)
+        return FALSE;
+  }
+  return TRUE;
+}
+
+void pref_skip_idle_cycles(Counter cycles) {
+  if(!PREF_FRAMEWORK_ON)
+    return;
+
+  // resetting the filter again without a prefetch in between changes nothing
+  if(PREF_HFILTER_ON && PREF_HFILTER_RESET_ENABLE &&
+     cycle_count / PREF_HFILTER_RESET_INTERVAL !=
+       (cycle_count - cycles) / PREF_HFILTER_RESET_INTERVAL)
+    pref_hfilter_pht_reset();
+
+  // pref_update_core() moves past every empty entry it looks at
+  for(uns proc_id = 0; proc_id < (PREF_SHARED_QUEUES ? 1 : NUM_CORES);
+      proc_id++) {
+    HWP_Core* pref_core              = pref.cores[proc_id];
+    pref_core->dl0req_queue_send_pos = (pref_core->dl0req_queue_send_pos +
+                                        cycles * PREF_DL0SCHEDULE_NUM) %
+                                       PREF_DL0REQ_QUEUE_SIZE;
+    pref_core->umlc_req_queue_send_pos = (pref_core->umlc_req_queue_send_pos +
+                                          cycles * PREF_UMLC_SCHEDULE_NUM) %
+                                         PREF_UMLC_REQ_QUEUE_SIZE;
+    pref_core->ul1req_queue_send_pos = (pref_core->ul1req_queue_send_pos +
+                                        cycles * PREF_UL1SCHEDULE_NUM) %
+                                       PREF_UL1REQ_QUEUE_SIZE;
+  }
+}
+
 void pref_ul1sent(uns8 proc_id, Addr addr, uns8 prefetcher_id) {
   if(!PREF_FRAMEWORK_ON)
     return;
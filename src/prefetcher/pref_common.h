@@ -121,6 +121,10 @@ struct HWP_struct {
                        uns32 global_hist);  // called when a ul1 access hits a
                                             // prefetched line for the first
                                             // time
+
+  void (*state_io_func)(FILE* file, Flag write);  // saves (write) or restores
+                                                  // the trained tables for
+                                                  // warm state images
 };
 
 /* Per core prefetching data */
@@ -180,6 +184,13 @@ void pref_init(void);
 void pref_done(void);
 void pref_per_core_done(uns proc_id);
 
+/* Save or restore the framework and prefetcher tables for warm state
+   images */
+void pref_write_state(FILE* file);
+void pref_read_state(FILE* file);
+/* Reads or writes one table of a warm state image */
+void pref_state_array(void* ptr, size_t size, FILE* file, Flag write);
+
 void pref_dl0_miss(Addr line_addr, Addr load_PC);
 void pref_dl0_hit(Addr line_addr, Addr load_PC);
 void pref_dl0_pref_hit(Addr line_addr, Addr load_PC, uns8 prefetcher_id);
@@ -206,6 +217,11 @@ void pref_ul1_pref_hit_late(uns8 proc_id, Addr line_addr, Addr load_PC,
                             uns32 global_hist, uns8 prefetcher_id);
 
 void pref_update(void);
+// pref_update() has nothing to send while the request queues are empty, and
+// pref_skip_idle_cycles() does the rest of it for the L1 cycles up to
+// cycle_count
+Flag pref_queues_empty(void);
+void pref_skip_idle_cycles(Counter cycles);
 
 // returns true if req hits in the req queue. It also invalidates the request in
 // the pref queue.
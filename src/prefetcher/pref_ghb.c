@@ -124,6 +124,36 @@ void init_ghb_core(HWP* hwp,Pref_GHB* ghb_hwp_core) {
   }
 }
 
+/* Warm state images: the index table, history buffer and throttled degree of
+   each core */
+static void pref_ghb_core_state_io(Pref_GHB* ghb_hwp_core, FILE* file,
+                                   Flag write) {
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Pref_GHB* ghb_hwp = &ghb_hwp_core[proc_id];
+    pref_state_array(ghb_hwp->index_table,
+                     sizeof(GHB_Index_Table_Entry) * PREF_GHB_INDEX_N, file,
+                     write);
+    pref_state_array(ghb_hwp->ghb_buffer, sizeof(GHB_Entry) * PREF_GHB_BUFFER_N,
+                     file, write);
+    pref_state_array(&ghb_hwp->ghb_tail, sizeof(ghb_hwp->ghb_tail), file,
+                     write);
+    pref_state_array(&ghb_hwp->ghb_head, sizeof(ghb_hwp->ghb_head), file,
+                     write);
+    pref_state_array(ghb_hwp->delta_buffer, sizeof(int) * ghb_hwp->deltab_size,
+                     file, write);
+    pref_state_array(&ghb_hwp->pref_degree, sizeof(ghb_hwp->pref_degree), file,
+                     write);
+  }
+}
+
+void pref_ghb_state_io(FILE* file, Flag write) {
+  if(PREF_UMLC_ON)
+    pref_ghb_core_state_io(ghb_prefetchers_array.ghb_hwp_core_umlc, file,
+                           write);
+  if(PREF_UL1_ON)
+    pref_ghb_core_state_io(ghb_prefetchers_array.ghb_hwp_core_ul1, file, write);
+}
+
 
 void pref_ghb_ul1_prefhit(uns8 proc_id, Addr lineAddr, Addr loadPC,
                           uns32 global_hist) {
@@ -74,6 +74,7 @@ typedef struct{
 /*************************************************************/
 /* HWP Interface */
 void pref_ghb_init(HWP* hwp);
+void pref_ghb_state_io(FILE* file, Flag write);
 
 void pref_ghb_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
                        uns32 global_hist);
@@ -107,6 +107,30 @@ void init_markov(HWP* hwp, Pref_Markov* markov_hwp_core, Addr* last_miss_addr_co
   }
 }
 
+/* Warm state images: the markov table and the last miss of each core */
+static void pref_markov_core_state_io(Pref_Markov* markov_hwp_core,
+                                      Addr* last_miss_addr_core, FILE* file,
+                                      Flag write) {
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    for(uns ii = 0; ii < PREF_MARKOV_NUM_ENTRIES; ii++)
+      pref_state_array(markov_hwp_core[proc_id].markov_table[ii],
+                       sizeof(Markov_Table_Entry) * PREF_MARKOV_NUM_NEXT_STATES,
+                       file, write);
+  }
+  pref_state_array(last_miss_addr_core, sizeof(Addr) * NUM_CORES, file, write);
+}
+
+void pref_markov_state_io(FILE* file, Flag write) {
+  if(PREF_UMLC_ON)
+    pref_markov_core_state_io(markov_prefetchers_array.markov_hwp_core_umlc,
+                              markov_prefetchers_array.last_miss_addr_core_umlc,
+                              file, write);
+  if(PREF_UL1_ON)
+    pref_markov_core_state_io(markov_prefetchers_array.markov_hwp_core_ul1,
+                              markov_prefetchers_array.last_miss_addr_core_ul1,
+                              file, write);
+}
+
 void pref_markov_ul1_prefhit(uns8 proc_id, Addr lineAddr, Addr load_PC,
                              uns32 global_hist) {
 
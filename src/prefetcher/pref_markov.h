@@ -52,6 +52,7 @@ typedef struct{
 /*************************************************************/
 /* HWP Interface */
 void pref_markov_init(HWP* hwp);
+void pref_markov_state_io(FILE* file, Flag write);
 void pref_markov_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
                           uns32 global_hist);
 void pref_markov_ul1_prefhit(uns8 proc_id, Addr lineAddr, Addr loadPC,
@@ -99,6 +99,37 @@ void pref_phase_init(HWP* hwp) {
           PREF_PHASE_REGIONENTRIES, MAX_PREF_PHASE_REGIONENTRIES);
 }
 
+/* Warm state images: the phase table and the pattern of the current
+   interval */
+void pref_phase_state_io(FILE* file, Flag write) {
+  for(uns ii = 0; ii < PREF_PHASE_TABLE_SIZE; ii++) {
+    PhaseInfoEntry* entry = &phase_hwp->phase_table[ii];
+    pref_state_array(entry->MemAccess, sizeof(Flag) * PREF_PHASE_INFOSIZE, file,
+                     write);
+    pref_state_array(entry->mapped_regions,
+                     sizeof(Phase_Region) * PREF_PHASE_TRACKEDREGIONS, file,
+                     write);
+    pref_state_array(&entry->last_access, sizeof(entry->last_access), file,
+                     write);
+    pref_state_array(&entry->valid, sizeof(entry->valid), file, write);
+  }
+  pref_state_array(phase_hwp->MemAccess, sizeof(Flag) * PREF_PHASE_INFOSIZE,
+                   file, write);
+  pref_state_array(phase_hwp->mapped_regions,
+                   sizeof(Phase_Region) * PREF_PHASE_TRACKEDREGIONS, file,
+                   write);
+  pref_state_array(&phase_hwp->interval_start,
+                   sizeof(phase_hwp->interval_start), file, write);
+  pref_state_array(&phase_hwp->curr_phaseid, sizeof(phase_hwp->curr_phaseid),
+                   file, write);
+  pref_state_array(&phase_hwp->currsent_regid,
+                   sizeof(phase_hwp->currsent_regid), file, write);
+  pref_state_array(&phase_hwp->currsent_regid_offset,
+                   sizeof(phase_hwp->currsent_regid_offset), file, write);
+  pref_state_array(&phase_hwp->num_misses, sizeof(phase_hwp->num_misses), file,
+                   write);
+}
+
 void pref_phase_ul1_hit(uns8 proc_id, Addr lineAddr, Addr loadPC,
                         uns32 global_hist) {
   // Do nothing on a ul1 hit
@@ -87,6 +87,7 @@ typedef struct Pref_PHASE_Struct {
 /*************************************************************/
 /* HWP Interface */
 void pref_phase_init(HWP* hwp);
+void pref_phase_state_io(FILE* file, Flag write);
 void pref_phase_ul1_train(Addr lineAddr, Addr loadPC, Flag pref_hit);
 void pref_phase_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
                          uns32 global_hist);
@@ -60,7 +60,7 @@
 /**************************************************************************************/
 /* Global Variables */
 
-extern Dcache_Stage* dc;
+extern __thread Dcache_Stage* dc;
 
 /***************************************************************************************/
 /* Local Prototypes */
@@ -169,6 +169,39 @@ void init_stream_core(HWP* hwp,Pref_Stream* pref_stream_core) {
 
 }
 
+/* Warm state images: the throttled train length, distance and degree of each
+   core, and the stream buffers and train filter, which all cores share unless
+   PREF_STREAM_PER_CORE_ENABLE */
+static void pref_stream_core_state_io(Pref_Stream* pref_stream_core,
+                                      FILE* file, Flag write) {
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Pref_Stream* pref_stream = &pref_stream_core[proc_id];
+    pref_state_array(&pref_stream->train_num, sizeof(pref_stream->train_num),
+                     file, write);
+    pref_state_array(&pref_stream->distance, sizeof(pref_stream->distance),
+                     file, write);
+    pref_state_array(&pref_stream->num_tosend, sizeof(pref_stream->num_tosend),
+                     file, write);
+    if(!PREF_STREAM_PER_CORE_ENABLE && proc_id > 0)
+      continue;
+    pref_state_array(pref_stream->stream,
+                     sizeof(Stream_Buffer) * STREAM_BUFFER_N, file, write);
+    pref_state_array(pref_stream->train_filter,
+                     sizeof(Addr) * TRAIN_FILTER_SIZE, file, write);
+    pref_state_array(pref_stream->train_filter_no,
+                     sizeof(*pref_stream->train_filter_no), file, write);
+  }
+}
+
+void pref_stream_state_io(FILE* file, Flag write) {
+  if(PREF_UMLC_ON)
+    pref_stream_core_state_io(stream_prefetchers_array.pref_stream_core_umlc,
+                              file, write);
+  if(PREF_UL1_ON)
+    pref_stream_core_state_io(stream_prefetchers_array.pref_stream_core_ul1,
+                              file, write);
+}
+
 void pref_stream_train(Pref_Stream* pref_stream, uns8 proc_id, Addr line_addr, Addr load_PC,
                        uns32 global_hist, Flag create, Flag is_mlc) /* line_addr: the first
                                                           address of the cache
@@ -89,6 +89,7 @@ typedef struct{
 } stream_prefetchers;
 
 void pref_stream_init(HWP* hwp);
+void pref_stream_state_io(FILE* file, Flag write);
 
 void pref_stream_per_core_done(uns proc_id);
 /*************************************************************/
@@ -94,6 +94,26 @@ void init_stride(HWP* hwp, Pref_Stride* stride_hwp){
   stride_hwp->index_table = (Stride_Index_Table_Entry*)calloc(
     PREF_STRIDE_TABLE_N, sizeof(Stride_Index_Table_Entry));
 }
+
+/* Warm state images: the region and index tables */
+static void pref_stride_table_state_io(Pref_Stride* stride_hwp, FILE* file,
+                                       Flag write) {
+  pref_state_array(stride_hwp->region_table,
+                   sizeof(Stride_Region_Table_Entry) * PREF_STRIDE_TABLE_N,
+                   file, write);
+  pref_state_array(stride_hwp->index_table,
+                   sizeof(Stride_Index_Table_Entry) * PREF_STRIDE_TABLE_N, file,
+                   write);
+}
+
+void pref_stride_state_io(FILE* file, Flag write) {
+  if(PREF_UMLC_ON)
+    pref_stride_table_state_io(stride_prefetche_array.stride_hwp_umlc, file,
+                               write);
+  if(PREF_UL1_ON)
+    pref_stride_table_state_io(stride_prefetche_array.stride_hwp_ul1, file,
+                               write);
+}
 void pref_stride_ul1_hit(uns8 proc_id, Addr lineAddr, Addr loadPC,
                          uns32 global_hist) {
   pref_stride_train(stride_prefetche_array.stride_hwp_ul1, lineAddr, loadPC, TRUE);
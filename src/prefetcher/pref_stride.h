@@ -79,6 +79,7 @@ typedef struct{
 /*************************************************************/
 /* HWP Interface */
 void pref_stride_init(HWP* hwp);
+void pref_stride_state_io(FILE* file, Flag write);
 
 void pref_stride_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
                           uns32 global_hist);
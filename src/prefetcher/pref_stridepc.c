@@ -95,6 +95,24 @@ void init_stridepc(HWP* hwp, Pref_StridePC* stridepc_hwp_core) {
   }
 }
 
+/* Warm state images: the stride table of each core */
+static void pref_stridepc_core_state_io(Pref_StridePC* stridepc_hwp_core,
+                                        FILE* file, Flag write) {
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    pref_state_array(stridepc_hwp_core[proc_id].stride_table,
+                     sizeof(StridePC_Table_Entry) * PREF_STRIDEPC_TABLE_N, file,
+                     write);
+}
+
+void pref_stridepc_state_io(FILE* file, Flag write) {
+  if(PREF_UMLC_ON)
+    pref_stridepc_core_state_io(stridepc_prefetche_array.stridepc_hwp_core_umlc,
+                                file, write);
+  if(PREF_UL1_ON)
+    pref_stridepc_core_state_io(stridepc_prefetche_array.stridepc_hwp_core_ul1,
+                                file, write);
+}
+
 void pref_stridepc_ul1_hit(uns8 proc_id, Addr lineAddr, Addr loadPC,
                            uns32 global_hist) {
   pref_stridepc_train(&stridepc_prefetche_array.stridepc_hwp_core_ul1[proc_id], proc_id, lineAddr, loadPC, TRUE);
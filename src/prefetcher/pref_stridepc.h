@@ -59,6 +59,7 @@ typedef struct{
 /*************************************************************/
 /* HWP Interface */
 void pref_stridepc_init(HWP* hwp);
+void pref_stridepc_state_io(FILE* file, Flag write);
 
 void pref_stridepc_ul1_miss(uns8 proc_id, Addr lineAddr, Addr loadPC,
                             uns32 global_hist);
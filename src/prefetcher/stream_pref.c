@@ -59,7 +59,7 @@
 /**************************************************************************************/
 /* Global Variables */
 
-extern Dcache_Stage* dc;
+extern __thread Dcache_Stage* dc;
 
 /***************************************************************************************/
 /* Local Prototypes */
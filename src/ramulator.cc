@@ -27,8 +27,6 @@
  ***************************************************************************************/
 
 #include <deque>
-#include <list>
-#include <map>
 #include <utility>
 
 
@@ -39,6 +37,7 @@
 extern "C" {
 #include "general.param.h"
 #include "globals/assert.h"
+#include "libs/hash_lib.h"
 #include "memory/memory.h"
 #include "memory/memory.param.h"
 #include "ramulator.h"
@@ -51,6 +50,18 @@ extern "C" {
 
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_MEMORY, ##args)
 
+// An instruction and a data fetch can wait on the same line
+#define RAMULATOR_MAX_SAME_ADDR_READS 2
+
+/**************************************************************************************/
+/* Types */
+
+// The Scarab requests waiting on one read that was sent to Ramulator
+typedef struct Inflight_Read_struct {
+  Mem_Req* reqs[RAMULATOR_MAX_SAME_ADDR_READS];
+  uns      num_reqs;
+} Inflight_Read;
+
 /**************************************************************************************/
 
 
@@ -62,15 +73,20 @@ Config*        configs = NULL;
 void to_ramulator_req(const Mem_Req* scarab_req, Request* ramulator_req);
 void init_configs();
 bool try_completing_request(Mem_Req* req);
-void enqueue_response(Request& req);
+void enqueue_response(Request& req, void* ctx);
 
 void stats_callback(int coreid, int type);
+static void ramulator_catch_up(void);
 
 deque<pair<long, Mem_Req*>> resp_queue;  // completed read request that need to
                                          // send back to Scarab
 
-map<long, list<Mem_Req*>> inflight_read_reqs;
-// map<long, Mem_Req*> inflight_read_reqs;
+Hash_Table inflight_read_reqs;  // Inflight_Read by physical address
+
+// DRAM ticks that were skipped because the memory was idle, and how many more
+// can be before it has work
+static long ramulator_skipped_ticks = 0;
+static long ramulator_idle_ticks    = 0;
 
 void ramulator_init() {
   ASSERTM(0, ICACHE_LINE_SIZE == DCACHE_LINE_SIZE,
@@ -83,12 +99,16 @@ void ramulator_init() {
   configs = new Config();
   init_configs();
 
+  init_hash_table(&inflight_read_reqs, "Ramulator inflight reads",
+                  RAMULATOR_READQ_ENTRIES, sizeof(Inflight_Read));
+
   wrapper = new ScarabWrapper(*configs, DCACHE_LINE_SIZE, &stats_callback);
 
   DPRINTF("Initialized Ramulator. \n");
 }
 
 void ramulator_finish() {
+  ramulator_catch_up();
   wrapper->finish();
 
   delete wrapper;
@@ -143,6 +163,7 @@ void init_configs() {
   configs->add("scheduling_policy", RAMULATOR_SCHEDULING_POLICY);
   configs->add("readq_entries", to_string(RAMULATOR_READQ_ENTRIES));
   configs->add("writeq_entries", to_string(RAMULATOR_WRITEQ_ENTRIES));
+  configs->add("tick_threads", to_string(RAMULATOR_TICK_THREADS));
   configs->add("output_dir", OUTPUT_DIR);
 
   // TODO: make these optional and use the preset values specified by
@@ -177,35 +198,40 @@ int ramulator_send(Mem_Req* scarab_req) {
   // Mem_Req_Type_str(scarab_req->type), scarab_req->addr);
 
   // does inflight_read_reqs have the proc_id in the req?
-  auto it_scarab_req = inflight_read_reqs.find(req.addr);
-  if(it_scarab_req != inflight_read_reqs.end() &&
-     req.type == Request::Type::READ) {
+  Inflight_Read* inflight = (Inflight_Read*)hash_table_access(
+    &inflight_read_reqs, req.addr);
+  if(inflight && req.type == Request::Type::READ) {
     DEBUG(scarab_req->proc_id,
           "Ramulator: Duplicate (%s) request to address %llx\n",
           Mem_Req_Type_str(scarab_req->type), scarab_req->addr);
     // Can have duplicate Ifetch and Dfetch requests, but only one of each
-    ASSERT(0, it_scarab_req->second.size() <= 1);
+    ASSERT(0, inflight->num_reqs < RAMULATOR_MAX_SAME_ADDR_READS);
 
-    if(req.type == Request::Type::READ)
-      inflight_read_reqs[req.addr].push_back(
-        scarab_req);  // save it as an inflight request so later it will be
-                      // moved to the resp_queue at the same time with the older
-                      // request
+    inflight->reqs[inflight->num_reqs++] =
+      scarab_req;  // save it as an inflight request so later it will be
+                   // moved to the resp_queue at the same time with the older
+                   // request
     scarab_req->mem_queue_cycle = cycle_count;
     return true;  // a request to the same address is already issued
   }
 
+  // the request arrives at the current DRAM cycle and ends the idle period
+  ramulator_catch_up();
+  ramulator_idle_ticks = 0;
   bool is_sent = wrapper->send(req);
 
   if(is_sent) {
     STAT_EVENT(scarab_req->proc_id, POWER_MEMORY_CTRL_ACCESS);
 
     if(req.type == Request::Type::READ) {
-      ASSERTM(0, inflight_read_reqs.find(req.addr) == inflight_read_reqs.end(),
+      Flag new_entry;
+      inflight = (Inflight_Read*)hash_table_access_create(&inflight_read_reqs,
+                                                          req.addr, &new_entry);
+      ASSERTM(0, new_entry,
               "ERROR: A read request to the same address shouldn't be sent "
               "multiple times to Ramulator\n");
-      // inflight_read_reqs[req.addr] = scarab_req;
-      inflight_read_reqs[req.addr].push_back(scarab_req);
+      inflight->reqs[0]  = scarab_req;
+      inflight->num_reqs = 1;
       STAT_EVENT(scarab_req->proc_id, POWER_MEMORY_CTRL_READ);
     } else if(req.type == Request::Type::WRITE) {
       STAT_EVENT(scarab_req->proc_id, POWER_MEMORY_CTRL_WRITE);
@@ -224,21 +250,20 @@ int ramulator_send(Mem_Req* scarab_req) {
   return (int)is_sent;
 }
 
-void enqueue_response(Request& req) {
+void enqueue_response(Request& req, void* ctx) {
   // This should only be called by READ requests
   ASSERTM(0, req.type == Request::Type::READ,
           "ERROR: Responses should be sent only for read requests! \n");
-  ASSERTM(0, inflight_read_reqs.find(req.addr) != inflight_read_reqs.end(),
+  Inflight_Read* inflight = (Inflight_Read*)hash_table_access(
+    &inflight_read_reqs, req.addr);
+  ASSERTM(0, inflight,
           "ERROR: A corresponding Scarab request was not found for the "
           "Ramulator request that read address: %lu\n",
           req.addr);
 
-  auto it_scarab_req = inflight_read_reqs.find(req.addr);
-  for(auto req : it_scarab_req->second)
-    resp_queue.push_back(make_pair(it_scarab_req->first, req));
-  // resp_queue.push_back(make_pair(it_scarab_req->first,
-  // it_scarab_req->second));
-  inflight_read_reqs.erase(it_scarab_req);
+  for(uns ii = 0; ii < inflight->num_reqs; ii++)
+    resp_queue.push_back(make_pair(req.addr, inflight->reqs[ii]));
+  hash_table_access_delete(&inflight_read_reqs, req.addr);
 }
 
 bool try_completing_request(Mem_Req* req) {
@@ -292,10 +317,39 @@ void to_ramulator_req(const Mem_Req* scarab_req, Request* ramulator_req) {
   ramulator_req->addr   = scarab_req->phys_addr;
   ramulator_req->coreid = scarab_req->proc_id;
 
-  ramulator_req->callback = enqueue_response;
+  ramulator_req->callback     = enqueue_response;
+  ramulator_req->callback_ctx = NULL;
+}
+
+// Brings the DRAM clock up to date with the skipped ticks
+static void ramulator_catch_up(void) {
+  if(ramulator_skipped_ticks) {
+    wrapper->skip(ramulator_skipped_ticks);
+    ramulator_skipped_ticks = 0;
+  }
+}
+
+long ramulator_idle_tick_count() {
+  if(!RAMULATOR_SKIP_IDLE || !resp_queue.empty())
+    return 0;
+  if(ramulator_idle_ticks == 0 && ramulator_skipped_ticks == 0)
+    ramulator_idle_ticks = wrapper->idle_cycles();
+  return ramulator_idle_ticks;
+}
+
+void ramulator_skip_ticks(long ticks) {
+  ASSERT(0, ticks <= ramulator_idle_tick_count());
+  ramulator_idle_ticks -= ticks;
+  ramulator_skipped_ticks += ticks;
 }
 
 void ramulator_tick() {
+  if(ramulator_idle_tick_count() > 0) {
+    ramulator_skip_ticks(1);
+    return;
+  }
+
+  ramulator_catch_up();
   wrapper->tick();
 
   if(resp_queue.size() > 0) {
@@ -327,11 +381,13 @@ Mem_Req* ramulator_search_queue(long phys_addr, Mem_Req_Type type) {
       (type == MRT_DPRF) || (type == MRT_DSTORE) || (type == MRT_MIN_PRIORITY) ||
       (type == MRT_FDIPPRFON) || (type == MRT_FDIPPRFOFF) || (type == MRT_UOCPRF),
     "Ramulator: Cannot search write requests in Ramulator request queue\n");
-  auto it_req = inflight_read_reqs.find(phys_addr);
+  Inflight_Read* inflight = (Inflight_Read*)hash_table_access(
+    &inflight_read_reqs, phys_addr);
 
   // Search request queue
-  if(it_req != inflight_read_reqs.end()) {
-    for(auto req : it_req->second) {
+  if(inflight) {
+    for(uns ii = 0; ii < inflight->num_reqs; ii++) {
+      Mem_Req* req = inflight->reqs[ii];
       if((req->type == MRT_IFETCH || req->type == MRT_IPRF || req->type == MRT_FDIPPRFON || req->type == MRT_FDIPPRFOFF || req->type == MRT_UOCPRF) &&
          (type == MRT_IFETCH || type == MRT_IPRF || type == MRT_FDIPPRFON || type == MRT_FDIPPRFOFF || type == MRT_UOCPRF))
         return req;
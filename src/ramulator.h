@@ -43,6 +43,10 @@ EXTERNC void ramulator_finish();
 
 EXTERNC int  ramulator_send(Mem_Req* scarab_req);
 EXTERNC void ramulator_tick();
+// The next ticks in which ramulator_tick() has nothing to do, and skipping
+// them as if it had been called for each
+EXTERNC long ramulator_idle_tick_count();
+EXTERNC void ramulator_skip_ticks(long ticks);
 
 EXTERNC int ramulator_get_chip_width();
 EXTERNC int ramulator_get_chip_size();
@@ -425,7 +425,7 @@ void CacheSystem::tick() {
   it = hit_list.begin();
   while (it != hit_list.end()) {
     if (clk >= it->first) {
-      it->second.callback(it->second);
+      it->second.complete();
 
       debug("finish hit: addr %lx", (it->second).addr);
 
@@ -0,0 +1,109 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef __CHANNEL_WORKERS_H
+#define __CHANNEL_WORKERS_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace ramulator
+{
+
+// Ticks the controllers of a memory on a pool of threads. Controllers of
+// different channels share no state while ticking, and defer their callbacks
+// (see Controller::defer_callbacks), so which thread ticks which controller
+// does not change the results. Thread i ticks every num_threads-th controller
+// from controller i, and the thread calling tick() is thread 0. The workers
+// spin between ticks, then yield, as DRAM ticks come in quick succession.
+template <typename Ctrl>
+class ChannelWorkers
+{
+public:
+    ChannelWorkers(const vector<Ctrl*>& ctrls, int num_threads)
+        : ctrls(ctrls), num_threads(num_threads)
+    {
+        for (auto ctrl : ctrls)
+            ctrl->defer_callbacks = true;
+        for (int id = 1; id < num_threads; id++)
+            threads.emplace_back(&ChannelWorkers::work, this, id);
+    }
+
+    ~ChannelWorkers()
+    {
+        stop.store(true, memory_order_relaxed);
+        generation.fetch_add(1, memory_order_release);
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    void tick()
+    {
+        remaining.store(num_threads - 1, memory_order_relaxed);
+        generation.fetch_add(1, memory_order_release);
+        tick_share(0);
+        for (unsigned spins = 0; remaining.load(memory_order_acquire); spins++)
+            wait(spins);
+    }
+
+private:
+    static const unsigned SPINS = 4096;  // polls before yielding the cpu
+
+    void work(int id)
+    {
+        long seen = 0;
+        while (true) {
+            for (unsigned spins = 0; generation.load(memory_order_acquire) == seen; spins++)
+                wait(spins);
+            seen++;
+            if (stop.load(memory_order_relaxed))
+                return;
+            tick_share(id);
+            remaining.fetch_sub(1, memory_order_release);
+        }
+    }
+
+    void tick_share(int id)
+    {
+        for (size_t i = id; i < ctrls.size(); i += num_threads)
+            ctrls[i]->tick();
+    }
+
+    static void wait(unsigned spins)
+    {
+        if (spins >= SPINS)
+            this_thread::yield();
+    }
+
+    const vector<Ctrl*>& ctrls;
+    int num_threads;
+    vector<thread> threads;
+    atomic<long> generation{0};
+    atomic<int> remaining{0};
+    atomic<bool> stop{false};
+};
+
+} /*namespace ramulator*/
+
+#endif /*__CHANNEL_WORKERS_H*/
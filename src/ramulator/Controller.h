@@ -28,6 +28,7 @@
 #include <fstream>
 #include <list>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "Config.h"
@@ -96,10 +97,14 @@ public:
     RowTable<T>* rowtable;  // tracks metadata about rows (e.g., which are open and for how long)
     Refresh<T>* refresh;
 
+    RequestPool pool;  // holds the requests of all the queues below
+
     struct Queue {
-        list<Request> q;
+        RequestList q;
+        RequestIndex index;
         unsigned int max = 32;
         unsigned int size() {return q.size();}
+        void index_banks(int num_banks) {index.resize(num_banks); q.set_index(&index);}
     };
 
     Queue readq;  // queue for read requests
@@ -111,7 +116,8 @@ public:
                    // after ACTIVATE w/o READ of WRITE command)
     Queue otherq;  // queue for all "other" requests (e.g., refresh)
 
-    deque<Request> pending;  // read requests that are about to receive data from DRAM
+    RequestList pending;  // read requests that are about to receive data from DRAM
+    long cmd_epoch = 0;  // number of commands issued, for what the scheduler caches
     bool write_mode = false;  // whether write requests should be prioritized over reads
     float wr_high_watermark = 0.8f; // threshold for switching to write mode
     float wr_low_watermark = 0.2f; // threshold for switching back to read mode
@@ -127,6 +133,12 @@ public:
     // callback function for passing stats to Scarab when an event occurs
     void (*stats_callback)(int, int) = nullptr;
 
+    // When ticked off the simulation thread (see ChannelWorkers), the request
+    // and stats callbacks are kept until run_callbacks()
+    bool defer_callbacks = false;
+    vector<Request> completed;
+    vector<pair<int, int>> stat_events;
+
 
     /* Constructor */
     Controller(const Config& configs, DRAM<T>* channel, void (*_stats_callback)(int,int)) :
@@ -140,6 +152,12 @@ public:
 
         stats_callback = _stats_callback;
 
+        readq.q.set_pool(&pool);
+        writeq.q.set_pool(&pool);
+        actq.q.set_pool(&pool);
+        otherq.q.set_pool(&pool);
+        pending.set_pool(&pool);
+
         record_cmd_trace = configs.record_cmd_trace();
         print_cmd_trace = configs.print_cmd_trace();
         if (record_cmd_trace){
@@ -155,6 +173,17 @@ public:
         readq.max = (unsigned int) configs.get_int("readq_entries");
         writeq.max = (unsigned int) configs.get_int("writeq_entries");
 
+        // The scheduler finds the reads and writes to consider by bank. This
+        // needs the banks to hold the rows and all requests of a queue to be of
+        // one type, which subarrays and TL-DRAM's migrations break.
+        if (int(T::Level::Row) == int(T::Level::Bank) + 1 && !is_same<T, TLDRAM>::value) {
+            num_banks = 1;
+            for (int l = int(T::Level::Channel) + 1; l <= int(T::Level::Bank); l++)
+                num_banks *= channel->spec->org_entry.count[l];
+            readq.index_banks(num_banks);
+            writeq.index_banks(num_banks);
+        }
+
         // regStats
 
         row_hits
@@ -349,15 +378,19 @@ public:
             return false;
 
         req.arrive = clk;
-        queue.q.push_back(req);
         // shortcut for read requests, if a write to same addr exists
         // necessary for coherence
         if (req.type == Request::Type::READ && find_if(writeq.q.begin(), writeq.q.end(),
-                [req](Request& wreq){ return req.addr == wreq.addr;}) != writeq.q.end()){
+                [&req](Request& wreq){ return req.addr == wreq.addr;}) != writeq.q.end()){
             req.depart = clk + 1;
             pending.push_back(req);
-            readq.q.pop_back();
+            return true;
+        }
+        if (queue.q.get_index()) {
+            req.bank = get_bank(req.addr_vec);
+            req.row_hit = is_row_hit(channel->spec->translate[int(req.type)], req.addr_vec);
         }
+        queue.q.push_back(req);
         return true;
     }
 
@@ -370,14 +403,14 @@ public:
 
         /*** 1. Serve completed reads ***/
         if (pending.size()) {
-            Request& req = pending[0];
+            Request& req = pending.front();
             if (req.depart <= clk) {
                 if (req.depart - req.arrive > 1) { // this request really accessed a row
                   read_latency_sum += req.depart - req.arrive;
                   channel->update_serving_requests(
                       req.addr_vec.data(), -1, clk);
                 }
-                req.callback(req);
+                complete(req);
                 pending.pop_front();
             }
         }
@@ -419,7 +452,7 @@ public:
         if (req == queue->q.end() || !is_ready(req)) {
             // we couldn't find a command to schedule -- let's try to be speculative
             auto cmd = T::Command::PRE;
-            vector<int> victim = rowpolicy->get_victim(cmd);
+            AddrVec victim = rowpolicy->get_victim(cmd);
             if (!victim.empty()){
                 issue_cmd(cmd, victim, 0);
             }
@@ -469,8 +502,7 @@ public:
         if (!(channel->spec->is_accessing(cmd) || channel->spec->is_refreshing(cmd))) {
             if(channel->spec->is_opening(cmd)) {
                 // promote the request that caused issuing activation to actq
-                actq.q.push_back(*req);
-                queue->q.erase(req);
+                actq.q.splice_back(queue->q, req);
             }
 
             return;
@@ -479,7 +511,8 @@ public:
         // set a future completion time for read requests
         if (req->type == Request::Type::READ) {
             req->depart = clk + channel->spec->read_latency;
-            pending.push_back(*req);
+            pending.splice_back(queue->q, req);
+            return;
         }
 
         if (req->type == Request::Type::WRITE) {
@@ -490,37 +523,76 @@ public:
         queue->q.erase(req);
     }
 
-    bool is_ready(list<Request>::iterator req)
+    // The tick at which the controller next has something to do if no request
+    // is sent to it before then: the first read to complete, the first command
+    // to become ready or the next refresh. Until then a tick only adds to the
+    // queue length stats.
+    long next_event()
+    {
+        // writes and other requests may flip the write mode or are rare
+        if (writeq.size() || otherq.size() || write_mode)
+            return clk + 1;
+        // rows left open may be closed speculatively
+        if (rowpolicy->type != RowPolicy<T>::Type::Opened && !rowtable->table.empty())
+            return clk + 1;
+        long event = refresh->next_refresh();
+        if (pending.size())
+            event = min(event, pending.front().depart);
+        for (auto req = actq.q.begin(); req != actq.q.end(); ++req)
+            event = min(event, get_ready_at(req));
+        for (auto req = readq.q.begin(); req != readq.q.end(); ++req)
+            event = min(event, get_ready_at(req));
+        return max(event, clk + 1);
+    }
+
+    // Same as ticking the controller cycles times, all before next_event()
+    void skip(long cycles)
+    {
+        assert(clk + cycles < next_event());
+        clk += cycles;
+        req_queue_length_sum += (readq.size() + pending.size()) * cycles;
+        read_req_queue_length_sum += (readq.size() + pending.size()) * cycles;
+        refresh->skip(cycles);
+    }
+
+    bool is_ready(RequestList::iterator req)
     {
         typename T::Command cmd = get_first_cmd(req);
         return channel->check(cmd, req->addr_vec.data(), clk);
     }
 
-    bool is_ready(typename T::Command cmd, const vector<int>& addr_vec)
+    bool is_ready(typename T::Command cmd, const AddrVec& addr_vec)
     {
         return channel->check(cmd, addr_vec.data(), clk);
     }
 
-    bool is_row_hit(list<Request>::iterator req)
+    // The tick from which is_ready(req) holds, until the next command is issued
+    long get_ready_at(RequestList::iterator req)
+    {
+        typename T::Command cmd = get_first_cmd(req);
+        return channel->get_next(cmd, get_addr_vec(cmd, req).data());
+    }
+
+    bool is_row_hit(RequestList::iterator req)
     {
         // cmd must be decided by the request type, not the first cmd
         typename T::Command cmd = channel->spec->translate[int(req->type)];
         return channel->check_row_hit(cmd, req->addr_vec.data());
     }
 
-    bool is_row_hit(typename T::Command cmd, const vector<int>& addr_vec)
+    bool is_row_hit(typename T::Command cmd, const AddrVec& addr_vec)
     {
         return channel->check_row_hit(cmd, addr_vec.data());
     }
 
-    bool is_row_open(list<Request>::iterator req)
+    bool is_row_open(RequestList::iterator req)
     {
         // cmd must be decided by the request type, not the first cmd
         typename T::Command cmd = channel->spec->translate[int(req->type)];
         return channel->check_row_open(cmd, req->addr_vec.data());
     }
 
-    bool is_row_open(typename T::Command cmd, const vector<int>& addr_vec)
+    bool is_row_open(typename T::Command cmd, const AddrVec& addr_vec)
     {
         return channel->check_row_open(cmd, addr_vec.data());
     }
@@ -529,6 +601,18 @@ public:
     {
     }
 
+    // Makes the callbacks deferred by the last tick, in the order it would
+    // have made them
+    void run_callbacks()
+    {
+        for (auto& req : completed)
+            req.complete();
+        completed.clear();
+        for (auto& event : stat_events)
+            stats_callback(event.first, event.second);
+        stat_events.clear();
+    }
+
     // For telling whether this channel is busying in processing read or write
     bool is_active() {
       return (channel->cur_serving_requests > 0);
@@ -559,7 +643,50 @@ public:
     }
 
 private:
-    typename T::Command get_first_cmd(list<Request>::iterator req)
+    int num_banks = 0;  // indexed in readq and writeq, if not 0
+
+    void complete(Request& req)
+    {
+        if (defer_callbacks)
+            completed.push_back(req);
+        else
+            req.complete();
+    }
+
+    void stat_event(int coreid, int type)
+    {
+        if (defer_callbacks)
+            stat_events.emplace_back(coreid, type);
+        else
+            stats_callback(coreid, type);
+    }
+
+    int get_bank(const AddrVec& addr_vec)
+    {
+        int bank = 0;
+        for (int l = int(T::Level::Channel) + 1; l <= int(T::Level::Bank); l++)
+            bank = bank * channel->spec->org_entry.count[l] + addr_vec[l];
+        return bank;
+    }
+
+    // Re-evaluates the row hits of the queued requests in the banks whose rows
+    // the command opened or closed
+    void update_row_hits(typename T::Command cmd, const AddrVec& addr_vec)
+    {
+        int scope = min(int(channel->spec->scope[int(cmd)]), int(T::Level::Bank));
+        for (Queue* queue : {&readq, &writeq}) {
+            for (int bank : queue->index.get_active()) {
+                const AddrVec& bank_addr_vec = queue->index.get_bank(bank).head->addr_vec;
+                if (!equal(addr_vec.begin(), addr_vec.begin() + scope + 1, bank_addr_vec.begin()))
+                    continue;
+                queue->index.set_row_hits(bank, [this] (const Request& req) {
+                    return is_row_hit(channel->spec->translate[int(req.type)], req.addr_vec);
+                });
+            }
+        }
+    }
+
+    typename T::Command get_first_cmd(RequestList::iterator req)
     {
         typename T::Command cmd = channel->spec->translate[int(req->type)];
         return channel->decode(cmd, req->addr_vec.data());
@@ -567,7 +694,7 @@ private:
 
     // upgrade to an autoprecharge command
     void cmd_issue_autoprecharge(typename T::Command& cmd,
-                                            const vector<int>& addr_vec) {
+                                            const AddrVec& addr_vec) {
 
         // currently, autoprecharge is only used with closed row policy
         if(channel->spec->is_accessing(cmd) && rowpolicy->type == RowPolicy<T>::Type::ClosedAP) {
@@ -575,15 +702,13 @@ private:
             Queue* queue = write_mode ? &writeq : &readq;
 
             auto begin = addr_vec.begin();
-            vector<int> rowgroup(begin, begin + int(T::Level::Row) + 1);
+            auto end = begin + int(T::Level::Row) + 1;  // the row
 
 			int num_row_hits = 0;
 
             for (auto itr = queue->q.begin(); itr != queue->q.end(); ++itr) {
                 if (is_row_hit(itr)) { 
-                    auto begin2 = itr->addr_vec.begin();
-                    vector<int> rowgroup2(begin2, begin2 + int(T::Level::Row) + 1);
-                    if(rowgroup == rowgroup2)
+                    if(equal(begin, end, itr->addr_vec.begin()))
                         num_row_hits++;
                 }
             }
@@ -592,9 +717,7 @@ private:
                 Queue* queue = &actq;
                 for (auto itr = queue->q.begin(); itr != queue->q.end(); ++itr) {
                     if (is_row_hit(itr)) {
-                        auto begin2 = itr->addr_vec.begin();
-                        vector<int> rowgroup2(begin2, begin2 + int(T::Level::Row) + 1);
-                        if(rowgroup == rowgroup2)
+                        if(equal(begin, end, itr->addr_vec.begin()))
                             num_row_hits++;
                     }
                 }
@@ -615,23 +738,23 @@ private:
 
     }
 
-    void issue_cmd(typename T::Command cmd, const vector<int>& addr_vec, int coreid)
+    void issue_cmd(typename T::Command cmd, const AddrVec& addr_vec, int coreid)
     {
         cmd_issue_autoprecharge(cmd, addr_vec);
         assert(is_ready(cmd, addr_vec));
         channel->update(cmd, addr_vec.data(), clk);
 
         if(channel->spec->is_opening(cmd))
-            stats_callback(coreid, int(StatCallbackType::DRAM_ACT));
+            stat_event(coreid, int(StatCallbackType::DRAM_ACT));
 
         if(channel->spec->is_closing(cmd))
-            stats_callback(coreid, int(StatCallbackType::DRAM_PRE));
+            stat_event(coreid, int(StatCallbackType::DRAM_PRE));
         
         if(channel->spec->is_reading(cmd))
-            stats_callback(coreid, int(StatCallbackType::DRAM_READ));
+            stat_event(coreid, int(StatCallbackType::DRAM_READ));
 
         if(channel->spec->is_writing(cmd))
-            stats_callback(coreid, int(StatCallbackType::DRAM_WRITE));
+            stat_event(coreid, int(StatCallbackType::DRAM_WRITE));
 
 
         if(cmd == T::Command::PRE){
@@ -641,6 +764,9 @@ private:
         }
  
         rowtable->update(cmd, addr_vec, clk);
+        cmd_epoch++;
+        if (num_banks && (channel->spec->is_opening(cmd) || channel->spec->is_closing(cmd)))
+            update_row_hits(cmd, addr_vec);
         if (record_cmd_trace){
             // select rank
             auto& file = cmd_trace_files[addr_vec[1]];
@@ -663,17 +789,17 @@ private:
             printf("\n");
         }
     }
-    vector<int> get_addr_vec(typename T::Command cmd, list<Request>::iterator req){
+    AddrVec get_addr_vec(typename T::Command cmd, RequestList::iterator req){
         return req->addr_vec;
     }
 };
 
 template <>
-vector<int> Controller<SALP>::get_addr_vec(
-    SALP::Command cmd, list<Request>::iterator req);
+AddrVec Controller<SALP>::get_addr_vec(
+    SALP::Command cmd, RequestList::iterator req);
 
 template <>
-bool Controller<SALP>::is_ready(list<Request>::iterator req);
+bool Controller<SALP>::is_ready(RequestList::iterator req);
 
 template <>
 void Controller<ALDRAM>::update_temp(ALDRAM::Temp current_temperature);
@@ -683,7 +809,7 @@ void Controller<TLDRAM>::tick();
 
 template <>
 void Controller<TLDRAM>::cmd_issue_autoprecharge(typename TLDRAM::Command& cmd,
-                                                    const vector<int>& addr_vec);
+                                                    const AddrVec& addr_vec);
 
 } /*namespace ramulator*/
 
@@ -25,6 +25,7 @@
 #include "Config.h"
 #include "DRAM.h"
 #include "Request.h"
+#include "ChannelWorkers.h"
 #include "Controller.h"
 #include "SpeedyController.h"
 #include "Statistics.h"
@@ -40,6 +41,7 @@
 #include <functional>
 #include <cmath>
 #include <cassert>
+#include <thread>
 #include <tuple>
 #include <limits.h>
 
@@ -54,6 +56,9 @@ public:
     virtual ~MemoryBase() {}
     virtual double clk_ns() const = 0;
     virtual void tick() = 0;
+    // Ticks until the memory next has work, which skip() can do in bulk
+    virtual long idle_cycles() = 0;
+    virtual void skip(long cycles) = 0;
     virtual bool send(Request req) = 0;
     virtual int pending_requests() = 0;
     virtual void finish(void) = 0;
@@ -134,6 +139,7 @@ public:
     map<pair<int, long>, long> page_translation;
 
     vector<Controller<T>*> ctrls;
+    ChannelWorkers<Controller<T>>* workers = nullptr;  // ticks ctrls, if more than one thread does
     T * spec;
     vector<int> addr_bits;
 
@@ -144,6 +150,8 @@ public:
           spec(ctrls[0]->channel->spec),
           addr_bits(int(T::Level::MAX))
     {
+        static_assert(int(T::Level::MAX) <= RAMULATOR_MAX_LEVELS,
+                      "RAMULATOR_MAX_LEVELS is too small for this standard");
         // make sure 2^N channels/ranks
         // TODO support channel number that is not powers of 2
         int *sz = spec->org_entry.count;
@@ -181,6 +189,15 @@ public:
 
         use_rest_of_addr_as_row_addr = configs.use_rest_of_addr_as_row_addr();
 
+        // The channels are ticked by tick_threads threads, unless they print
+        // their commands, which would then interleave. Threads waiting for a
+        // core would hold up every tick.
+        int tick_threads = configs.contains("tick_threads") ? configs.get_int("tick_threads") : 1;
+        tick_threads = min(tick_threads, int(ctrls.size()));
+        tick_threads = min(tick_threads, int(max(thread::hardware_concurrency(), 1u)));
+        if (tick_threads > 1 && !configs.print_cmd_trace())
+            workers = new ChannelWorkers<Controller<T>>(this->ctrls, tick_threads);
+
         dram_capacity
             .name("dram_capacity")
             .desc("Number of bytes in simulated DRAM")
@@ -284,6 +301,7 @@ public:
 
     ~Memory()
     {
+        delete workers;
         for (auto ctrl: ctrls)
             delete ctrl;
         delete spec;
@@ -338,15 +356,51 @@ public:
         in_queue_write_req_num_sum += cur_que_writereq_num;
 
         bool is_active = false;
-        for (auto ctrl : ctrls) {
-          is_active = is_active || ctrl->is_active();
-          ctrl->tick();
+        if (workers) {
+          for (auto ctrl : ctrls)
+            is_active = is_active || ctrl->is_active();
+          workers->tick();
+          // in the order of ticking the channels one after the other
+          for (auto ctrl : ctrls)
+            ctrl->run_callbacks();
+        } else {
+          for (auto ctrl : ctrls) {
+            is_active = is_active || ctrl->is_active();
+            ctrl->tick();
+          }
         }
         if (is_active) {
           ramulator_active_cycles++;
         }
     }
 
+    long idle_cycles()
+    {
+        long cycles = LONG_MAX;
+        for (auto ctrl : ctrls)
+            cycles = min(cycles, ctrl->next_event() - ctrl->clk - 1);
+        return cycles;
+    }
+
+    // No command is issued in the skipped cycles, so the requests in flight and
+    // the busy channels stay the same throughout
+    void skip(long cycles)
+    {
+        num_dram_cycles += cycles;
+        int cur_que_readreq_num = 0;
+        bool is_active = false;
+        for (auto ctrl : ctrls) {
+          cur_que_readreq_num += ctrl->readq.size() + ctrl->pending.size();
+          is_active = is_active || ctrl->is_active();
+        }
+        in_queue_req_num_sum += cur_que_readreq_num * cycles;
+        in_queue_read_req_num_sum += cur_que_readreq_num * cycles;
+        if (is_active)
+            ramulator_active_cycles += cycles;
+        for (auto ctrl : ctrls)
+            ctrl->skip(cycles);
+    }
+
     bool send(Request req)
     {
         req.addr_vec.resize(addr_bits.size());
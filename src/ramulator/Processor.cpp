@@ -258,7 +258,7 @@ void Core::tick()
         if (inserted == window.ipc) return;
         if (window.is_full()) return;
 
-        Request req(req_addr, req_type, callback, id);
+        Request req(req_addr, req_type, &Core::request_done, this, id);
         if (!send(req)) return;
 
         window.insert(false, req_addr);
@@ -267,7 +267,7 @@ void Core::tick()
     else {
         // write request
         assert(req_type == Request::Type::WRITE);
-        Request req(req_addr, req_type, callback, id);
+        Request req(req_addr, req_type, &Core::request_done, this, id);
         if (!send(req)) return;
         cpu_inst++;
     }
@@ -318,6 +318,11 @@ long Core::get_insts() {
     return long(cpu_inst.value());
 }
 
+void Core::request_done(Request& req, void* core)
+{
+    static_cast<Core*>(core)->callback(req);
+}
+
 void Core::receive(Request& req)
 {
     window.set_ready(req.addr, ~(l1_blocksz - 1l));
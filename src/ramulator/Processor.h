@@ -97,6 +97,8 @@ class Core {
   bool   has_reached_limit();
   long   get_insts();  // the number of the instructions issued to the core
   function<void(Request&)> callback;
+  // Request::Callback of the requests of the core, calls callback
+  static void request_done(Request& req, void* core);
 
   bool no_core_caches  = true;
   bool no_shared_cache = true;
@@ -271,6 +271,11 @@ void Refresh<DSARP>::tick_ref() {
   if ((clk - refreshed) >= refresh_interval)
     inject_refresh(b_ref_rank);
 }
+// Refreshes can be pulled in on any cycle
+template<>
+long Refresh<DSARP>::next_refresh() {
+  return clk + 1;
+}
 /**** End DSARP specialization ****/
 
 } /* namespace ramulator */
@@ -104,6 +104,16 @@ public:
     }
   }
 
+  // The tick at which tick_ref() injects the next refresh. Until then it only
+  // counts cycles, which skip() does in bulk.
+  long next_refresh() {
+    return refreshed + ctrl->channel->spec->speed_entry.nREFI;
+  }
+
+  void skip(long cycles) {
+    clk += cycles;
+  }
+
 private:
   // Keeping track of refresh status of every bank: + means ahead of schedule, - means behind schedule
   vector<vector<int>*> bank_refresh_backlog;
@@ -119,7 +129,7 @@ private:
   // Refresh based on the specified address
   void refresh_target(Controller<T>* ctrl, int rank, int bank, int sa)
   {
-    vector<int> addr_vec(int(T::Level::MAX), -1);
+    AddrVec addr_vec(int(T::Level::MAX), -1);
     addr_vec[0] = ctrl->channel->id;
     addr_vec[1] = rank;
     addr_vec[2] = bank;
@@ -153,6 +163,7 @@ private:
 // where to look for these definitions when controller calls them!
 template<> Refresh<DSARP>::Refresh(Controller<DSARP>* ctrl);
 template<> void Refresh<DSARP>::tick_ref();
+template<> long Refresh<DSARP>::next_refresh();
 
 } /* namespace ramulator */
 
@@ -22,21 +22,80 @@
 #ifndef __REQUEST_H
 #define __REQUEST_H
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <vector>
-#include <functional>
 
 using namespace std;
 
 namespace ramulator
 {
 
+// Deepest organization (T::Level::MAX) of the supported standards
+#define RAMULATOR_MAX_LEVELS 8
+
+// The address of a request at each level of the organization (channel, rank,
+// ..., column). The levels are stored in place, so requests are copied and
+// queued without touching the heap.
+class AddrVec
+{
+public:
+    AddrVec() : n(0) {}
+    AddrVec(int size, int value) : n(0) { resize(size, value); }
+    AddrVec(const vector<int>& vec) : AddrVec(vec.data(), vec.data() + vec.size()) {}
+    AddrVec(const int* first, const int* last) : n(0)
+    {
+        resize(last - first);
+        std::copy(first, last, v);
+    }
+
+    int size() const { return n; }
+    bool empty() const { return n == 0; }
+    void resize(int size, int value = 0)
+    {
+        assert(size <= RAMULATOR_MAX_LEVELS);
+        for (int i = n; i < size; i++)
+            v[i] = value;
+        n = size;
+    }
+
+    int& operator[](int i) { return v[i]; }
+    int operator[](int i) const { return v[i]; }
+    int* data() { return v; }
+    const int* data() const { return v; }
+    int* begin() { return v; }
+    const int* begin() const { return v; }
+    int* end() { return v + n; }
+    const int* end() const { return v + n; }
+
+    bool operator==(const AddrVec& other) const
+    {
+        return n == other.n && std::equal(begin(), end(), other.begin());
+    }
+
+    bool operator<(const AddrVec& other) const
+    {
+        return std::lexicographical_compare(begin(), end(), other.begin(), other.end());
+    }
+
+private:
+    int n;
+    int v[RAMULATOR_MAX_LEVELS];
+};
+
 class Request
 {
 public:
+    // Called with the callback_ctx given to the request
+    typedef void (*Callback)(Request& req, void* ctx);
+
     bool is_first_command;
     long addr;
     // long addr_row;
-    vector<int> addr_vec;
+    AddrVec addr_vec;
     // specify which core this request sent from, for virtual address translation
     int coreid;
 
@@ -53,23 +112,276 @@ public:
 
     long arrive = -1;
     long depart = -1;
-    function<void(Request&)> callback; // call back with more info
+    Callback callback; // call back with more info
+    void* callback_ctx;
+
+    // Links of the RequestList the request is in
+    Request* prev = nullptr;
+    Request* next = nullptr;
+    long seq = 0;  // order in that list
+
+    // Set by the owner of an indexed RequestList (see RequestIndex)
+    int bank = -1;
+    bool row_hit = false;
+    Request* bank_prev = nullptr;
+    Request* bank_next = nullptr;
 
     Request(long addr, Type type, int coreid = 0)
         : is_first_command(true), addr(addr), coreid(coreid), type(type),
-      callback([](Request& req){}) {}
+      callback(nullptr), callback_ctx(nullptr) {}
 
-    Request(long addr, Type type, function<void(Request&)> callback, int coreid = 0)
-        : is_first_command(true), addr(addr), coreid(coreid), type(type), callback(callback) {}
+    Request(long addr, Type type, Callback callback, void* callback_ctx, int coreid = 0)
+        : is_first_command(true), addr(addr), coreid(coreid), type(type), callback(callback),
+      callback_ctx(callback_ctx) {}
 
-    Request(vector<int>& addr_vec, Type type, function<void(Request&)> callback, int coreid = 0)
-        : is_first_command(true), addr_vec(addr_vec), coreid(coreid), type(type), callback(callback) {}
+    Request(const AddrVec& addr_vec, Type type, Callback callback, void* callback_ctx = nullptr, int coreid = 0)
+        : is_first_command(true), addr_vec(addr_vec), coreid(coreid), type(type), callback(callback),
+      callback_ctx(callback_ctx) {}
 
     Request()
-        : is_first_command(true), coreid(0) {}
+        : is_first_command(true), coreid(0), callback(nullptr), callback_ctx(nullptr) {}
+
+    void complete()
+    {
+        if (callback)
+            callback(*this, callback_ctx);
+    }
+};
+
+// Storage for the requests queued in one controller. Requests are allocated in
+// chunks and recycled through a free list.
+class RequestPool
+{
+public:
+    Request* alloc(const Request& req)
+    {
+        if (!free_head)
+            expand();
+        Request* node = free_head;
+        free_head = node->next;
+        *node = req;
+        return node;
+    }
+
+    void release(Request* node)
+    {
+        node->next = free_head;
+        free_head = node;
+    }
+
+private:
+    static const int CHUNK_REQS = 64;
+
+    void expand()
+    {
+        chunks.emplace_back(new Request[CHUNK_REQS]);
+        Request* chunk = chunks.back().get();
+        for (int i = 0; i < CHUNK_REQS; i++) {
+            chunk[i].next = free_head;
+            free_head = &chunk[i];
+        }
+    }
+
+    Request* free_head = nullptr;
+    vector<unique_ptr<Request[]>> chunks;
+};
+
+// Buckets the requests of a RequestList by bank, in queue order, and keeps the
+// oldest row hit and the oldest other request of each bank, so a scheduler
+// only has to look at two requests per bank. The owner sets Request::bank and
+// Request::row_hit before queueing a request, and calls set_row_hits() on the
+// banks whose open rows changed.
+class RequestIndex
+{
+public:
+    struct Bank {
+        Request* head = nullptr;
+        Request* tail = nullptr;
+        Request* first[2] = {nullptr, nullptr};  // indexed by row_hit
+        int active_pos = -1;
+
+        // Left to the scheduler, for what it derives from first[]
+        long epoch[2] = {-1, -1};
+        long ready_at[2] = {0, 0};
+        bool capped[2] = {false, false};
+    };
+
+    void resize(int num_banks) { banks.resize(num_banks); }
+    Bank& get_bank(int bank) { return banks[bank]; }
+    // The banks with requests, in no particular order
+    const vector<int>& get_active() const { return active; }
+
+    void link(Request* node)
+    {
+        Bank& bank = banks[node->bank];
+        node->bank_prev = bank.tail;
+        node->bank_next = nullptr;
+        if (bank.tail) {
+            bank.tail->bank_next = node;
+        } else {
+            bank.head = node;
+            bank.active_pos = active.size();
+            active.push_back(node->bank);
+        }
+        bank.tail = node;
+        if (!bank.first[node->row_hit])
+            bank.first[node->row_hit] = node;
+    }
+
+    void unlink(Request* node)
+    {
+        Bank& bank = banks[node->bank];
+        if (bank.first[node->row_hit] == node)
+            bank.first[node->row_hit] = next_of(node->bank_next, node->row_hit);
+        if (node->bank_prev)
+            node->bank_prev->bank_next = node->bank_next;
+        else
+            bank.head = node->bank_next;
+        if (node->bank_next)
+            node->bank_next->bank_prev = node->bank_prev;
+        else
+            bank.tail = node->bank_prev;
+        if (!bank.head) {
+            int last = active.back();
+            active[bank.active_pos] = last;
+            banks[last].active_pos = bank.active_pos;
+            active.pop_back();
+            bank.active_pos = -1;
+        }
+    }
+
+    // Re-evaluates Request::row_hit of the requests of a bank
+    template <typename IsRowHit>
+    void set_row_hits(int bank_id, IsRowHit is_row_hit)
+    {
+        Bank& bank = banks[bank_id];
+        bank.first[0] = bank.first[1] = nullptr;
+        for (Request* node = bank.head; node; node = node->bank_next) {
+            node->row_hit = is_row_hit(*node);
+            if (!bank.first[node->row_hit])
+                bank.first[node->row_hit] = node;
+        }
+    }
+
+private:
+    static Request* next_of(Request* node, bool row_hit)
+    {
+        while (node && node->row_hit != row_hit)
+            node = node->bank_next;
+        return node;
+    }
+
+    vector<Bank> banks;
+    vector<int> active;
+};
+
+// A queue of requests linked through Request::prev/next. Pushing copies the
+// request into a node of the pool, and splice_back() moves a node from one
+// list to another of the same pool, so none of the operations allocate.
+class RequestList
+{
+public:
+    class iterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef Request value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Request* pointer;
+        typedef Request& reference;
+
+        iterator(Request* node = nullptr, const RequestList* list = nullptr)
+            : node(node), list(list) {}
+
+        Request& operator*() const { return *node; }
+        Request* operator->() const { return node; }
+        iterator& operator++() { node = node->next; return *this; }
+        iterator operator++(int) { iterator old = *this; node = node->next; return old; }
+        iterator& operator--() { node = node ? node->prev : list->tail; return *this; }
+        iterator operator--(int) { iterator old = *this; --*this; return old; }
+        bool operator==(const iterator& other) const { return node == other.node; }
+        bool operator!=(const iterator& other) const { return node != other.node; }
+
+    private:
+        friend class RequestList;
+        Request* node;
+        const RequestList* list;  // for decrementing end()
+    };
+
+    RequestList(RequestPool* pool = nullptr) : pool(pool) {}
+    RequestList(const RequestList&) = delete;
+    RequestList& operator=(const RequestList&) = delete;
+
+    void set_pool(RequestPool* _pool) { pool = _pool; }
+    void set_index(RequestIndex* _index) { index = _index; }
+    RequestIndex* get_index() { return index; }
+
+    iterator begin() { return iterator(head, this); }
+    iterator end() { return iterator(nullptr, this); }
+    unsigned int size() const { return count; }
+    bool empty() const { return count == 0; }
+    Request& front() { return *head; }
+    Request& back() { return *tail; }
+
+    void push_back(const Request& req) { link_back(pool->alloc(req)); }
+    void pop_front() { erase(begin()); }
+    void pop_back() { erase(iterator(tail, this)); }
+
+    iterator erase(iterator it)
+    {
+        Request* next = it.node->next;
+        unlink(it.node);
+        pool->release(it.node);
+        return iterator(next, this);
+    }
+
+    // Moves the request at it from the other list to the back of this one
+    void splice_back(RequestList& from, iterator it)
+    {
+        assert(from.pool == pool);
+        from.unlink(it.node);
+        link_back(it.node);
+    }
+
+private:
+    void link_back(Request* node)
+    {
+        node->seq = next_seq++;
+        node->prev = tail;
+        node->next = nullptr;
+        if (tail)
+            tail->next = node;
+        else
+            head = node;
+        tail = node;
+        count++;
+        if (index)
+            index->link(node);
+    }
+
+    void unlink(Request* node)
+    {
+        if (node->prev)
+            node->prev->next = node->next;
+        else
+            head = node->next;
+        if (node->next)
+            node->next->prev = node->prev;
+        else
+            tail = node->prev;
+        count--;
+        if (index)
+            index->unlink(node);
+    }
+
+    RequestPool* pool;
+    RequestIndex* index = nullptr;
+    long next_seq = 0;
+    Request* head = nullptr;
+    Request* tail = nullptr;
+    unsigned int count = 0;
 };
 
 } /*namespace ramulator*/
 
 #endif /*__REQUEST_H*/
-
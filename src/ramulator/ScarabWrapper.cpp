@@ -74,6 +74,14 @@ void ScarabWrapper::tick() {
   mem->tick();
 }
 
+long ScarabWrapper::idle_cycles() {
+  return mem->idle_cycles();
+}
+
+void ScarabWrapper::skip(long cycles) {
+  mem->skip(cycles);
+}
+
 bool ScarabWrapper::send(Request req) {
   return mem->send(req);
 }
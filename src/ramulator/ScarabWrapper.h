@@ -43,6 +43,8 @@ public:
     ScarabWrapper(const Config& configs, const unsigned int cacheline, void (* stats_callback)(int, int));
     ~ScarabWrapper();
     void tick();
+    long idle_cycles();
+    void skip(long cycles);
     bool send(Request req);
     void finish(void);
 
@@ -66,10 +66,19 @@ public:
             assert(false && "Unknown memory request scheduler. Please make \
 sure to set RAMULATOR_SCHEDULING_POLICY to one of the \
 available policies: FCFS, FRFCFS, FRFCFS_Cap, \
-FRFCFS_PriorHit"); }
+FRFCFS_PriorHit");
 
-    list<Request>::iterator get_head(list<Request>& q)
+        // PriorHit spares the rows of the PRE scope, which must be the banks
+        // the queues are indexed by
+        indexed_prior_hit = int(ctrl->channel->spec->scope[int(T::Command::PRE)]) == int(T::Level::Bank);
+    }
+
+    RequestList::iterator get_head(RequestList& q)
     {
+      if (q.get_index() && policy != Policy::FCFS &&
+          (policy != Policy::FRFCFS_PriorHit || indexed_prior_hit))
+          return get_head_indexed(q);
+
       // TODO make the decision at compile time
       if (policy != Policy::FRFCFS_PriorHit) {
         if (!q.size())
@@ -94,14 +103,14 @@ FRFCFS_PriorHit"); }
         }
 
         // prepare a list of hit request
-        vector<vector<int>> hit_reqs;
+        vector<AddrVec> hit_reqs;
         for (auto itr = q.begin() ; itr != q.end() ; ++itr) {
           if (this->ctrl->is_row_hit(itr)) {
             auto begin = itr->addr_vec.begin();
             // TODO Here it assumes all DRAM standards use PRE to close a row
             // It's better to make it more general.
             auto end = begin + int(ctrl->channel->spec->scope[int(T::Command::PRE)]) + 1;
-            vector<int> rowgroup(begin, end); // bank or subarray
+            AddrVec rowgroup(begin, end); // bank or subarray
             hit_reqs.push_back(rowgroup);
           }
         }
@@ -116,7 +125,7 @@ FRFCFS_PriorHit"); }
             // TODO Here it assumes all DRAM standards use PRE to close a row
             // It's better to make it more general.
             auto end = begin + int(ctrl->channel->spec->scope[int(T::Command::PRE)]) + 1;
-            vector<int> rowgroup(begin, end); // bank or subarray
+            AddrVec rowgroup(begin, end); // bank or subarray
             for (const auto& hit_req_rowgroup : hit_reqs) {
               if (rowgroup == hit_req_rowgroup) {
                   violate_hit = true;
@@ -140,7 +149,79 @@ FRFCFS_PriorHit"); }
     }
 
 private:
-    typedef list<Request>::iterator ReqIter;
+    bool indexed_prior_hit = false;
+
+    // Makes the same choice as the scans of get_head() from the oldest row hit
+    // and oldest other request of each bank (see RequestIndex): the requests
+    // of one group have the same first command, so they are ready at the same
+    // tick and only the oldest of them can be chosen.
+    RequestList::iterator get_head_indexed(RequestList& q)
+    {
+        RequestIndex& index = *q.get_index();
+        bool prior_hit = policy == Policy::FRFCFS_PriorHit;
+        Request* head = nullptr;
+        bool head_ready = false;
+
+        for (int id : index.get_active()) {
+            RequestIndex::Bank& bank = index.get_bank(id);
+            for (int hit = 0; hit < 2; hit++) {
+                if (!bank.first[hit])
+                    continue;
+                bool ready = is_ready(q, bank, hit);
+                if (policy == Policy::FRFCFS_Cap)
+                    ready = ready && !bank.capped[hit];
+                else if (prior_hit)
+                    ready = ready && hit;
+                if (!head || precedes(bank.first[hit], ready, head, head_ready)) {
+                    head = bank.first[hit];
+                    head_ready = ready;
+                }
+            }
+        }
+        if (!prior_hit || !head || head_ready)
+            return RequestList::iterator(head, &q);
+
+        // No ready row hit: the oldest ready request that does not close a
+        // row other requests hit in, as FRFCFS would choose
+        head = nullptr;
+        for (int id : index.get_active()) {
+            RequestIndex::Bank& bank = index.get_bank(id);
+            for (int hit = bank.first[1] ? 1 : 0; hit < 2; hit++) {
+                if (!bank.first[hit])
+                    continue;
+                bool ready = is_ready(q, bank, hit);
+                if (!head || precedes(bank.first[hit], ready, head, head_ready)) {
+                    head = bank.first[hit];
+                    head_ready = ready;
+                }
+            }
+        }
+        return RequestList::iterator(head, &q);
+    }
+
+    bool is_ready(RequestList& q, RequestIndex::Bank& bank, int hit)
+    {
+        if (bank.epoch[hit] != ctrl->cmd_epoch) {
+            RequestList::iterator req(bank.first[hit], &q);
+            bank.epoch[hit] = ctrl->cmd_epoch;
+            bank.ready_at[hit] = ctrl->get_ready_at(req);
+            bank.capped[hit] = ctrl->rowtable->get_hits(req->addr_vec) > cap;
+        }
+        return ctrl->clk >= bank.ready_at[hit];
+    }
+
+    // Whether req1 comes first in the order of the compare functions: ready,
+    // then oldest, then first in the queue
+    static bool precedes(Request* req1, bool ready1, Request* req2, bool ready2)
+    {
+        if (ready1 != ready2)
+            return ready1;
+        if (req1->arrive != req2->arrive)
+            return req1->arrive < req2->arrive;
+        return req1->seq < req2->seq;
+    }
+
+    typedef RequestList::iterator ReqIter;
     function<ReqIter(ReqIter, ReqIter)> compare[int(Policy::MAX)] = {
         // FCFS
         [this] (ReqIter req1, ReqIter req2) {
@@ -205,37 +286,37 @@ public:
 
     RowPolicy(Controller<T>* ctrl) : ctrl(ctrl) {}
 
-    vector<int> get_victim(typename T::Command cmd)
+    AddrVec get_victim(typename T::Command cmd)
     {
         return policy[int(type)](cmd);
     }
 
 private:
-    function<vector<int>(typename T::Command)> policy[int(Type::MAX)] = {
+    function<AddrVec(typename T::Command)> policy[int(Type::MAX)] = {
         // Closed
-        [this] (typename T::Command cmd) -> vector<int> {
+        [this] (typename T::Command cmd) -> AddrVec {
             for (auto& kv : this->ctrl->rowtable->table) {
                 if (!this->ctrl->is_ready(cmd, kv.first))
                     continue;
                 return kv.first;
             }
-            return vector<int>();},
+            return AddrVec();},
 
         // ClosedAP
-        [this] (typename T::Command cmd) -> vector<int> {
+        [this] (typename T::Command cmd) -> AddrVec {
             for (auto& kv : this->ctrl->rowtable->table) {
                 if (!this->ctrl->is_ready(cmd, kv.first))
                     continue;
                 return kv.first;
             }
-            return vector<int>();},
+            return AddrVec();},
 
         // Opened
         [this] (typename T::Command cmd) {
-            return vector<int>();},
+            return AddrVec();},
 
         // Timeout
-        [this] (typename T::Command cmd) -> vector<int> {
+        [this] (typename T::Command cmd) -> AddrVec {
             for (auto& kv : this->ctrl->rowtable->table) {
                 auto& entry = kv.second;
                 if (this->ctrl->clk - entry.timestamp < timeout)
@@ -244,7 +325,7 @@ private:
                     continue;
                 return kv.first;
             }
-            return vector<int>();}
+            return AddrVec();}
     };
 
 };
@@ -262,15 +343,15 @@ public:
         long timestamp;
     };
 
-    map<vector<int>, Entry> table;
+    map<AddrVec, Entry> table;
 
     RowTable(Controller<T>* ctrl) : ctrl(ctrl) {}
 
-    void update(typename T::Command cmd, const vector<int>& addr_vec, long clk)
+    void update(typename T::Command cmd, const AddrVec& addr_vec, long clk)
     {
         auto begin = addr_vec.begin();
         auto end = begin + int(T::Level::Row);
-        vector<int> rowgroup(begin, end); // bank or subarray
+        AddrVec rowgroup(begin, end); // bank or subarray
         int row = *end;
 
         T* spec = ctrl->channel->spec;
@@ -309,12 +390,12 @@ public:
         } /* closing */
     }
 
-    int get_hits(const vector<int>& addr_vec, const bool to_opened_row = false)
+    int get_hits(const AddrVec& addr_vec, const bool to_opened_row = false)
     {
         auto begin = addr_vec.begin();
         auto end = begin + int(T::Level::Row);
 
-        vector<int> rowgroup(begin, end);
+        AddrVec rowgroup(begin, end);
         int row = *end;
 
         auto itr = table.find(rowgroup);
@@ -327,11 +408,11 @@ public:
         return itr->second.hits;
     }
 
-    int get_open_row(const vector<int>& addr_vec) {
+    int get_open_row(const AddrVec& addr_vec) {
         auto begin = addr_vec.begin();
         auto end = begin + int(T::Level::Row);
 
-        vector<int> rowgroup(begin, end);
+        AddrVec rowgroup(begin, end);
 
         auto itr = table.find(rowgroup);
         if(itr == table.end())
@@ -0,0 +1,350 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : sampling.c
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : Sampled simulation (SMARTS). Each sample is a detailed window
+ *                of SAMPLING_DETAIL_WARM_INSTS instructions of pipeline warmup
+ *                followed by SAMPLING_MEASURE_INSTS measured instructions. Fetch
+ *                is then halted, the pipeline drains, and the caches and branch
+ *                predictors are functionally warmed (model->warmup_func) for
+ *                SAMPLING_WARM_INSTS instructions before the next window.
+ *                The stats only count the measured parts: when a measured
+ *                part starts, and before a core's stats are dumped, the stats
+ *                are rolled back to their values at the end of the previous
+ *                measured part.
+ ***************************************************************************************/
+
+#include <math.h>
+#include "debug/debug_macros.h"
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "decoupled_frontend.h"
+#include "freq.h"
+#include "frontend/frontend.h"
+#include "memory/memory.h"
+#include "model.h"
+#include "op_pool.h"
+#include "sampling.h"
+#include "sim.h"
+#include "statistics.h"
+
+#include "core.param.h"
+#include "general.param.h"
+
+/**************************************************************************************/
+/* Types */
+
+typedef enum Sampling_Phase_enum {
+  SAMPLING_DETAIL_WARM, /* detailed, not measured */
+  SAMPLING_MEASURE,     /* detailed, measured */
+  SAMPLING_DRAIN,       /* fetch halted, waiting for the pipeline to empty */
+} Sampling_Phase;
+
+typedef struct Sampling_Core_struct {
+  Counter window_start_inst;
+  Counter measure_start_inst;
+  Counter measure_start_cycle;
+  Flag    measured; /* this window's sample has been taken */
+  Flag    done;     /* the stats have been finalized for the dump */
+  Stat*   stats;    /* the stats at the end of the last measured part */
+
+  /* running mean/variance of the per-window IPC (Welford) */
+  uns    num_samples;
+  double mean_ipc;
+  double m2_ipc;
+} Sampling_Core;
+
+/**************************************************************************************/
+/* Global variables */
+
+static Sampling_Core* sampling_cores;
+static Sampling_Phase sampling_phase;
+static Flag           sampling_is_converged;
+
+/**************************************************************************************/
+/* Static prototypes */
+
+static Flag   sampling_core_active(uns proc_id);
+static void   sampling_save_stats(uns proc_id);
+static void   sampling_restore_stats(uns proc_id);
+static void   sampling_start_window(void);
+static void   sampling_functional_warm(void);
+static double sampling_rel_error(Sampling_Core* core);
+
+/**************************************************************************************/
+/* sampling_init: */
+
+void sampling_init() {
+  ASSERTM(0, SAMPLING_MEASURE_INSTS > 0, "SAMPLING_MEASURE_INSTS must be > 0\n");
+  ASSERTM(0, model->warmup_func,
+          "Model %s does not have a warmup function\n", model->name);
+  ASSERTM(0,
+          !PERIODIC_DUMP && (!strcmp(CLEAR_STATS, "never") ||
+                             !strcmp(CLEAR_STATS, "none")),
+          "SAMPLING selects the stats itself and cannot be combined with "
+          "PERIODIC_DUMP or CLEAR_STATS\n");
+  sampling_cores = (Sampling_Core*)calloc(NUM_CORES, sizeof(Sampling_Core));
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    sampling_cores[proc_id].stats = (Stat*)malloc(sizeof(Stat) *
+                                                  NUM_GLOBAL_STATS);
+    sampling_save_stats(proc_id);
+  }
+  sampling_is_converged = FALSE;
+  sampling_start_window();
+}
+
+/**************************************************************************************/
+/* sampling_core_active: cores that still take part in sampling */
+
+static Flag sampling_core_active(uns proc_id) {
+  if(DUMB_CORE_ON && DUMB_CORE == proc_id)
+    return FALSE;
+  return !sim_done[proc_id] && !retired_exit[proc_id];
+}
+
+/**************************************************************************************/
+/* sampling_save_stats: */
+
+static void sampling_save_stats(uns proc_id) {
+  memcpy(sampling_cores[proc_id].stats, global_stat_array[proc_id],
+         sizeof(Stat) * NUM_GLOBAL_STATS);
+}
+
+/**************************************************************************************/
+/* sampling_restore_stats: drops everything counted since the last
+ * sampling_save_stats() */
+
+static void sampling_restore_stats(uns proc_id) {
+  for(uns ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+    Stat* stat  = &global_stat_array[proc_id][ii];
+    Stat* saved = &sampling_cores[proc_id].stats[ii];
+    if(stat->noreset)
+      continue;
+    if(stat->type == FLOAT_TYPE_STAT)
+      stat->value = saved->value;
+    else
+      stat->count = saved->count;
+  }
+}
+
+/**************************************************************************************/
+/* sampling_start_window: */
+
+static void sampling_start_window() {
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    sampling_cores[proc_id].window_start_inst = inst_count[proc_id];
+    sampling_cores[proc_id].measured          = FALSE;
+  }
+  sampling_phase = SAMPLING_DETAIL_WARM;
+}
+
+/**************************************************************************************/
+/* sampling_rel_error: half width of the confidence interval of the mean IPC,
+ * relative to the mean */
+
+static double sampling_rel_error(Sampling_Core* core) {
+  if(core->num_samples < 2 || core->mean_ipc == 0.0)
+    return INFINITY;
+  double var = core->m2_ipc / (core->num_samples - 1);
+  return SAMPLING_CONFIDENCE_Z * sqrt(var / core->num_samples) /
+         core->mean_ipc;
+}
+
+/**************************************************************************************/
+/* sampling_functional_warm: the uop_sim() warmup loop, restricted to
+ * SAMPLING_WARM_INSTS instructions per core. The memory system keeps being
+ * ticked so that requests left over from the detailed window complete. */
+
+static void sampling_functional_warm() {
+  Op         op;
+  Table_Info table_info;
+  Inst_Info  inst_info;
+  op.table_info = &table_info;
+  op.inst_info  = &inst_info;
+  op.mbp7_info  = NULL;
+
+  Counter* warm_start = (Counter*)malloc(sizeof(Counter) * NUM_CORES);
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    warm_start[proc_id] = inst_count[proc_id];
+
+  operating_mode = WARMUP_MODE;
+  Flag warm_done = FALSE;
+  while(!warm_done) {
+    warm_done = TRUE;
+    for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+      if(!sampling_core_active(proc_id) ||
+         inst_count[proc_id] - warm_start[proc_id] >= SAMPLING_WARM_INSTS ||
+         (INST_LIMIT && inst_count[proc_id] >= inst_limit[proc_id]))
+        continue;
+      warm_done = FALSE;
+      do {
+        frontend_fetch_op(proc_id, &op);
+        op_count[proc_id]++;
+        if(op.eom)
+          inst_count[proc_id]++;
+        if(op.exit)
+          retired_exit[proc_id] = TRUE;
+        model->warmup_func(&op);
+        if(op.eom)
+          frontend_retire(op.proc_id, op.inst_uid);
+      } while(!op.eom);
+    }
+
+    do {
+      freq_advance_time();
+      sim_time = freq_time();
+      update_memory();
+    } while(!freq_is_ready(FREQ_DOMAIN_L1));
+  }
+  operating_mode = SIMULATION_MODE;
+  free(warm_start);
+}
+
+/**************************************************************************************/
+/* sampling_cycle: */
+
+void sampling_cycle() {
+  Flag all_reached = TRUE;
+
+  switch(sampling_phase) {
+    case SAMPLING_DETAIL_WARM:
+      for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+        Sampling_Core* core = &sampling_cores[proc_id];
+        if(sampling_core_active(proc_id) &&
+           inst_count[proc_id] - core->window_start_inst <
+             SAMPLING_DETAIL_WARM_INSTS)
+          all_reached = FALSE;
+      }
+      if(!all_reached)
+        break;
+      for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+        Sampling_Core* core       = &sampling_cores[proc_id];
+        core->measure_start_inst  = inst_count[proc_id];
+        core->measure_start_cycle = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
+        if(sampling_core_active(proc_id))
+          sampling_restore_stats(proc_id);
+      }
+      sampling_phase = SAMPLING_MEASURE;
+      break;
+
+    case SAMPLING_MEASURE:
+      for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+        Sampling_Core* core = &sampling_cores[proc_id];
+        if(!sampling_core_active(proc_id) || core->measured)
+          continue;
+        Counter insts = inst_count[proc_id] - core->measure_start_inst;
+        if(insts < SAMPLING_MEASURE_INSTS) {
+          all_reached = FALSE;
+          continue;
+        }
+        Counter cycles = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]) -
+                         core->measure_start_cycle;
+        double ipc = (double)insts / MAX2(cycles, 1);
+        double delta = ipc - core->mean_ipc;
+        core->num_samples++;
+        core->mean_ipc += delta / core->num_samples;
+        core->m2_ipc += delta * (ipc - core->mean_ipc);
+        core->measured = TRUE;
+        STAT_EVENT(proc_id, SAMPLING_SAMPLES);
+        INC_STAT_EVENT(proc_id, SAMPLING_MEASURED_INSTS, insts);
+        INC_STAT_EVENT(proc_id, SAMPLING_MEASURED_CYCLES, cycles);
+        sampling_save_stats(proc_id);
+      }
+      if(!all_reached)
+        break;
+
+      sampling_is_converged = TRUE;
+      for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+        Sampling_Core* core = &sampling_cores[proc_id];
+        if(sampling_core_active(proc_id) &&
+           (core->num_samples < SAMPLING_MIN_SAMPLES ||
+            sampling_rel_error(core) > SAMPLING_TARGET_ERROR))
+          sampling_is_converged = FALSE;
+      }
+      if(sampling_is_converged)
+        break;
+      for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+        decoupled_fe_halt_fetch(proc_id, TRUE);
+      sampling_phase = SAMPLING_DRAIN;
+      break;
+
+    case SAMPLING_DRAIN:
+      /* every fetched op has retired or been flushed */
+      for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+        if(op_pool_active_ops[proc_id])
+          return;
+      }
+      for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+        decoupled_fe_halt_fetch(proc_id, FALSE);
+      sampling_functional_warm();
+      sampling_start_window();
+      break;
+
+    default:
+      FATAL_ERROR(0, "Unknown sampling phase %d\n", sampling_phase);
+  }
+}
+
+/**************************************************************************************/
+/* sampling_converged: */
+
+Flag sampling_converged() {
+  return sampling_is_converged;
+}
+
+/**************************************************************************************/
+/* sampling_core_done: */
+
+void sampling_core_done(uns proc_id) {
+  Sampling_Core* core = &sampling_cores[proc_id];
+  if(core->done)
+    return;
+  sampling_restore_stats(proc_id);
+  global_stat_array[proc_id][SAMPLING_IPC].value = core->mean_ipc;
+  global_stat_array[proc_id][SAMPLING_IPC_ERROR_PCT].value =
+    100.0 * sampling_rel_error(core);
+  core->done = TRUE;
+}
+
+/**************************************************************************************/
+/* sampling_done: */
+
+void sampling_done() {
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Sampling_Core* core = &sampling_cores[proc_id];
+    if(DUMB_CORE_ON && DUMB_CORE == proc_id)
+      continue;
+    sampling_core_done(proc_id);
+    fprintf(mystdout,
+            "** Core %u Sampled:  samples:%-6u  IPC:%.4f  +/- %.2f%% "
+            "(z=%.2f)\n",
+            proc_id, core->num_samples, core->mean_ipc,
+            100.0 * sampling_rel_error(core), SAMPLING_CONFIDENCE_Z);
+  }
+  fflush(mystdout);
+}
@@ -0,0 +1,58 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : sampling.h
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : Sampled simulation with functional warming between detailed
+ *                windows
+ ***************************************************************************************/
+
+#ifndef __SAMPLING_H__
+#define __SAMPLING_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Called once before the full_sim main loop */
+void sampling_init(void);
+
+/* Called after every simulated cycle. May functionally warm the machine
+   (without advancing the detailed pipeline) between windows. */
+void sampling_cycle(void);
+
+/* TRUE once every core has met the target confidence interval */
+Flag sampling_converged(void);
+
+/* Drops the stats counted since the core's last measured window and fills in
+   the sampling stats. Called before the core's stats are dumped. */
+void sampling_core_done(uns proc_id);
+
+/* Finishes the cores still running and prints the per-core sampled IPC and
+   its confidence interval */
+void sampling_done(void);
+
+/**************************************************************************************/
+
+#endif /* #ifndef __SAMPLING_H__ */
@@ -51,6 +51,7 @@
 #include "debug/pipeview.h"
 #include "dumb_model.h"
 #include "frontend/pin_trace_fe.h"
+#include "idle_skip.h"
 #include "model.h"
 #include "optimizer2.h"
 #include "power/power_intf.h"
@@ -64,8 +65,13 @@
 #include "debug/debug.param.h"
 #include "general.param.h"
 #include "prefetcher/pref.param.h"
+#include "ramulator.param.h"
 
+#include "memory/dram_fast.h"
 #include "ramulator.h"
+#include "sampling.h"
+#include "sweep.h"
+#include "warm_state.h"
 
 /**************************************************************************************/
 /* Macros */
@@ -86,7 +92,7 @@ Counter* op_count;              /* the global op counter per core*/
 Counter* inst_count; /* the global instruction counter - retired per core */
 Counter* inst_count_fetched; /* the global FETCHED instruction counter - retired per core */
 Counter* uop_count;  /* the global uop counter - retired per core*/
-Counter  cycle_count = 0; /* the global cycle counter */
+__thread Counter cycle_count = 0; /* the global cycle counter */
 Counter  sim_time    = 0; /* the global time counter */
 Counter* pret_inst_count; /* the global pseudo-retired instruction counter */
 Flag*    trace_read_done;
@@ -113,7 +119,7 @@ Counter  period_ID = 0;
 /* the global warmup dump flags */
 Flag*    warmup_dump_done;
 
-Hash_Table per_branch_stat;
+Hash_Table* per_branch_stat; /* per core */
 Uop_Queue_Fill_Time uop_queue_fill_time;
 
 time_t sim_start_time; /* the time that the simulator was started */
@@ -130,7 +136,7 @@ Model* model; /* pointer to the simulator model being used
 
 Thread_Data
              single_td; /* cmp Only For single processor: backward compatibility issue*/
-Thread_Data* td = &single_td; /* array of tds for muti-core, all state
+__thread Thread_Data* td = &single_td; /* array of tds for muti-core, all state
                                  associated with the simulated thread */
 
 /**************************************************************************************/
@@ -141,6 +147,7 @@ static void init_model(uns mode);
 static void init_output_streams(void);
 static void process_params(void);
 static void reset_uop_mode_counters(void);
+static Flag skip_warmup(void);
 
 static inline void    check_heartbeat(uns8 proc_id, Flag final);
 static inline Counter check_forward_progress(uns8 proc_id);
@@ -280,13 +287,16 @@ static inline void check_heartbeat(uns8 proc_id, Flag final) {
                   proc_id, unsstr64(inst_count[proc_id]), unsstr64(cycle_count),
                   unsstr64(sim_time), cum_ipc, cum_ipc, cum_khz);
           FILE* fp = fopen("per_branch_stats.csv", "w");
-          Per_Branch_Stat** entries = (Per_Branch_Stat**) hash_table_flatten(&per_branch_stat, NULL);
           fprintf(fp, "cf_type,addr,target\n");
-          for (int i=0; i<per_branch_stat.count; i++) {
-            Per_Branch_Stat* entry = entries[i];
-            fprintf(fp, "%i,%llx,%llx\n", entry->cf_type, entry->addr, entry->target);
+          for (uns bstat_proc_id = 0; bstat_proc_id < NUM_CORES; bstat_proc_id++) {
+            Hash_Table* bstats = &per_branch_stat[bstat_proc_id];
+            Per_Branch_Stat** entries = (Per_Branch_Stat**) hash_table_flatten(bstats, NULL);
+            for (int i=0; i<bstats->count; i++) {
+              Per_Branch_Stat* entry = entries[i];
+              fprintf(fp, "%i,%llx,%llx\n", entry->cf_type, entry->addr, entry->target);
+            }
+            free(entries);
           }
-          free(entries);
 
           // Dump uop queue fill time stats. One line for each size, how many cycles it took to reach after resteer.
           fp = fopen("uop_queue_fill_cycles.csv", "w");
@@ -525,6 +535,8 @@ void init_global_counter() {
 
   warmup_dump_done = (Flag*)malloc(sizeof(Flag) * NUM_CORES);
   memset(warmup_dump_done, 0, sizeof(Flag) * NUM_CORES);
+
+  per_branch_stat = (Hash_Table*)malloc(sizeof(Hash_Table) * NUM_CORES);
 }
 
 /**************************************************************************************/
@@ -612,6 +624,31 @@ static inline void print_bogus_sim_param(uns8 proc_id) {
           cycle_count - sim_done_last_cycle_count[proc_id], ipc);
 }
 
+/**************************************************************************************/
+/* skip_warmup: with a warm state image nothing is modeled during warmup, so
+ * the frontend skips the warmup instructions instead of fetching them (if it
+ * can). The time still advances as in the uop_sim() warmup loop, one L1 cycle
+ * per instruction, so that the replacement state of the image stays valid. */
+
+static Flag skip_warmup() {
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    if(DUMB_CORE_ON && DUMB_CORE == proc_id)
+      continue;
+    if(!frontend_skip(proc_id, WARMUP))
+      return FALSE;
+    inst_count[proc_id] = WARMUP;
+  }
+
+  for(Counter ii = 0; ii < WARMUP; ii++) {
+    do {
+      freq_advance_time();
+    } while(!freq_is_ready(FREQ_DOMAIN_L1));
+  }
+  sim_time = freq_time();
+  check_heartbeat(0, TRUE);
+  return TRUE;
+}
+
 /**************************************************************************************/
 /* uop_sim: This is the main loop for running in uop level simulation mode.*/
 
@@ -630,6 +667,9 @@ void uop_sim() {
   op.inst_info  = &inst_info;
   op.mbp7_info  = NULL;
 
+  if(operating_mode == WARMUP_MODE && WARM_STATE_LOAD && skip_warmup())
+    return;
+
   Flag uop_sim_done = FALSE;
 
   while(!uop_sim_done) {
@@ -661,7 +701,11 @@ void uop_sim() {
 
           switch(operating_mode) {
             case WARMUP_MODE:
-              model->warmup_func(&op);
+              /* a frontend that cannot skip is still consumed so that
+                 simulation starts at the same instruction as in the run that
+                 saved the image */
+              if(!WARM_STATE_LOAD)
+                model->warmup_func(&op);
               break;
             case SIMULATION_MODE:
               if(!sim_done[proc_id]) {
@@ -720,6 +764,10 @@ void full_sim() {
   if(WARMUP) {
     operating_mode = WARMUP_MODE;
     uop_sim();
+    if(WARM_STATE_LOAD)
+      warm_state_load(WARM_STATE_LOAD);
+    if(WARM_STATE_SAVE)
+      warm_state_save(WARM_STATE_SAVE);
     reset_uop_mode_counters();
     reset_stats(FALSE);  // ignore stats accumulated during warmup
     /* The call below resets the cycle counts of all frequency
@@ -733,6 +781,15 @@ void full_sim() {
          code is not memory-aware and assumes that the first
          simulation cycle is cycle zero). */
     freq_reset_cycle_counts();
+  } else if(WARM_STATE_LOAD || WARM_STATE_SAVE) {
+    FATAL_ERROR(0, "WARM_STATE_LOAD and WARM_STATE_SAVE require WARMUP\n");
+  }
+
+  if(SWEEP_FILE) {
+    sweep_fork();
+    /* reopen the output files in this configuration's OUTPUT_DIR */
+    close_output_streams();
+    init_output_streams();
   }
 
   operating_mode = SIMULATION_MODE;
@@ -749,12 +806,25 @@ void full_sim() {
   sim_limit   = trigger_create("SIM_LIMIT", SIM_LIMIT, TRIGGER_ONCE);
   clear_stats = trigger_create("CLEAR_STATS", CLEAR_STATS, TRIGGER_ONCE);
 
+  if(SAMPLING)
+    sampling_init();
+
+  /* idle_skip_jump() leaves out whole iterations of this loop, so nothing in
+     it may act on every cycle, and the triggers must wait on instructions */
+  Flag jump_idle_cycles = SKIP_IDLE_CYCLES && !DUMB_CORE_ON && !SAMPLING &&
+                          !STATS_TO_TRACE && !DEBUG_MODEL;
+
   /* main loop */
   while(!trigger_fired(sim_limit)) {
     // sim control
     if((EXIT_COND == LAST_DONE && all_sim_done) ||
        (EXIT_COND == FIRST_DONE && any_sim_done))
       break;
+    if(SAMPLING && sampling_converged())
+      break;
+    if(jump_idle_cycles && trigger_counts_insts(sim_limit) &&
+       trigger_counts_insts(clear_stats))
+      idle_skip_jump();
     freq_advance_time();
     sim_time = freq_time();
     model->cycle_func();
@@ -777,6 +847,9 @@ void full_sim() {
       reset_stats(TRUE);
     }
 
+    if(SAMPLING)
+      sampling_cycle();
+
     all_sim_done = TRUE;
     any_sim_done = FALSE;
     for(proc_id = 0; proc_id < NUM_CORES; proc_id++) {
@@ -788,6 +861,8 @@ void full_sim() {
       if(SIM_MODEL != DUMB_MODEL && DUMB_CORE_ON && DUMB_CORE == proc_id)
         continue;
       if(!sim_done[proc_id] && (retired_exit[proc_id] || reachedInstLimit)) {
+        if(SAMPLING)
+          sampling_core_done(proc_id);
         if(model->per_core_done_func)
           model->per_core_done_func(proc_id);
         if(FDIP_ENABLE) {
@@ -835,6 +910,8 @@ void full_sim() {
     }
   }
 
+  if(SAMPLING)
+    sampling_done();
   if(model->done_func)
     model->done_func();
   if(SIM_MODEL != DUMB_MODEL && DUMB_CORE_ON)
@@ -846,7 +923,10 @@ void full_sim() {
   memview_done();
   power_intf_done();
   frontend_done(retired_exit);
-  ramulator_finish();
+  if(DRAM_FAST_MODEL)
+    dram_fast_finish();
+  else
+    ramulator_finish();
 
   for(proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     if(!sim_done[proc_id]) {
@@ -0,0 +1,250 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : sweep.c
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : Parameter sweeps that share one warmup. After warmup the
+ *                process forks one child per line of SWEEP_FILE; each child
+ *                applies that line's parameter overrides and simulates with
+ *                its own OUTPUT_DIR, while the warmed caches, predictors and
+ *                frontend state are shared copy-on-write. The parent only
+ *                waits for the children and never returns. The simulation
+ *                model is not re-initialized in the children, so only the
+ *                parameters in sweep_params.def (read while simulating, not
+ *                when sizing structures) may be overridden.
+ ***************************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "frontend/frontend_intf.h"
+#include "idle_skip.h"
+#include "optimizer2.h"
+#include "param_parser.h"
+#include "sweep.h"
+
+#include "core.param.h"
+#include "general.param.h"
+#include "ramulator.param.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define SWEEP_DELIMITERS " \t\r\n"
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Sweep_Config_struct {
+  char*  line; /* the overrides as written in SWEEP_FILE */
+  char** args;
+  uns    num_args;
+  pid_t  pid;
+} Sweep_Config;
+
+/**************************************************************************************/
+/* Global variables */
+
+/* Parameters that are only read while simulating. Everything else (widths,
+   queue and cache sizes, predictor and DRAM model choices, ...) is used by
+   init_model, which has already run in warmup. */
+static const char* const sweep_params[] = {
+#define SWEEP_PARAM(name) #name,
+#include "sweep_params.def"
+#undef SWEEP_PARAM
+};
+
+/**************************************************************************************/
+/* Static prototypes */
+
+static void sweep_check_param(const char* arg);
+static uns  sweep_read_file(Sweep_Config** configs);
+static void sweep_child(Sweep_Config* config, uns config_num);
+
+/**************************************************************************************/
+/* sweep_check_param: rejects an override of a parameter outside sweep_params
+ * ("--name value" and "--name=value" forms) */
+
+static void sweep_check_param(const char* arg) {
+  if(strncmp(arg, "--", 2))
+    return; /* a value */
+
+  const char* name = arg + 2;
+  uns         len  = strcspn(name, "=");
+  for(uns ii = 0; ii < sizeof(sweep_params) / sizeof(sweep_params[0]); ii++) {
+    if(strlen(sweep_params[ii]) == len && !strncmp(name, sweep_params[ii], len))
+      return;
+  }
+  FATAL_ERROR(0,
+              "Sweep file '%s' overrides '%.*s', which is set up before the "
+              "sweep forks and cannot change per configuration\n",
+              SWEEP_FILE, (int)len, name);
+}
+
+/**************************************************************************************/
+/* sweep_read_file: one configuration per non-empty line, '#' starts a
+ * comment line */
+
+static uns sweep_read_file(Sweep_Config** configs) {
+  FILE* file = fopen(SWEEP_FILE, "r");
+  if(!file)
+    FATAL_ERROR(0, "Could not open sweep file '%s'\n", SWEEP_FILE);
+
+  uns  num_configs = 0;
+  char buf[MAX_STR_LENGTH + 1];
+  *configs = NULL;
+  while(fgets(buf, MAX_STR_LENGTH + 1, file)) {
+    char* start = buf + strspn(buf, SWEEP_DELIMITERS);
+    if(*start == '\0' || *start == '#')
+      continue;
+    start[strcspn(start, "\r\n")] = '\0';
+
+    *configs = (Sweep_Config*)realloc(*configs,
+                                      sizeof(Sweep_Config) * (num_configs + 1));
+    Sweep_Config* config = &(*configs)[num_configs++];
+    config->line         = strdup(start);
+    config->args         = NULL;
+    config->num_args     = 0;
+    config->pid          = -1;
+
+    char* tokens = strdup(start);
+    for(char* tok = strtok(tokens, SWEEP_DELIMITERS); tok;
+        tok       = strtok(NULL, SWEEP_DELIMITERS)) {
+      sweep_check_param(tok);
+      config->args = (char**)realloc(config->args,
+                                     sizeof(char*) * (config->num_args + 1));
+      config->args[config->num_args++] = tok;
+    }
+  }
+  fclose(file);
+
+  if(!num_configs)
+    FATAL_ERROR(0, "Sweep file '%s' has no configurations\n", SWEEP_FILE);
+  return num_configs;
+}
+
+/**************************************************************************************/
+/* sweep_child: runs in the forked process before it continues the
+ * simulation */
+
+static void sweep_child(Sweep_Config* config, uns config_num) {
+  char dir[MAX_STR_LENGTH + 1];
+
+  decouple_open_files();
+
+  /* default to a per-configuration directory; an --output_dir override in
+     the sweep file takes precedence */
+  snprintf(dir, MAX_STR_LENGTH, "%s/sweep.%u", OUTPUT_DIR, config_num);
+  char* output_dir_args[] = {"--output_dir", dir};
+  set_params(2, output_dir_args);
+  set_params(config->num_args, config->args);
+  idle_skip_reconfigure();
+
+  if(mkdir(OUTPUT_DIR, 0755) && errno != EEXIST)
+    FATAL_ERROR(0, "Could not create sweep output directory '%s'\n",
+                OUTPUT_DIR);
+
+  FILE* params = file_tag_fopen(OUTPUT_DIR, "sweep_params", "w");
+  if(!params)
+    FATAL_ERROR(0, "Could not write the sweep parameters to '%s'\n",
+                OUTPUT_DIR);
+  fprintf(params, "config %u: %s\n", config_num, config->line);
+  fclose(params);
+}
+
+/**************************************************************************************/
+/* sweep_fork: */
+
+void sweep_fork() {
+  ASSERTM(0, FRONTEND != FE_PIN_EXEC_DRIVEN,
+          "Parameter sweeps cannot fork the pin_exec_driven frontend (it is "
+          "connected to a single PIN process)\n");
+  /* fork() only copies the calling thread */
+  ASSERTM(0, FRONTEND != FE_TRACE,
+          "Parameter sweeps cannot fork the trace frontend (its per-core "
+          "read-ahead threads would not run in the children)\n");
+  ASSERTM(0, DRAM_FAST_MODEL || RAMULATOR_TICK_THREADS <= 1,
+          "Parameter sweeps cannot tick DRAM channels on threads "
+          "(RAMULATOR_TICK_THREADS)\n");
+  ASSERTM(0, !TRACE_DECODE_THREAD,
+          "Parameter sweeps cannot decode traces on threads "
+          "(TRACE_DECODE_THREAD)\n");
+
+  Sweep_Config* configs;
+  uns           num_configs = sweep_read_file(&configs);
+  uns           max_jobs    = SWEEP_JOBS ? SWEEP_JOBS : num_configs;
+  uns           num_running = 0;
+  uns           num_failed  = 0;
+
+  fprintf(mystdout, "** Sweep: forking %u configurations from %s\n",
+          num_configs, SWEEP_FILE);
+
+  for(uns config_num = 0, num_done = 0; num_done < num_configs;) {
+    if(config_num < num_configs && num_running < max_jobs) {
+      fflush(NULL); /* do not duplicate buffered output in the child */
+      pid_t pid = fork();
+      if(pid < 0)
+        FATAL_ERROR(0, "Sweep fork failed: %s\n", strerror(errno));
+      if(pid == 0) {
+        sweep_child(&configs[config_num], config_num);
+        return;
+      }
+      configs[config_num++].pid = pid;
+      num_running++;
+      continue;
+    }
+
+    int   status;
+    pid_t pid = wait(&status);
+    if(pid < 0)
+      FATAL_ERROR(0, "Sweep wait failed: %s\n", strerror(errno));
+    for(uns ii = 0; ii < config_num; ii++) {
+      if(configs[ii].pid != pid)
+        continue;
+      num_running--;
+      num_done++;
+      Flag ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+      num_failed += !ok;
+      fprintf(mystdout, "** Sweep config %u %s: %s\n", ii,
+              ok ? "finished" : "FAILED", configs[ii].line);
+      fflush(mystdout);
+    }
+  }
+
+  fprintf(mystdout, "** Sweep: %u of %u configurations failed\n", num_failed,
+          num_configs);
+  fflush(mystdout);
+  exit(num_failed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -27,7 +27,7 @@ FILE* mystdout = stdout;
 FILE* mystderr = stderr;
 FILE* mystatus = stdout;
 
-Counter  cycle_count  = 0;
+__thread Counter cycle_count = 0;
 Counter  unique_count = 0;
 Counter* op_count;
 Counter* inst_count;
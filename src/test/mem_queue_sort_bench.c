@@ -0,0 +1,208 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : test/mem_queue_sort_bench.c
+ * Author       : HPS Research Group
+ * Date         : 10/17/2026
+ * Description  : Micro-benchmark of mem_queue_sort() on the queue contents a
+ *                prefetch-heavy run produces: a deep L1 queue where most
+ *                entries are prefetches of one priority, demands are ordered
+ *                by their cycle, and the served entries are demoted to
+ *                MRT_MIN_PRIORITY before the re-sort drops them. Both sorts
+ *                see the same queue every cycle; the priorities must come out
+ *                the same and the run merge must keep equal priorities in
+ *                queue order.
+ *
+ *                usage: mem_queue_sort_bench [cycles [depth [prefs_per_cycle]]]
+ ***************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "globals/global_defs.h"
+#include "memory/mem_queue_sort.h"
+
+/**************************************************************************************/
+/* Defines */
+
+/* the default priorities of init_mem_req_type_priorities() */
+#define PRIORITY_SHIFT (sizeof(Counter) * 8 - 4)
+#define DFETCH_PRIORITY ((Counter)0 << PRIORITY_SHIFT)
+#define DPRF_PRIORITY ((Counter)10 << PRIORITY_SHIFT)
+#define MIN_PRIORITY ((Counter)15 << PRIORITY_SHIFT)
+
+#define MAX_QUEUE_SIZE 1024
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Bench_Queue_struct {
+  Mem_Queue_Entry entries[MAX_QUEUE_SIZE];
+  int             count;
+  Flag            run_sort;
+  double          sort_ns;
+  Counter         sorts;
+  Counter         sorted_entries;
+} Bench_Queue;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static unsigned long long rng_state = 88172645463325252ULL;
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static unsigned bench_rand(void);
+static double   bench_now_ns(void);
+static void     bench_sort(Bench_Queue* queue);
+static void     bench_append(Bench_Queue* queue, int reqbuf, Counter priority);
+static void     bench_serve(Bench_Queue* queue, int served);
+static int      bench_check(Bench_Queue* qsorted, Bench_Queue* merged);
+
+/**************************************************************************************/
+/* bench_rand: xorshift, so that every run sees the same queues */
+
+static unsigned bench_rand(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 7;
+  rng_state ^= rng_state << 17;
+  return (unsigned)rng_state;
+}
+
+/**************************************************************************************/
+/* bench_now_ns: */
+
+static double bench_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**************************************************************************************/
+/* bench_sort: times one re-sort of the queue */
+
+static void bench_sort(Bench_Queue* queue) {
+  double start = bench_now_ns();
+  mem_queue_sort(queue->entries, queue->count, queue->run_sort);
+  queue->sort_ns += bench_now_ns() - start;
+  queue->sorts++;
+  queue->sorted_entries += queue->count;
+}
+
+/**************************************************************************************/
+/* bench_append: a new request goes to the tail, as in mem_insert_req_into_queue() */
+
+static void bench_append(Bench_Queue* queue, int reqbuf, Counter priority) {
+  Mem_Queue_Entry* entry = &queue->entries[queue->count++];
+  entry->reqbuf          = reqbuf;
+  entry->priority        = priority;
+  entry->rdy_cycle       = 0;
+}
+
+/**************************************************************************************/
+/* bench_serve: the served entries at the head are demoted, as in
+   update_memory_queues(), and dropped after the next sort */
+
+static void bench_serve(Bench_Queue* queue, int served) {
+  for(int ii = 0; ii < served && ii < queue->count; ii++)
+    queue->entries[ii].priority = MIN_PRIORITY;
+}
+
+/**************************************************************************************/
+/* bench_check: both queues hold the same priorities in the same order, and the
+   run merge kept the entries of equal priority in the order they came in */
+
+static int bench_check(Bench_Queue* qsorted, Bench_Queue* merged) {
+  if(qsorted->count != merged->count)
+    return 0;
+  for(int ii = 0; ii < merged->count; ii++) {
+    if(qsorted->entries[ii].priority != merged->entries[ii].priority)
+      return 0;
+    if(ii > 0 &&
+       merged->entries[ii].priority == merged->entries[ii - 1].priority &&
+       merged->entries[ii].reqbuf < merged->entries[ii - 1].reqbuf)
+      return 0;
+  }
+  return 1;
+}
+
+/**************************************************************************************/
+/* main: */
+
+int main(int argc, char** argv) {
+  Counter cycles = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+  int     depth  = argc > 2 ? atoi(argv[2]) : 88;
+  int     prefs  = argc > 3 ? atoi(argv[3]) : 2;
+
+  if(depth < 1 || depth + prefs + 1 > MAX_QUEUE_SIZE || prefs < 0) {
+    fprintf(stderr, "depth plus prefs_per_cycle must be below %d\n",
+            MAX_QUEUE_SIZE);
+    return 1;
+  }
+
+  static Bench_Queue qsorted, merged;
+  qsorted.run_sort = FALSE;
+  merged.run_sort  = TRUE;
+
+  int reqbuf = 0;
+  for(Counter cycle = 1; cycle <= cycles; cycle++) {
+    /* serve one request a cycle, two once the queue is as deep as wanted */
+    int served = merged.count >= depth ? 2 : merged.count > 0;
+    bench_serve(&qsorted, served);
+    bench_serve(&merged, served);
+
+    /* a demand every fourth cycle on average, up to prefs prefetches */
+    int new_demand = bench_rand() % 4 == 0;
+    int new_prefs  = prefs ? bench_rand() % (prefs + 1) : 0;
+    if(new_demand) {
+      bench_append(&qsorted, reqbuf, DFETCH_PRIORITY + cycle);
+      bench_append(&merged, reqbuf, DFETCH_PRIORITY + cycle);
+      reqbuf++;
+    }
+    for(int ii = 0; ii < new_prefs; ii++) {
+      bench_append(&qsorted, reqbuf, DPRF_PRIORITY);
+      bench_append(&merged, reqbuf, DPRF_PRIORITY);
+      reqbuf++;
+    }
+
+    if(!served && !new_demand && !new_prefs)
+      continue;
+    bench_sort(&qsorted);
+    bench_sort(&merged);
+    qsorted.count -= served;
+    merged.count -= served;
+
+    if(!bench_check(&qsorted, &merged)) {
+      fprintf(stderr, "The sorts disagree in cycle %llu\n", cycle);
+      return 1;
+    }
+  }
+
+  printf("%llu sorts of %.1f entries on average\n", merged.sorts,
+         (double)merged.sorted_entries / merged.sorts);
+  printf("qsort:     %8.1f ns/sort\n", qsorted.sort_ns / qsorted.sorts);
+  printf("run merge: %8.1f ns/sort (%.1fx)\n", merged.sort_ns / merged.sorts,
+         qsorted.sort_ns / merged.sort_ns);
+  return 0;
+}
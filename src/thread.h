@@ -68,7 +68,7 @@ typedef struct Thread_struct {
 /**************************************************************************************/
 /* External variables */
 
-extern Thread_Data* td; /* here for now, variable declared in sim.c */
+extern __thread Thread_Data* td; /* here for now, variable declared in sim.c */
 /* if we ever go MT, this will turn into an array */
 
 
@@ -164,6 +164,18 @@ double trigger_progress(Trigger* trigger) {
          (double)trigger->period;
 }
 
+/* Is the trigger disarmed or waiting on an instruction count (cycles in which
+   no instruction retires cannot fire it) */
+Flag trigger_counts_insts(Trigger* trigger) {
+  if(!trigger->armed)
+    return TRUE;
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    if(trigger->stat == &global_stat_array[proc_id][NODE_INST_COUNT])
+      return TRUE;
+  }
+  return FALSE;
+}
+
 void trigger_free(Trigger* trigger) {
   free(trigger->name);
   free(trigger);
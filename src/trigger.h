@@ -56,6 +56,8 @@ Flag trigger_on(Trigger* trigger);
 
 double trigger_progress(Trigger* trigger);
 
+Flag trigger_counts_insts(Trigger* trigger);
+
 void trigger_free(Trigger* trigger);
 
 #endif  // __TRIGGER_H__
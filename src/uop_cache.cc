@@ -87,7 +87,7 @@ bool operator==(const Uop_Cache_Key& lhs, const Uop_Cache_Key& rhs) {
 /**************************************************************************************/
 /* Global Variables */
 
-uns8 uop_cache_proc_id;
+__thread uns8 uop_cache_proc_id;
 // per core caches
 std::vector<Uop_Cache*> per_core_uop_cache;
 
@@ -101,11 +101,11 @@ static std::vector<Uop_Cache_Data> per_core_accumulating_line;
 static std::vector<FT_Info> per_core_accumulating_ft;
 static std::vector<Counter> per_core_accumulating_op_num;
 // pointers to the structures of the current core in use
-static std::vector<Uop_Cache_Data>* current_accumulation_buffer = NULL;
-static uns* current_num_accumulated_lines = NULL;
-static Uop_Cache_Data* current_accumulating_line = NULL;
-static FT_Info* current_accumulating_ft = NULL;
-static Counter* current_accumulating_op_num = NULL;
+static __thread std::vector<Uop_Cache_Data>* current_accumulation_buffer = NULL;
+static __thread uns* current_num_accumulated_lines = NULL;
+static __thread Uop_Cache_Data* current_accumulating_line = NULL;
+static __thread FT_Info* current_accumulating_ft = NULL;
+static __thread Counter* current_accumulating_op_num = NULL;
 
 // uop cache per core lookup structures
 // the lookup buffer stores the uop cache lines of an FT
@@ -114,8 +114,8 @@ static Counter* current_accumulating_op_num = NULL;
 static std::vector<std::vector<Uop_Cache_Data>> per_core_lookup_buffer;
 static std::vector<uns> per_core_num_looked_up_lines;
 // pointers to the structures of the current core in use
-static std::vector<Uop_Cache_Data>* current_lookup_buffer = NULL;
-static uns* current_num_looked_up_lines = NULL;
+static __thread std::vector<Uop_Cache_Data>* current_lookup_buffer = NULL;
+static __thread uns* current_num_looked_up_lines = NULL;
 
 void alloc_mem_uop_cache(uns num_cores) {
   if (!UOP_CACHE_ENABLE) {
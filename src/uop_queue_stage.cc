@@ -2,6 +2,7 @@
 
 #include "uop_queue_stage.h"
 #include <deque>
+#include <vector>
 
 extern "C" {
 #include "debug/debug_macros.h"
@@ -27,19 +28,39 @@ extern "C" {
 // TODO(peterbraun): Check if the ISSUE_WIDTH can be less than the uop cache issue bandwidth
 
 // Uop Queue Variables
-std::deque<Stage_Data*> q {};
-std::deque<Stage_Data*> free_sds {};
+struct Uop_Queue_Stage {
+  std::deque<Stage_Data*> q {};
+  std::deque<Stage_Data*> free_sds {};
+
+  // For uop queue fill stat
+  Counter last_recovery_cycle {};
+  Counter last_recovery_pw {};
+  std::size_t prev_q_size {};
+  // the fill time seen this cycle, not yet added to the distributions
+  std::size_t fill_time_size {};  // 0 if none
+  Counter fill_time_cycles {};
+  Counter fill_time_pws {};
+  Counter fill_time_unique_pws {};
+  bool off_path {};
+};
 
-// For uop queue fill stat
-Counter last_recovery_cycle {};
-Counter last_recovery_pw {};
-std::size_t prev_q_size {};
-bool uopq_off_path;
+std::vector<Uop_Queue_Stage> per_core_uop_queue;
+// per_core pointer
+__thread Uop_Queue_Stage* uopq;
 
 static inline void update_uop_queue_fill_time_stat(void);
 
-void init_uop_queue_stage() {
+void alloc_mem_uop_queue_stage(uns num_cores) {
+  per_core_uop_queue.resize(num_cores);
+}
+
+void set_uop_queue_stage(uns8 proc_id) {
+  uopq = &per_core_uop_queue[proc_id];
+}
+
+void init_uop_queue_stage(uns8 proc_id) {
   char tmp_name[MAX_STR_LENGTH + 1];
+  ASSERT(proc_id, uopq == &per_core_uop_queue[proc_id]);
   for (uns ii = 0; ii < UOP_QUEUE_STAGE_LENGTH; ii++) {
     Stage_Data* sd = (Stage_Data*)calloc(1, sizeof(Stage_Data));
     snprintf(tmp_name, MAX_STR_LENGTH, "UOP QUEUE STAGE %d", ii);
@@ -47,9 +68,12 @@ void init_uop_queue_stage() {
     sd->max_op_count = STAGE_MAX_OP_COUNT;
     sd->op_count = 0;
     sd->ops = (Op**)calloc(STAGE_MAX_OP_COUNT, sizeof(Op*));
-    free_sds.push_back(sd);
+    uopq->free_sds.push_back(sd);
   }
 
+  // the fill time distributions are shared by all cores
+  if (proc_id)
+    return;
   for (int cap_measured = 0; cap_measured < UOP_QUEUE_CAPACITY_MAX_MEASURED; cap_measured++) {
     char cycle_list_label[] = "Cycles to fill uop queue to size";
     char pw_list_label[] = "PWs to fill uop queue to size";
@@ -66,33 +90,33 @@ void init_uop_queue_stage() {
 // Get ops from the uop cache.
 void update_uop_queue_stage(Stage_Data* src_sd) {
   // If the front of the queue was consumed, remove that stage.
-  if (q.size() && q.front()->op_count == 0) {
-    free_sds.push_back(q.front());
-    q.pop_front();
-    ASSERT(0, !q.size() || q.front()->op_count > 0);  // Only one stage is consumed per cycle
+  if (uopq->q.size() && uopq->q.front()->op_count == 0) {
+    uopq->free_sds.push_back(uopq->q.front());
+    uopq->q.pop_front();
+    ASSERT(0, !uopq->q.size() || uopq->q.front()->op_count > 0);  // Only one stage is consumed per cycle
   }
   update_uop_queue_fill_time_stat(); // gets updated the cycle after the size changes
 
-  if (uopq_off_path) {
+  if (uopq->off_path) {
     STAT_EVENT(dec->proc_id, UOPQ_STAGE_OFF_PATH);
   }
   // If the queue cannot accomodate more ops, stall.
-  if (q.size() >= UOP_QUEUE_STAGE_LENGTH) {
+  if (uopq->q.size() >= UOP_QUEUE_STAGE_LENGTH) {
     // Backend stalls may force fetch to stall.
-    if (!uopq_off_path) {
+    if (!uopq->off_path) {
       STAT_EVENT(dec->proc_id, UOPQ_STAGE_STALLED);
     }
     return;
   }
-  else if (!uopq_off_path) {
+  else if (!uopq->off_path) {
     STAT_EVENT(dec->proc_id, UOPQ_STAGE_NOT_STALLED);
   }
 
   // Build a new sd and place new ops into the queue.
-  Stage_Data* new_sd = free_sds.front();
+  Stage_Data* new_sd = uopq->free_sds.front();
   ASSERT(0, src_sd->op_count <= (int)STAGE_MAX_OP_COUNT);
   if (src_sd->op_count) {
-    if (!uopq_off_path) {
+    if (!uopq->off_path) {
       STAT_EVENT(dec->proc_id, UOPQ_STAGE_NOT_STARVED);
     }
     for (int i = 0; i < src_sd->max_op_count; i++) {
@@ -106,23 +130,49 @@ void update_uop_queue_stage(Stage_Data* src_sd) {
         decode_stage_process_op(src_op);
         DEBUG(0, "Fetching opnum=%llu\n", src_op->op_num);
         if (src_op->off_path)
-          uopq_off_path = true;
+          uopq->off_path = true;
       }
     }
   }
-  else if (!uopq_off_path) {
+  else if (!uopq->off_path) {
     STAT_EVENT(dec->proc_id, UOPQ_STAGE_STARVED);
   }
 
   if (new_sd->op_count > 0) {
-    free_sds.pop_front();
-    q.push_back(new_sd);
+    uopq->free_sds.pop_front();
+    uopq->q.push_back(new_sd);
+  }
+}
+
+// The queue neither takes ops nor hands any over, and its size is the one
+// update_uop_queue_fill_time_stat() last saw.
+Flag uop_queue_stage_is_idle(Stage_Data* src_sd) {
+  if (uopq->q.size() && uopq->q.front()->op_count == 0)
+    return FALSE;
+  if (uopq->q.size() > uopq->prev_q_size)
+    return FALSE;
+  return uopq->q.size() >= UOP_QUEUE_STAGE_LENGTH || !src_sd->op_count;
+}
+
+// What update_uop_queue_stage() does over the given number of cycles in which
+// uop_queue_stage_is_idle() holds.
+void uop_queue_idle_cycles(Stage_Data* src_sd, Counter cycles) {
+  if (uopq->off_path) {
+    INC_STAT_EVENT(dec->proc_id, UOPQ_STAGE_OFF_PATH, cycles);
+    return;
+  }
+  if (uopq->q.size() >= UOP_QUEUE_STAGE_LENGTH) {
+    INC_STAT_EVENT(dec->proc_id, UOPQ_STAGE_STALLED, cycles);
+  } else {
+    ASSERT(dec->proc_id, !src_sd->op_count);
+    INC_STAT_EVENT(dec->proc_id, UOPQ_STAGE_NOT_STALLED, cycles);
+    INC_STAT_EVENT(dec->proc_id, UOPQ_STAGE_STARVED, cycles);
   }
 }
 
 void recover_uop_queue_stage(void) {
-  uopq_off_path = false;
-  for (std::deque<Stage_Data*>::iterator it = q.begin(); it != q.end();) {
+  uopq->off_path = false;
+  for (std::deque<Stage_Data*>::iterator it = uopq->q.begin(); it != uopq->q.end();) {
     Stage_Data* sd = *it;
     sd->op_count = 0;
     for (uns op_idx = 0; op_idx < STAGE_MAX_OP_COUNT; op_idx++) {
@@ -137,41 +187,54 @@ void recover_uop_queue_stage(void) {
     }
 
     if (sd->op_count == 0) {  // entire stage data was off-path
-      free_sds.push_back(sd);
-      it = q.erase(it);
+      uopq->free_sds.push_back(sd);
+      it = uopq->q.erase(it);
     } else {
       ++it;
     }
   }
   // TODO(peterbraun): This ignores effect of fetch barriers.
-  last_recovery_cycle = cycle_count;
-  last_recovery_pw = pw_count;
-  prev_q_size = 0;  // This triggers the stat logging if the queue is not fully flushed
+  uopq->last_recovery_cycle = cycle_count;
+  uopq->last_recovery_pw = pw_count;
+  uopq->prev_q_size = 0;  // This triggers the stat logging if the queue is not fully flushed
 }
 
 Stage_Data* uop_queue_stage_get_latest_sd(void) {
-  if (q.size()) {
-    return q.front();
+  if (uopq->q.size()) {
+    return uopq->q.front();
   }
-  ASSERT(0, free_sds.size() == UOP_QUEUE_STAGE_LENGTH);
-  return free_sds.front();
+  ASSERT(0, uopq->free_sds.size() == UOP_QUEUE_STAGE_LENGTH);
+  return uopq->free_sds.front();
 };
 
 int get_uop_queue_stage_length(void) {
-  return q.size();
+  return uopq->q.size();
 }
 
 // This is called each cycle. If size increased, log the time.
 void update_uop_queue_fill_time_stat() {
-  if (q.size() > prev_q_size) {
-    prev_q_size = q.size();
-    if (q.size() <= UOP_QUEUE_CAPACITY_MAX_MEASURED) {
-      Counter* new_cycle_entry = static_cast<Counter*>(sl_list_add_tail(&uop_queue_fill_time.time_for_size[q.size()-1].cycles));
-      *new_cycle_entry = cycle_count - last_recovery_cycle;
-      Counter* new_pw_entry = static_cast<Counter*>(sl_list_add_tail(&uop_queue_fill_time.time_for_size[q.size()-1].pws));
-      *new_pw_entry = pw_count - last_recovery_pw;
-      Counter* new_unique_pw_entry = static_cast<Counter*>(sl_list_add_tail(&uop_queue_fill_time.time_for_size[q.size()-1].unique_pws));
-      *new_unique_pw_entry = unique_pws_since_recovery;
+  if (uopq->q.size() > uopq->prev_q_size) {
+    uopq->prev_q_size = uopq->q.size();
+    if (uopq->q.size() <= UOP_QUEUE_CAPACITY_MAX_MEASURED) {
+      uopq->fill_time_size = uopq->q.size();
+      uopq->fill_time_cycles = cycle_count - uopq->last_recovery_cycle;
+      uopq->fill_time_pws = pw_count - uopq->last_recovery_pw;
+      uopq->fill_time_unique_pws = unique_pws_since_recovery;
     }
   }
 }
+
+// The distributions are shared by all cores, so the time logged by the uop
+// queue stage is added to them separately, in core order.
+void add_uop_queue_fill_time(void) {
+  if (!uopq->fill_time_size)
+    return;
+  Uop_Queue_Fill_Time_For_Size* dists = &uop_queue_fill_time.time_for_size[uopq->fill_time_size-1];
+  Counter* new_cycle_entry = static_cast<Counter*>(sl_list_add_tail(&dists->cycles));
+  *new_cycle_entry = uopq->fill_time_cycles;
+  Counter* new_pw_entry = static_cast<Counter*>(sl_list_add_tail(&dists->pws));
+  *new_pw_entry = uopq->fill_time_pws;
+  Counter* new_unique_pw_entry = static_cast<Counter*>(sl_list_add_tail(&dists->unique_pws));
+  *new_unique_pw_entry = uopq->fill_time_unique_pws;
+  uopq->fill_time_size = 0;
+}
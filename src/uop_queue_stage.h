@@ -13,13 +13,19 @@ extern "C" {
 #include "decode_stage.h"
 #include "uop_cache.h"
 
-void init_uop_queue_stage(void);
+void alloc_mem_uop_queue_stage(uns num_cores);
+void set_uop_queue_stage(uns8 proc_id);
+void init_uop_queue_stage(uns8 proc_id);
 void update_uop_queue_stage(Stage_Data* src_sd);
+Flag uop_queue_stage_is_idle(Stage_Data* src_sd);
+void uop_queue_idle_cycles(Stage_Data* src_sd, Counter cycles);
 void recover_uop_queue_stage(void);
 Stage_Data* uop_queue_stage_get_latest_sd(void);
 // Returns length of queue in terms of number of stages
 int get_uop_queue_stage_length(void);
 void stat_event_new_pw_accessed(Uop_Cache_Data* pw);
+// Adds the fill time logged by update_uop_queue_stage() this cycle
+void add_uop_queue_fill_time(void);
 
 #ifdef __cplusplus
 }
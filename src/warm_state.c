@@ -0,0 +1,249 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : warm_state.c
+ * Author       : HPS Research Group
+ * Date         : 10/16/2026
+ * Description  : Warm state images. Everything cmp_warmup() trains (icache,
+ *                dcache, MLC, L1 (the LLC), BTB, indirect target predictor and
+ *                direction predictor), the prefetcher framework tables and
+ *                the tables of the enabled prefetchers are written out after
+ *                warmup so that later runs with the same warmup region can
+ *                restore it instead of recomputing it.
+ ***************************************************************************************/
+
+#include <string.h>
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "bp/bp.h"
+#include "cmp_model.h"
+#include "libs/cache_lib.h"
+#include "model.h"
+#include "prefetcher/pref_common.h"
+#include "statistics.h"
+#include "warm_state.h"
+
+#include "bp/bp.param.h"
+#include "core.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+#include "prefetcher/pref.param.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define WARM_STATE_MAGIC "SCRBWARM"
+#define WARM_STATE_VERSION 4
+
+/**************************************************************************************/
+/* Static prototypes */
+
+static void warm_state_check_config(void);
+static void warm_state_array(void* ptr, size_t size, FILE* file, Flag write);
+static void warm_state_header(FILE* file, Flag write);
+static void warm_state_bp(Bp_Data* bp_data, FILE* file, Flag write);
+static void warm_state_dir_pred(Bp* bp, FILE* file, Flag write);
+static void warm_state_noreset_stats(FILE* file, Flag write);
+static void warm_state_io(FILE* file, Flag write);
+
+/**************************************************************************************/
+/* warm_state_check_config: refuse configurations whose warmed state would not
+ * be fully captured by the image */
+
+static void warm_state_check_config() {
+  if(model->id != CMP_MODEL)
+    FATAL_ERROR(0, "Warm state images are only supported by the cmp model\n");
+}
+
+/**************************************************************************************/
+/* warm_state_array: */
+
+static void warm_state_array(void* ptr, size_t size, FILE* file, Flag write) {
+  size_t done = write ? fwrite(ptr, 1, size, file) : fread(ptr, 1, size, file);
+  if(done != size)
+    FATAL_ERROR(0, "Could not %s the warm state image\n",
+                write ? "write" : "read");
+}
+
+/**************************************************************************************/
+/* warm_state_header: the parameters that determine the layout of the image */
+
+static void warm_state_header(FILE* file, Flag write) {
+  char  magic[sizeof(WARM_STATE_MAGIC)];
+  uns32 config[]  = {WARM_STATE_VERSION, NUM_CORES,         BP_MECH,
+                    LATE_BP_MECH,       IBTB_MECH,         WP_COLLECT_STATS,
+                    MLC_PRESENT,        PRIVATE_L1,        PREF_FRAMEWORK_ON,
+                    PREF_SHARED_QUEUES, PREF_POLBV_ON,     PREF_HFILTER_ON};
+  uns32 read_config[sizeof(config) / sizeof(config[0])];
+  uns64 warmup    = WARMUP;
+  uns64 read_warmup;
+
+  if(write) {
+    warm_state_array(WARM_STATE_MAGIC, sizeof(magic), file, TRUE);
+    warm_state_array(config, sizeof(config), file, TRUE);
+    warm_state_array(&warmup, sizeof(warmup), file, TRUE);
+    return;
+  }
+
+  warm_state_array(magic, sizeof(magic), file, FALSE);
+  if(memcmp(magic, WARM_STATE_MAGIC, sizeof(magic)))
+    FATAL_ERROR(0, "Not a warm state image\n");
+  warm_state_array(read_config, sizeof(read_config), file, FALSE);
+  if(memcmp(read_config, config, sizeof(config)))
+    FATAL_ERROR(0, "Warm state image was saved with a different configuration "
+                   "(version, NUM_CORES, BP_MECH, LATE_BP_MECH, IBTB_MECH, "
+                   "WP_COLLECT_STATS, MLC_PRESENT, PRIVATE_L1 or the "
+                   "prefetcher framework)\n");
+  warm_state_array(&read_warmup, sizeof(read_warmup), file, FALSE);
+  if(read_warmup != warmup)
+    FATAL_ERROR(0, "Warm state image covers %llu warmup instructions, WARMUP "
+                   "is %llu\n",
+                (unsigned long long)read_warmup, (unsigned long long)warmup);
+}
+
+/**************************************************************************************/
+/* warm_state_dir_pred: */
+
+static void warm_state_dir_pred(Bp* bp, FILE* file, Flag write) {
+  if(!bp->write_state_func || !bp->read_state_func)
+    FATAL_ERROR(0, "Branch predictor %s does not support warm state images\n",
+                bp->name);
+  if(write)
+    bp->write_state_func(file);
+  else
+    bp->read_state_func(file);
+}
+
+/**************************************************************************************/
+/* warm_state_bp: per-core target predictors and histories. The direction
+ * predictors keep their own per-core tables and are handled once. */
+
+static void warm_state_bp(Bp_Data* bp_data, FILE* file, Flag write) {
+  uns num_hist_entries = 0x1 << IBTB_HIST_LENGTH;
+
+  if(write)
+    cache_write_state(&bp_data->btb, file);
+  else
+    cache_read_state(&bp_data->btb, file);
+  warm_state_array(&bp_data->global_hist, sizeof(bp_data->global_hist), file,
+                   write);
+  warm_state_array(&bp_data->targ_hist, sizeof(bp_data->targ_hist), file,
+                   write);
+
+  if(IBTB_MECH == TC_TAGGED_IBTB || IBTB_MECH == TC_HYBRID_IBTB) {
+    if(write)
+      cache_write_state(&bp_data->tc_tagged, file);
+    else
+      cache_read_state(&bp_data->tc_tagged, file);
+  }
+  if(IBTB_MECH == TC_TAGLESS_IBTB || IBTB_MECH == TC_HYBRID_IBTB)
+    warm_state_array(bp_data->tc_tagless, sizeof(Addr) * num_hist_entries,
+                     file, write);
+  if(IBTB_MECH == TC_HYBRID_IBTB)
+    warm_state_array(bp_data->tc_selector, sizeof(uns8) * num_hist_entries,
+                     file, write);
+}
+
+/**************************************************************************************/
+/* warm_state_noreset_stats: the warmup counts of the stats that are never
+ * reset (NORESET_L1_FILL and NORESET_L1_EVICT give the L1 occupancy) */
+
+static void warm_state_noreset_stats(FILE* file, Flag write) {
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    for(uns ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+      Stat* stat = &global_stat_array[proc_id][ii];
+      /* count and value share their storage */
+      if(stat->noreset)
+        warm_state_array(&stat->count, sizeof(stat->count), file, write);
+    }
+  }
+}
+
+/**************************************************************************************/
+/* warm_state_io: the image body, in a fixed order */
+
+static void warm_state_io(FILE* file, Flag write) {
+  void (*cache_io)(Cache*, FILE*) = write ? cache_write_state :
+                                            cache_read_state;
+
+  warm_state_header(file, write);
+
+  for(uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Icache_Stage* ic = &cmp_model.icache_stage[proc_id];
+    cache_io(&ic->icache, file);
+    if(WP_COLLECT_STATS)
+      cache_io(&ic->icache_line_info, file);
+    cache_io(&cmp_model.dcache_stage[proc_id].dcache, file);
+    warm_state_bp(&cmp_model.bp_data[proc_id], file, write);
+  }
+
+  warm_state_dir_pred(cmp_model.bp_data[0].bp, file, write);
+  if(cmp_model.bp_data[0].late_bp)
+    warm_state_dir_pred(cmp_model.bp_data[0].late_bp, file, write);
+
+  /* the MLC is shared by all cores, the L1 unless PRIVATE_L1 */
+  if(MLC_PRESENT)
+    cache_io(&cmp_model.memory.uncores[0].mlc->cache, file);
+  for(uns proc_id = 0; proc_id < (PRIVATE_L1 ? NUM_CORES : 1); proc_id++)
+    cache_io(&cmp_model.memory.uncores[proc_id].l1->cache, file);
+
+  if(PREF_FRAMEWORK_ON) {
+    if(write)
+      pref_write_state(file);
+    else
+      pref_read_state(file);
+  }
+  warm_state_noreset_stats(file, write);
+}
+
+/**************************************************************************************/
+/* warm_state_save: */
+
+void warm_state_save(const char* filename) {
+  warm_state_check_config();
+  FILE* file = fopen(filename, "wb");
+  if(!file)
+    FATAL_ERROR(0, "Could not open warm state image '%s' for writing\n",
+                filename);
+  warm_state_io(file, TRUE);
+  fclose(file);
+  fprintf(mystdout, "** Warm state saved to %s\n", filename);
+}
+
+/**************************************************************************************/
+/* warm_state_load: */
+
+void warm_state_load(const char* filename) {
+  warm_state_check_config();
+  FILE* file = fopen(filename, "rb");
+  if(!file)
+    FATAL_ERROR(0, "Could not open warm state image '%s'\n", filename);
+  warm_state_io(file, FALSE);
+  if(fgetc(file) != EOF)
+    FATAL_ERROR(0, "Warm state image '%s' has trailing data\n", filename);
+  fclose(file);
+  fprintf(mystdout, "** Warm state loaded from %s\n", filename);
+}